@@ -2,67 +2,117 @@
 #include <string>
 #include <algorithm>
 #include <cctype>
+#include <sstream>
 
 #include "../battle/BattleContext2.h"
 #include "../battle/GameContext2.h"
 #include "../battle/agents/SimpleAgent2.h"
 #include "../battle/agents/AutoClad.h"
+#include "../battle/BattleBatch.h"
+#include "../include/sim/MacroBenchmark.h"
 #include "../include/utils/scenarios.h"
 #include "../include/constants/MonsterEncounters.h"
 
 using namespace sts;
 
-enum class Agent {
-  simple,
-  autoclad,
-};
-
-std::string getAgentName(Agent a) {
-    switch (a) {
-        case Agent::simple:
-            return "SimpleAgent";
-        case Agent::autoclad:
-            return "AutoClad";
-        default:
-            return "Unknown";
-    }
-}
-
-std::vector<GameContext> filterScenarios(const std::vector<GameContext>& allScenarios, const std::vector<std::string>& filters) {
-    // If no filters specified or "all" is specified, return all scenarios
+bool matchesScenarioFilters(MonsterEncounter encounter, const std::vector<std::string>& filters) {
+    // If no filters specified or "all" is specified, every scenario matches
     if (filters.empty() || (filters.size() == 1 && filters[0] == "all")) {
-        return allScenarios;
+        return true;
     }
 
-    std::vector<GameContext> filteredScenarios;
-    for (const auto& gc : allScenarios) {
-        // Get the encounter name for comparison
-        std::string encounterName = monsterEncounterStrings[static_cast<int>(gc.info.encounter)];
+    // Get the encounter name for comparison
+    std::string encounterName = monsterEncounterStrings[static_cast<int>(encounter)];
 
-        // Convert encounter name to lowercase for case-insensitive matching
-        std::string lowerEncounterName = encounterName;
-        std::transform(lowerEncounterName.begin(), lowerEncounterName.end(), lowerEncounterName.begin(), ::tolower);
+    // Convert encounter name to lowercase for case-insensitive matching
+    std::string lowerEncounterName = encounterName;
+    std::transform(lowerEncounterName.begin(), lowerEncounterName.end(), lowerEncounterName.begin(), ::tolower);
 
-        // Check if this scenario matches any of the filters
-        for (const auto& filter : filters) {
-            std::string lowerFilter = filter;
-            std::transform(lowerFilter.begin(), lowerFilter.end(), lowerFilter.begin(), ::tolower);
+    // Check if this scenario matches any of the filters
+    for (const auto& filter : filters) {
+        std::string lowerFilter = filter;
+        std::transform(lowerFilter.begin(), lowerFilter.end(), lowerFilter.begin(), ::tolower);
 
-            // Match by encounter name (with spaces replaced by underscores for command line friendliness)
-            std::string underscoreEncounterName = lowerEncounterName;
-            std::replace(underscoreEncounterName.begin(), underscoreEncounterName.end(), ' ', '_');
+        // Match by encounter name (with spaces replaced by underscores for command line friendliness)
+        std::string underscoreEncounterName = lowerEncounterName;
+        std::replace(underscoreEncounterName.begin(), underscoreEncounterName.end(), ' ', '_');
 
-            if (lowerFilter == underscoreEncounterName || lowerFilter == lowerEncounterName) {
-                filteredScenarios.push_back(gc);
-                break; // Don't add the same scenario multiple times
-            }
+        if (lowerFilter == underscoreEncounterName || lowerFilter == lowerEncounterName) {
+            return true;
         }
     }
+    return false;
+}
 
+std::vector<GameContext> filterScenarios(const std::vector<GameContext>& allScenarios, const std::vector<std::string>& filters) {
+    std::vector<GameContext> filteredScenarios;
+    for (const auto& gc : allScenarios) {
+        if (matchesScenarioFilters(gc.info.encounter, filters)) {
+            filteredScenarios.push_back(gc);
+        }
+    }
     return filteredScenarios;
 }
 
-void runAgentOnScenario(Agent a, const GameContext& gc, bool printDetails = false, bool generateSnapshot = false, const std::string& snapshotDir = "") {
+// Parses a comma separated agent list like "simple,autoclad"
+std::vector<BattleAgent> parseAgents(const std::string& agentList) {
+    std::vector<BattleAgent> agents;
+    std::stringstream ss(agentList);
+    std::string name;
+    while (std::getline(ss, name, ',')) {
+        if (name == "simple") {
+            agents.push_back(BattleAgent::SIMPLE);
+        } else if (name == "autoclad") {
+            agents.push_back(BattleAgent::AUTOCLAD);
+        } else {
+            std::cerr << "Unknown agent: " << name << std::endl;
+        }
+    }
+    return agents;
+}
+
+// Plays every scenario for every seed and agent, and prints the win rate and hp loss distribution of each
+void runBatch(const std::vector<std::string>& scenarioFilters, BattleBatch& batch) {
+    for (auto& scenario : sts::utils::loadScenarioJsonFromDirectory("battle/scenarios/")) {
+        const auto gc = sts::utils::createGameContextFromScenario(scenario, 0);
+        if (matchesScenarioFilters(gc.info.encounter, scenarioFilters)) {
+            batch.scenarios.push_back(std::move(scenario));
+        }
+    }
+
+    std::cout << "Batch: " << batch.scenarios.size() << " scenarios x "
+              << batch.seedCount << " seeds (from " << batch.seedStart << ") x "
+              << batch.agents.size() << " agents on " << batch.threadCount << " threads" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    batch.run();
+    batch.printResults(std::cout);
+}
+
+// every scenario with SimpleAgent over a fixed seed range, as a throughput workload that can be checked against a baseline
+int runMacro(BattleBatch& batch, const std::string& baselinePath, double threshold, bool writeBaseline) {
+    batch.scenarios = sts::utils::loadScenarioJsonFromDirectory("battle/scenarios/");
+    batch.agents = {BattleAgent::SIMPLE};
+    resetPeakRss();
+    batch.run();
+
+    MacroBenchmarkSuite suite;
+    suite.threshold = threshold;
+    suite.add({"battle_agent_scenarios", batch.threadCount, batch.battleCount(), 0, batch.elapsed, getPeakRssKb()});
+    suite.printResults(std::cout);
+
+    if (baselinePath.empty()) {
+        return 0;
+    }
+    if (writeBaseline) {
+        suite.writeBaseline(baselinePath);
+        std::cout << "wrote baseline " << baselinePath << std::endl;
+        return 0;
+    }
+    return suite.checkBaseline(baselinePath, std::cout) ? 0 : 1;
+}
+
+void runAgentOnScenario(BattleAgent a, const GameContext& gc, bool printDetails = false, bool generateSnapshot = false, const std::string& snapshotDir = "") {
     std::cout << "Running agent on scenario " << static_cast<int>(gc.info.encounter) << " with seed: " << gc.seed << std::endl;
 
     // Initialize battle context with the scenario's encounter
@@ -75,7 +125,7 @@ void runAgentOnScenario(Agent a, const GameContext& gc, bool printDetails = fals
     sts::search::AutoClad autoclad;
     sts::search::SimpleAgent simple_agent;
 
-    search::SimpleAgent& agent = (a==Agent::simple ? simple_agent : autoclad);
+    search::SimpleAgent& agent = (a==BattleAgent::SIMPLE ? simple_agent : autoclad);
 
     // Create and configure the agent
     // sts::search::SimpleAgent agent;
@@ -83,7 +133,7 @@ void runAgentOnScenario(Agent a, const GameContext& gc, bool printDetails = fals
     agent.print = printDetails;
 
     if (printDetails) {
-        std::cout << "  AGENT: " << getAgentName(a) << std::endl;
+        std::cout << "  AGENT: " << getBattleAgentName(a) << std::endl;
         std::cout << "  Initial State:" << std::endl;
         std::cout << "    Encounter: " << static_cast<int>(gc.info.encounter) << std::endl;
         std::cout << "    Player HP: " << initialBc.player.curHp << "/" << initialBc.player.maxHp << std::endl;
@@ -113,7 +163,7 @@ void runAgentOnScenario(Agent a, const GameContext& gc, bool printDetails = fals
 
     // Generate snapshot if requested
     if (generateSnapshot && !snapshotDir.empty()) {
-        std::string agentName = getAgentName(a);
+        std::string agentName = getBattleAgentName(a);
         std::string encounterName = monsterEncounterStrings[static_cast<int>(gc.info.encounter)];
         std::string scenarioName = agentName + "_vs_" + encounterName + "_" + std::to_string(gc.seed);
         std::string snapshot = utils::formatBattleSnapshot(gc, initialBc, finalBc, scenarioName, agentName);
@@ -132,6 +182,13 @@ int main(int argc, char* argv[]) {
     bool generateSnapshots = false;
     std::string snapshotDir = "data/agent_battles";
     std::vector<std::string> scenarioFilters;
+    bool batchMode = false;
+    BattleBatch batch;
+    bool macroMode = false;
+    std::string baselinePath;
+    double threshold = 0.1;
+    bool writeBaseline = false;
+    bool seedCountSet = false;
 
     // Parse command line arguments
     for (int i = 1; i < argc; ++i) {
@@ -146,9 +203,40 @@ int main(int argc, char* argv[]) {
         } else if (arg.length() > 11 && arg.substr(0, 11) == "--scenario=") {
             std::string scenarioValue = arg.substr(11); // Remove "--scenario="
             scenarioFilters.push_back(scenarioValue);
+        } else if (arg == "--batch") {
+            batchMode = true;
+        } else if (arg.rfind("--seed-start=", 0) == 0) {
+            batch.seedStart = std::stoull(arg.substr(13));
+        } else if (arg.rfind("--seed-count=", 0) == 0) {
+            batch.seedCount = std::stoull(arg.substr(13));
+            seedCountSet = true;
+        } else if (arg.rfind("--agents=", 0) == 0) {
+            batch.agents = parseAgents(arg.substr(9));
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            batch.threadCount = std::stoi(arg.substr(10));
+        } else if (arg == "--macro") {
+            macroMode = true;
+        } else if (arg.rfind("--baseline=", 0) == 0) {
+            baselinePath = arg.substr(11);
+        } else if (arg.rfind("--threshold=", 0) == 0) {
+            threshold = std::stod(arg.substr(12));
+        } else if (arg == "--write_baseline") {
+            writeBaseline = true;
         }
     }
 
+    if (macroMode) {
+        if (!seedCountSet) {
+            batch.seedCount = 1000;
+        }
+        return runMacro(batch, baselinePath, threshold, writeBaseline);
+    }
+
+    if (batchMode) {
+        runBatch(scenarioFilters, batch);
+        return 0;
+    }
+
     // Load all scenarios from the scenarios directory
     std::vector<GameContext> allScenarios = sts::utils::loadScenariosFromDirectory("battle/scenarios/");
 
@@ -174,7 +262,7 @@ int main(int argc, char* argv[]) {
 
     // Run SimpleAgent on each scenario
     for (const auto& gc : scenarios) {
-        runAgentOnScenario(Agent::simple, gc, true, generateSnapshots, snapshotDir);
+        runAgentOnScenario(BattleAgent::SIMPLE, gc, true, generateSnapshots, snapshotDir);
     }
 
     std::cout << "All scenarios completed!" << std::endl;
@@ -0,0 +1,329 @@
+#include "combat/BattleContext.h"
+#include "game/GameContext.h"
+#include "game/Map.h"
+#include "sim/BatchRunner.h"
+#include "sim/Benchmark.h"
+#include "sim/MacroBenchmark.h"
+#include "sim/search/Action.h"
+#include "sim/search/GameAction.h"
+#include "sim/search/ScumSearchAgent2.h"
+#include "sim/search/SimpleAgent.h"
+
+#include <string>
+
+using namespace sts;
+
+// the first usable card of the hand on the first monster, end turn if there is none
+static search::Action getFirstCardPlay(const BattleContext &bc) {
+    if (bc.isCardPlayAllowed()) {
+        for (int handIdx = 0; handIdx < bc.cards.cardsInHand; ++handIdx) {
+            const auto &c = bc.cards.hand[handIdx];
+            if (c.canUse(bc, 0, false)) {
+                return c.requiresTarget() ?
+                    search::Action(search::ActionType::CARD, handIdx, 0) : search::Action(search::ActionType::CARD, handIdx);
+            }
+        }
+    }
+    return search::Action(search::ActionType::END_TURN);
+}
+
+// plays cards until none are usable, then ends the turn. executeActions runs after every action
+static void playTurn(BattleContext &bc) {
+    while (bc.outcome == Outcome::UNDECIDED && bc.inputState == InputState::PLAYER_NORMAL) {
+        const auto action = getFirstCardPlay(bc);
+        action.execute(bc);
+        if (action.getActionType() == search::ActionType::END_TURN) {
+            break;
+        }
+    }
+}
+
+static void addBenchmarks(BenchmarkRunner &runner) {
+    const auto seed = runner.seed;
+    const GameContext gc(CharacterClass::IRONCLAD, seed, 0);
+
+    BattleContext turnStart; // the start of the first turn, the opening hand is drawn
+    turnStart.init(gc, MonsterEncounter::JAW_WORM);
+
+    // the hand and draw pile moved to the discard pile, for the draw and shuffle benchmarks
+    BattleContext emptyHand(turnStart);
+    while (emptyHand.cards.cardsInHand > 0) {
+        const auto c = emptyHand.cards.hand[emptyHand.cards.cardsInHand-1];
+        emptyHand.cards.removeFromHandAtIdx(emptyHand.cards.cardsInHand-1);
+        emptyHand.cards.moveToDiscardPile(c);
+    }
+    BattleContext emptyDrawPile(emptyHand);
+    while (!emptyDrawPile.cards.drawPile.empty()) {
+        emptyDrawPile.cards.moveToDiscardPile(emptyDrawPile.cards.popFromDrawPile());
+    }
+
+    // the benchmarks that change the state start each iteration from a copy, BattleContext/clone_into is that cost
+    runner.add("BattleContext/copy", [=](std::int64_t iterations) {
+        BattleContext copy;
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            copy = turnStart;
+            doNotOptimize(copy);
+        }
+    });
+
+    runner.add("BattleContext/clone_into", [=](std::int64_t iterations) {
+        BattleContext copy;
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            turnStart.clone_into(copy);
+            doNotOptimize(copy);
+        }
+    });
+
+    // init expects a fresh BattleContext, so the construction is part of it
+    runner.add("BattleContext/init", [=](std::int64_t iterations) {
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            BattleContext bc;
+            bc.init(gc, MonsterEncounter::JAW_WORM);
+            doNotOptimize(bc);
+        }
+    });
+
+    runner.add("BattleContext/executeActions_turn", [=](std::int64_t iterations) {
+        BattleContext bc;
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            turnStart.clone_into(bc);
+            playTurn(bc);
+            doNotOptimize(bc);
+        }
+    });
+
+    runner.add("Action/execute_card", [=](std::int64_t iterations) {
+        const auto action = getFirstCardPlay(turnStart);
+        BattleContext bc;
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            turnStart.clone_into(bc);
+            action.execute(bc);
+            doNotOptimize(bc);
+        }
+    });
+
+    runner.add("Action/execute_end_turn", [=](std::int64_t iterations) {
+        const search::Action action(search::ActionType::END_TURN);
+        BattleContext bc;
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            turnStart.clone_into(bc);
+            action.execute(bc);
+            doNotOptimize(bc);
+        }
+    });
+
+    runner.add("CardManager/draw_5", [=](std::int64_t iterations) {
+        BattleContext bc;
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            emptyHand.clone_into(bc);
+            bc.cards.draw(bc, 5);
+            doNotOptimize(bc);
+        }
+    });
+
+    runner.add("CardManager/shuffle_discard", [=](std::int64_t iterations) {
+        BattleContext bc;
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            emptyDrawPile.clone_into(bc);
+            Actions::EmptyDeckShuffle().execute(bc);
+            doNotOptimize(bc);
+        }
+    });
+
+    runner.add("Monster/rollMove", [=](std::int64_t iterations) {
+        BattleContext bc;
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            turnStart.clone_into(bc);
+            bc.monsters.arr[0].rollMove(bc);
+            doNotOptimize(bc);
+        }
+    });
+
+    // seeds change every iteration so nothing is reused between them
+    runner.add("GameContext/construct", [=](std::int64_t iterations) {
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            GameContext g(CharacterClass::IRONCLAD, seed+i, 0);
+            doNotOptimize(g);
+        }
+    });
+
+    // a game level lookahead copies the game for every action it tries
+    runner.add("GameContext/clone_into", [=](std::int64_t iterations) {
+        GameContext copy;
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            gc.clone_into(copy);
+            doNotOptimize(copy);
+        }
+    });
+
+    runner.add("GameContext/copy", [=](std::int64_t iterations) {
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            GameContext copy(gc);
+            doNotOptimize(copy);
+        }
+    });
+
+    // rollouts list the actions of every out of combat screen they pass
+    runner.add("GameAction/getAllActionsInState", [=](std::int64_t iterations) {
+        search::GameActionList actions;
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            search::GameAction::getAllActionsInState(gc, actions);
+            doNotOptimize(actions);
+        }
+    });
+
+    runner.add("GameAction/getAllActionsInState_vector", [=](std::int64_t iterations) {
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            auto actions = search::GameAction::getAllActionsInState(gc);
+            doNotOptimize(actions);
+        }
+    });
+
+    runner.add("Map/fromSeed", [=](std::int64_t iterations) {
+        for (std::int64_t i = 0; i < iterations; ++i) {
+            auto map = Map::fromSeed(seed+i);
+            doNotOptimize(map);
+        }
+    });
+}
+
+struct MacroOptions {
+    std::uint64_t seed = 1;
+    int threadCount = 1;
+    std::int64_t gameCount = 20000; // SimpleAgent games, ScumSearchAgent2 plays far fewer
+    int searchDepth = 100; // simulationCountBase of ScumSearchAgent2
+    bool readme = false; // also run the playout speed quoted in the readme
+    std::string baselinePath;
+    double threshold = 0.1;
+    bool writeBaseline = false;
+};
+
+static MacroBenchmarkResult runSimpleAgentGames(const std::string &name, std::uint64_t seed, std::int64_t gameCount, int threadCount) {
+    resetPeakRss();
+    BatchRunner runner(threadCount);
+    const auto &info = runner.run(seed, gameCount, [](std::uint64_t seed, BatchResult &threadResult) {
+        GameContext gc(CharacterClass::IRONCLAD, seed, 0);
+        search::SimpleAgent agent;
+        agent.playout(gc);
+        threadResult.floorSum += gc.floorNum;
+    });
+    return {name, threadCount, info.gameCount, 0, runner.elapsed, getPeakRssKb()};
+}
+
+static MacroBenchmarkResult runScumSearchAgentGames(std::uint64_t seed, std::int64_t gameCount, int depth, int threadCount) {
+    resetPeakRss();
+    BatchRunner runner(threadCount);
+    runner.seedBlockSize = 1;
+    const auto &info = runner.run(seed, gameCount, [=](std::uint64_t seed, BatchResult &threadResult) {
+        GameContext gc(CharacterClass::IRONCLAD, seed, 0);
+        search::ScumSearchAgent2 agent;
+        agent.simulationCountBase = depth;
+        agent.rng = std::default_random_engine(gc.seed);
+        agent.playout(gc);
+        threadResult.simulationCount += agent.simulationCountTotal;
+    });
+    return {"scum_search_agent_games", threadCount, info.gameCount, info.simulationCount, runner.elapsed, getPeakRssKb()};
+}
+
+// end to end workloads on a fixed seed range, compared against a baseline file if one is given
+static int runMacro(const MacroOptions &o) {
+    MacroBenchmarkSuite suite;
+    suite.threshold = o.threshold;
+
+    suite.add(runSimpleAgentGames("simple_agent_games", o.seed, o.gameCount, o.threadCount));
+    suite.add(runScumSearchAgentGames(o.seed, std::max<std::int64_t>(1, o.gameCount / 1000), o.searchDepth, o.threadCount));
+    if (o.readme) {
+        // the readme quotes SimpleAgent games per second per thread, each thread plays as many games as one does alone
+        suite.add(runSimpleAgentGames("readme_playouts", o.seed, o.gameCount * o.threadCount, o.threadCount));
+    }
+    suite.printResults(std::cout);
+
+    if (o.baselinePath.empty()) {
+        return 0;
+    }
+    if (o.writeBaseline) {
+        suite.writeBaseline(o.baselinePath);
+        std::cout << "wrote baseline " << o.baselinePath << std::endl;
+        return 0;
+    }
+    return suite.checkBaseline(o.baselinePath, std::cout) ? 0 : 1;
+}
+
+static void printUsage() {
+    std::cout << "usage: bench [--filter=<substring>] [--seed=<n>] [--pin=<core>] [--min_time=<seconds>]"
+                 " [--repetitions=<n>] [--json] [--list]\n"
+                 "       bench --macro [--seed=<n>] [--threads=<n>] [--games=<n>] [--depth=<n>] [--readme]"
+                 " [--baseline=<file> [--threshold=<fraction>] [--write_baseline]]\n";
+}
+
+int main(int argc, const char* argv[]) {
+    BenchmarkRunner runner;
+    bool json = false;
+    bool list = false;
+    bool macro = false;
+    MacroOptions macroOptions;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        const auto eq = arg.find('=');
+        const auto key = arg.substr(0, eq);
+        const auto value = eq == std::string::npos ? std::string() : arg.substr(eq+1);
+
+        if (key == "--filter") {
+            runner.filter = value;
+        } else if (key == "--seed") {
+            runner.seed = std::stoull(value);
+            macroOptions.seed = runner.seed;
+        } else if (key == "--pin") {
+            runner.pinCore = std::stoi(value);
+        } else if (key == "--min_time") {
+            runner.minTime = std::stod(value);
+        } else if (key == "--repetitions") {
+            runner.repetitions = std::stoi(value);
+        } else if (key == "--json") {
+            json = true;
+        } else if (key == "--list") {
+            list = true;
+        } else if (key == "--macro") {
+            macro = true;
+        } else if (key == "--threads") {
+            macroOptions.threadCount = std::stoi(value);
+        } else if (key == "--games") {
+            macroOptions.gameCount = std::stoll(value);
+        } else if (key == "--depth") {
+            macroOptions.searchDepth = std::stoi(value);
+        } else if (key == "--readme") {
+            macroOptions.readme = true;
+        } else if (key == "--baseline") {
+            macroOptions.baselinePath = value;
+        } else if (key == "--threshold") {
+            macroOptions.threshold = std::stod(value);
+        } else if (key == "--write_baseline") {
+            macroOptions.writeBaseline = true;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (macro) {
+        return runMacro(macroOptions);
+    }
+
+    addBenchmarks(runner);
+
+    if (list) {
+        for (const auto &b : runner.benchmarks) {
+            std::cout << b.first << '\n';
+        }
+        return 0;
+    }
+
+    runner.run();
+    if (json) {
+        runner.printJson(std::cout);
+    } else {
+        runner.printResults(std::cout);
+    }
+    return 0;
+}
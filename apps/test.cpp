@@ -2,25 +2,35 @@
 // Created by gamerpuppy on 7/8/2021.
 //
 
+#include <algorithm>
 #include <iostream>
 #include <chrono>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <thread>
 #include <memory>
-#include <mutex>
+
+#include <nlohmann/json.hpp>
 
 #include "data_structure/fixed_list.h"
 #include "constants/Cards.h"
 #include "constants/Events.h"
 #include "constants/CardPools.h"
+#include "constants/MonsterEncounters.h"
+#include "constants/Relics.h"
 #include "game/Game.h"
 #include "game/Map.h"
 #include "game/Neow.h"
 #include "game/SaveFile.h"
 #include "combat/BattleContext.h"
+#include "combat/BattleSerialization.h"
+#include "sim/BatchRunner.h"
 #include "sim/ConsoleSimulator.h"
 #include "sim/PrintHelpers.h"
 #include "sim/RandomAgent.h"
+#include "sim/SeedScanner.h"
+#include "sim/search/GameScumSearcher.h"
 #include "sim/search/ScumSearchAgent2.h"
 #include "sim/search/SimpleAgent.h"
 
@@ -35,7 +45,7 @@ void printSizes() {
     std::cout << "sizeof MonsterGroup : " << sizeof(MonsterGroup) << '\n';
     std::cout << "sizeof CardInstance: " << sizeof(CardInstance) << '\n';
     std::cout << "sizeof CardManager : " << sizeof(CardManager) << '\n';
-    std::cout << "sizeof ActionFunction : " << sizeof(ActionFunction) << '\n';
+    std::cout << "sizeof Action : " << sizeof(Action) << '\n';
     std::cout << "sizeof ActionQueue<40> : " << sizeof(ActionQueue<40>) << '\n';
     std::cout << "sizeof BattleContext: " << sizeof(BattleContext) << '\n';
 
@@ -117,38 +127,26 @@ void replayActionFile(const GameContext &startState, const std::string &fname) {
     }
 }
 
-struct AgentMtInfo {
-    std::mutex m;
-
-    std::uint64_t curSeed;
-    std::uint64_t seedStart;
-    std::uint64_t seedEnd;
-
-    std::int64_t winCount = 0;
-    std::int64_t lossCount = 0;
-    std::int64_t floorSum = 0;
-    std::int64_t totalSimulations = 0;
-};
-
 static int g_searchAscension = 0;
 static int g_simulationCount = 5;
 static int g_print_level = 0;
+static bool g_reuseSearchTree = true;
+static bool g_earlyTermination = false;
+static std::int64_t g_searchTimeBudgetUs = 0;
+static std::int64_t g_gameSimulationCount = 0;
 
-void agentMtRunner(AgentMtInfo *info) {
-    std::uint64_t seed;
-    {
-        std::scoped_lock lock(info->m);
-        seed = info->curSeed++;
-    }
-
-    while(true) {
-        if (seed >= info->seedEnd) {
-            break;
-        }
+void agentMt(int threadCount, std::uint64_t startSeed, int playoutCount, bool pinThreads) {
+    BatchRunner runner(threadCount, pinThreads);
+    runner.seedBlockSize = 1; // a game takes long enough that balancing the threads matters more than the counter
 
+    const auto &info = runner.run(startSeed, playoutCount, [](std::uint64_t seed, BatchResult &threadResult) {
         GameContext gc(CharacterClass::IRONCLAD, seed, g_searchAscension);
         search::ScumSearchAgent2 agent;
         agent.simulationCountBase = g_simulationCount;
+        agent.reuseSearchTree = g_reuseSearchTree;
+        agent.earlyTermination = g_earlyTermination;
+        agent.searchTimeBudget = std::chrono::microseconds(g_searchTimeBudgetUs);
+        agent.gameSimulationCount = g_gameSimulationCount;
         agent.rng = std::default_random_engine(gc.seed);
 
         agent.printActions = g_print_level & 0x1;
@@ -158,61 +156,28 @@ void agentMtRunner(AgentMtInfo *info) {
 
         printOutcome(std::cout, gc);
 
-        {
-            std::scoped_lock lock(info->m);
-            info->floorSum += gc.floorNum;
-            if (gc.outcome == sts::GameOutcome::PLAYER_VICTORY) {
-                ++info->winCount;
-            } else {
-                ++info->lossCount;
-            }
-            info->totalSimulations += agent.simulationCountTotal;
-
-            seed = info->curSeed++;
-        }
-    }
-}
-
-void agentMt(int threadCount, std::uint64_t startSeed, int playoutCount) {
-    auto startTime = std::chrono::high_resolution_clock::now();
-    std::vector<std::unique_ptr<std::thread>> threads;
-
-    AgentMtInfo info;
-    info.curSeed = startSeed;
-    info.seedStart = startSeed;
-    info.seedEnd = startSeed + playoutCount;
-
-
-    if (threadCount == 1) { // doing this for more consistency when benchmarking
-        agentMtRunner(&info);
-
-    } else {
-        for (int tid = 0; tid < threadCount; ++tid) {
-            threads.emplace_back(new std::thread(agentMtRunner, &info));
-        }
-    }
-
-    for (int tid = 0; tid < threadCount; ++tid) {
-        if (threadCount > 1) {
-            threads[tid]->join();
+        threadResult.floorSum += gc.floorNum;
+        if (gc.outcome == sts::GameOutcome::PLAYER_VICTORY) {
+            ++threadResult.winCount;
+        } else {
+            ++threadResult.lossCount;
         }
-    }
-
-    auto endTime = std::chrono::high_resolution_clock::now();
-    double duration = std::chrono::duration<double>(endTime-startTime).count();
+        threadResult.simulationCount += agent.simulationCountTotal;
+    });
 
     std::cout << "w/l: (" << info.winCount  << ", " << info.lossCount << ")"
         << " percentWin: " << static_cast<double>(info.winCount) / playoutCount * 100 << "%"
         << " avgFloorReached: " << static_cast<double>(info.floorSum) / playoutCount << '\n'
-        << " totalSimulations: " << info.totalSimulations
-        << " avgPerFloor: " << (double)info.totalSimulations/info.floorSum << '\n';
+        << " totalSimulations: " << info.simulationCount
+        << " avgPerFloor: " << (double)info.simulationCount/info.floorSum << '\n';
 
     std::cout << "threads: " << threadCount
               << " playoutCount: " << playoutCount
               << " depth: " << g_simulationCount
         << " asc: " << g_searchAscension
-        << " elapsed: " << duration
-        << std::endl;
+        << " elapsed: " << runner.elapsed << ' ';
+    runner.printThroughput(std::cout);
+    std::cout << std::endl;
 }
 
 int mcts(int argc, const char *argv[]) {
@@ -255,6 +220,726 @@ int mcts(int argc, const char *argv[]) {
     return 0;
 }
 
+void benchSearch(std::uint64_t seed, std::int64_t simulationCount, bool progressiveWidening) {
+    static constexpr MonsterEncounter encounters[] {
+        MonsterEncounter::JAW_WORM,
+        MonsterEncounter::GREMLIN_NOB,
+        MonsterEncounter::LAGAVULIN,
+        MonsterEncounter::SLIME_BOSS,
+        MonsterEncounter::HEXAGHOST,
+    };
+    constexpr std::int64_t copyCount = 1000000;
+
+    GameContext gc(CharacterClass::IRONCLAD, seed, 0);
+    for (auto encounter : encounters) {
+        BattleContext bc;
+        bc.init(gc, encounter);
+
+        BattleContext copy;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (std::int64_t i = 0; i < copyCount; ++i) {
+            copy = bc;
+            BattleContext::sum += copy.turn;
+        }
+        auto endTime = std::chrono::high_resolution_clock::now();
+        const double copyDuration = std::chrono::duration<double>(endTime-startTime).count();
+
+        auto searcher = std::make_unique<search::BattleScumSearcher2>(bc);
+        searcher->progressiveWidening = progressiveWidening;
+        searcher->statsLog = &std::cout;
+        startTime = std::chrono::high_resolution_clock::now();
+        searcher->search(simulationCount);
+        endTime = std::chrono::high_resolution_clock::now();
+        const double searchDuration = std::chrono::duration<double>(endTime-startTime).count();
+        const double bestValue = searcher->bestActionValue;
+        const auto treeEdgeCount = searcher->tree.size();
+
+        startTime = std::chrono::high_resolution_clock::now();
+        searcher.reset();
+        endTime = std::chrono::high_resolution_clock::now();
+        const double teardownDuration = std::chrono::duration<double>(endTime-startTime).count();
+
+        std::cout << encounter
+            << " sizeof BattleContext: " << sizeof(BattleContext)
+            << " copies/s: " << static_cast<std::int64_t>(copyCount / copyDuration)
+            << " simulations/s: " << static_cast<std::int64_t>(simulationCount / searchDuration)
+            << " tree edges: " << treeEdgeCount
+            << " tree teardown ms: " << teardownDuration * 1000
+            << " best value: " << bestValue
+            << '\n';
+    }
+    std::cout.flush();
+}
+
+void benchSearchParallel(std::uint64_t seed, std::int64_t simulationCount, int maxThreads, search::SearchParallelism parallelism, bool progressiveWidening) {
+    GameContext gc(CharacterClass::IRONCLAD, seed, 0);
+    BattleContext bc;
+    bc.init(gc, MonsterEncounter::HEXAGHOST);
+
+    double singleThreadRate = 0;
+    for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+        search::BattleScumSearcher2 searcher(bc);
+        searcher.progressiveWidening = progressiveWidening;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        searcher.search(simulationCount, threadCount, parallelism);
+        auto endTime = std::chrono::high_resolution_clock::now();
+        const double rate = simulationCount / std::chrono::duration<double>(endTime-startTime).count();
+        if (threadCount == 1) {
+            singleThreadRate = rate;
+        }
+
+        std::cout << "threads: " << threadCount
+            << " simulations/s: " << static_cast<std::int64_t>(rate)
+            << " speedup: " << rate / singleThreadRate
+            << " root visits: " << searcher.getRootSimulationCount()
+            << " best value: " << searcher.bestActionValue
+            << '\n';
+    }
+    std::cout.flush();
+}
+
+// how many simulations fit in a time budget, and how far past the deadline the search returns
+void benchAnytimeSearch(std::uint64_t seed, double budgetMs, int maxThreads, search::SearchParallelism parallelism) {
+    static constexpr MonsterEncounter encounters[] {
+        MonsterEncounter::JAW_WORM,
+        MonsterEncounter::GREMLIN_NOB,
+        MonsterEncounter::LAGAVULIN,
+        MonsterEncounter::SLIME_BOSS,
+        MonsterEncounter::HEXAGHOST,
+    };
+    const auto budget = std::chrono::microseconds(static_cast<std::int64_t>(budgetMs * 1000));
+
+    GameContext gc(CharacterClass::IRONCLAD, seed, 0);
+    for (auto encounter : encounters) {
+        BattleContext bc;
+        bc.init(gc, encounter);
+
+        for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+            search::BattleScumSearcher2 searcher(bc);
+            const auto result = searcher.searchFor(budget, threadCount, parallelism);
+
+            std::cout << encounter
+                << " threads: " << threadCount
+                << " simulations: " << result.simulationCount
+                << " elapsed ms: " << result.elapsed * 1000
+                << " overrun ms: " << result.elapsed * 1000 - budgetMs
+                << " best value: " << result.bestActionValue
+                << " confidence: " << result.confidence
+                << '\n';
+        }
+    }
+    std::cout.flush();
+}
+
+void benchTranspositions(std::uint64_t seed, std::int64_t simulationCount, int tableSizeLog2) {
+    static constexpr MonsterEncounter encounters[] {
+        MonsterEncounter::JAW_WORM,
+        MonsterEncounter::GREMLIN_NOB,
+        MonsterEncounter::LAGAVULIN,
+        MonsterEncounter::SLIME_BOSS,
+        MonsterEncounter::HEXAGHOST,
+    };
+
+    GameContext gc(CharacterClass::IRONCLAD, seed, 0);
+    for (auto encounter : encounters) {
+        BattleContext bc;
+        bc.init(gc, encounter);
+
+        for (bool useTable : {false, true}) {
+            search::BattleScumSearcher2 searcher(bc);
+            if (useTable) {
+                searcher.transpositionTable = std::make_shared<search::TranspositionTable>(tableSizeLog2);
+            }
+
+            auto startTime = std::chrono::high_resolution_clock::now();
+            searcher.search(simulationCount);
+            auto endTime = std::chrono::high_resolution_clock::now();
+            const double searchDuration = std::chrono::duration<double>(endTime-startTime).count();
+
+            // nodes that were given a table entry another node already had
+            std::int64_t nodesWithEntry = 0;
+            std::vector<std::uint32_t> entries;
+            for (const auto &edge : searcher.tree) {
+                if (edge.node.transpositionIdx != search::TranspositionTable::INVALID_IDX) {
+                    ++nodesWithEntry;
+                    entries.push_back(edge.node.transpositionIdx);
+                }
+            }
+            std::sort(entries.begin(), entries.end());
+            const auto distinctEntries = std::unique(entries.begin(), entries.end()) - entries.begin();
+
+            std::cout << encounter
+                << " table: " << useTable
+                << " simulations/s: " << static_cast<std::int64_t>(simulationCount / searchDuration)
+                << " transposed nodes: " << nodesWithEntry - distinctEntries << "/" << nodesWithEntry
+                << " best value: " << searcher.bestActionValue
+                << '\n';
+        }
+    }
+    std::cout.flush();
+}
+
+static search::Action getMostSimulatedAction(const search::BattleScumSearcher2 &searcher) {
+    const auto &root = searcher.root();
+    auto bestIdx = root.edgeBegin;
+    for (auto i = root.edgeBegin; i < root.edgeBegin + root.edgeCount; ++i) {
+        if (searcher.stats.simulationCount[i] > searcher.stats.simulationCount[bestIdx]) {
+            bestIdx = i;
+        }
+    }
+    return searcher.tree[bestIdx].action;
+}
+
+// a jaw worm at 8 hp with 2 energy and only Bash and Defends in hand, so the one win this turn is to Bash first.
+// every other line wins later at lower hp, which is what lets pruning cut their playouts
+static void initLethalBashBattle(BattleContext &bc, const GameContext &gc) {
+    bc.init(gc, MonsterEncounter::JAW_WORM);
+    const auto isKept = [](const CardInstance &c) {
+        return c.getId() == CardId::BASH || c.getId() == CardId::DEFEND_RED;
+    };
+    for (int i = bc.cards.cardsInHand-1; i >= 0; --i) {
+        const auto c = bc.cards.hand[i];
+        if (!isKept(c)) {
+            bc.cards.removeFromHandAtIdx(i);
+            bc.cards.moveToDiscardPile(c);
+        }
+    }
+    for (int i = bc.cards.drawPile.size()-1; i >= 0; --i) {
+        const auto c = bc.cards.drawPile[i];
+        if (isKept(c)) {
+            bc.cards.removeFromDrawPileAtIdx(i);
+            bc.cards.moveToHand(c);
+        }
+    }
+    bc.player.energy = 2;
+    bc.monsters.arr[0].curHp = 8;
+}
+
+// checks that playout pruning leaves the chosen action unchanged: the start of the best win, and the most simulated
+// root edge, which the agent follows when there is no win
+void checkPruning(std::uint64_t seed, std::int64_t simulationCount) {
+    GameContext gc(CharacterClass::IRONCLAD, seed, 0);
+    BattleContext bc;
+    initLethalBashBattle(bc, gc);
+
+    search::BattleScumSearcher2 full(bc);
+    full.search(simulationCount);
+    search::BattleScumSearcher2 pruned(bc);
+    pruned.prunePlayouts = true;
+    pruned.search(simulationCount);
+
+    const auto printAction = [&](const char *label, search::Action a) {
+        std::cout << label;
+        a.printDesc(std::cout, bc);
+    };
+    printAction("best win: ", full.bestActionSequence.front());
+    printAction(" pruned: ", pruned.bestActionSequence.front());
+    printAction("\nmost simulated: ", getMostSimulatedAction(full));
+    printAction(" pruned: ", getMostSimulatedAction(pruned));
+    std::cout << "\nbest value: " << full.bestActionValue << " pruned: " << pruned.bestActionValue << '\n';
+
+    const bool unchanged = full.bestActionSequence.front() == pruned.bestActionSequence.front()
+            && getMostSimulatedAction(full) == getMostSimulatedAction(pruned);
+    std::cout << (unchanged ? "pruning check passed" : "pruning check FAILED") << std::endl;
+}
+
+template <typename T, std::size_t N>
+static int getEnumIdxFromName(const T (&names)[N], const std::string &name) {
+    for (int i = 0; i < N; ++i) {
+        if (name == names[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// the battle of a scenario file from battle/scenarios. potions aren't loaded, like the battle app
+static bool initScenarioBattle(BattleContext &bc, const nlohmann::json &scenario, std::uint64_t seed) {
+    const auto &initialState = scenario["initial_state"];
+    GameContext gc(CharacterClass::IRONCLAD, seed, scenario["ascension"].get<int>());
+    gc.floorNum = scenario["floor"].get<int>();
+    gc.curHp = initialState["player_hp"].get<int>();
+    gc.maxHp = initialState["player_max_hp"].get<int>();
+
+    const auto encounterIdx = getEnumIdxFromName(monsterEncounterEnumNames, initialState["encounter"].get<std::string>());
+    if (encounterIdx < 0) {
+        return false;
+    }
+    gc.info.encounter = static_cast<MonsterEncounter>(encounterIdx);
+
+    gc.deck.cards.clear();
+    for (const auto &cardJson : initialState["deck"]) {
+        auto cardName = cardJson.get<std::string>();
+        const bool upgraded = !cardName.empty() && cardName.back() == '+';
+        if (upgraded) {
+            cardName.pop_back();
+        }
+        if (cardName == "STRIKE" || cardName == "DEFEND") {
+            cardName += "_RED";
+        }
+
+        const auto cardIdx = getEnumIdxFromName(cardEnumStrings, cardName);
+        if (cardIdx > 0) {
+            Card card(static_cast<CardId>(cardIdx));
+            if (upgraded) {
+                card.upgrade();
+            }
+            gc.deck.obtainRaw(card);
+        }
+    }
+
+    if (initialState.contains("relics")) {
+        for (const auto &relicJson : initialState["relics"]) {
+            const auto relicIdx = getEnumIdxFromName(relicEnumNames, relicJson.get<std::string>());
+            if (relicIdx >= 0 && static_cast<RelicId>(relicIdx) != RelicId::INVALID) {
+                gc.relics.add({static_cast<RelicId>(relicIdx), 0});
+            }
+        }
+    }
+
+    bc.init(gc, gc.info.encounter);
+    return true;
+}
+
+// simulations until the search first finds a winning line, and until it finds the best line it finds at all,
+// for each rollout policy on each scenario. -1 when the search never wins
+void benchRolloutPolicies(const std::string &scenarioDir, std::int64_t simulationCount, double epsilon, std::uint64_t seed) {
+    struct PolicyConfig {
+        search::RolloutPolicy policy;
+        double epsilon;
+    };
+    std::vector<PolicyConfig> configs {
+        {search::RolloutPolicy::RANDOM, 0},
+        {search::RolloutPolicy::EXPERT, 0},
+        {search::RolloutPolicy::SIMPLE_AGENT, 0},
+    };
+    if (epsilon > 0) {
+        configs.push_back({search::RolloutPolicy::EXPERT, epsilon});
+        configs.push_back({search::RolloutPolicy::SIMPLE_AGENT, epsilon});
+    }
+
+    std::vector<std::filesystem::path> paths;
+    for (const auto &entry : std::filesystem::directory_iterator(scenarioDir)) {
+        if (entry.path().extension() == ".json") {
+            paths.push_back(entry.path());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    struct PolicyTotals {
+        int solvedCount = 0;
+        std::int64_t simulationsToWinSum = 0;
+        double duration = 0;
+    };
+    std::vector<PolicyTotals> totals(configs.size());
+
+    for (const auto &path : paths) {
+        std::ifstream file(path);
+        const auto scenario = nlohmann::json::parse(file);
+
+        BattleContext bc;
+        if (!initScenarioBattle(bc, scenario, seed)) {
+            std::cout << path.stem().string() << " unknown encounter\n";
+            continue;
+        }
+
+        for (int i = 0; i < configs.size(); ++i) {
+            search::BattleScumSearcher2 searcher(bc);
+            searcher.rolloutPolicy = configs[i].policy;
+            searcher.rolloutEpsilon = configs[i].epsilon;
+
+            std::int64_t simulationsToWin = -1;
+            std::int64_t simulationsToBest = 0;
+            double lastBestValue = searcher.bestActionValue;
+
+            const auto startTime = std::chrono::high_resolution_clock::now();
+            for (std::int64_t sim = 1; sim <= simulationCount; ++sim) {
+                searcher.search(1);
+                if (searcher.bestActionValue != lastBestValue) {
+                    lastBestValue = searcher.bestActionValue;
+                    simulationsToBest = sim;
+                }
+                if (simulationsToWin < 0 && searcher.outcomePlayerHp > 0) {
+                    simulationsToWin = sim;
+                }
+            }
+            const auto endTime = std::chrono::high_resolution_clock::now();
+            const double duration = std::chrono::duration<double>(endTime-startTime).count();
+
+            totals[i].duration += duration;
+            if (simulationsToWin >= 0) {
+                ++totals[i].solvedCount;
+                totals[i].simulationsToWinSum += simulationsToWin;
+            }
+
+            std::cout << path.stem().string()
+                << " policy: " << search::getRolloutPolicyName(configs[i].policy)
+                << " epsilon: " << configs[i].epsilon
+                << " simulations to win: " << simulationsToWin
+                << " simulations to best: " << simulationsToBest
+                << " best value: " << searcher.bestActionValue
+                << " outcome hp: " << searcher.outcomePlayerHp
+                << " simulations/s: " << static_cast<std::int64_t>(simulationCount / duration)
+                << '\n';
+        }
+    }
+
+    for (int i = 0; i < configs.size(); ++i) {
+        const auto &t = totals[i];
+        std::cout << "policy: " << search::getRolloutPolicyName(configs[i].policy)
+            << " epsilon: " << configs[i].epsilon
+            << " solved: " << t.solvedCount << "/" << paths.size()
+            << " mean simulations to win: " << (t.solvedCount ? t.simulationsToWinSum / t.solvedCount : -1)
+            << " simulations/s: " << static_cast<std::int64_t>(simulationCount * paths.size() / t.duration)
+            << '\n';
+    }
+    std::cout.flush();
+}
+
+template <typename T>
+static void doNotOptimize(T &t) {
+    asm volatile("" : : "r"(&t) : "memory");
+}
+
+void benchPlayerStatus(std::int64_t iterations) {
+    Player p;
+    p.buff<PS::METALLICIZE>(3);
+    p.buff<PS::RITUAL>(1);
+    p.buff<PS::DEMON_FORM>(2);
+    p.buff<PS::FEEL_NO_PAIN>(3);
+    p.debuff<PS::VULNERABLE>(2);
+    p.debuff<PS::WEAK>(1);
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (std::int64_t i = 0; i < iterations; ++i) {
+        Player copy(p);
+        doNotOptimize(copy);
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    const double copyDuration = std::chrono::duration<double>(endTime-startTime).count();
+
+    startTime = std::chrono::high_resolution_clock::now();
+    for (std::int64_t i = 0; i < iterations; ++i) {
+        doNotOptimize(p);
+        BattleContext::sum += p.getStatus<PS::METALLICIZE>()
+                + p.getStatus<PS::RITUAL>()
+                + p.getStatus<PS::DEMON_FORM>()
+                + p.getStatus<PS::FEEL_NO_PAIN>()
+                + p.getStatus<PS::VULNERABLE>()
+                + p.getStatus<PS::WEAK>();
+    }
+    endTime = std::chrono::high_resolution_clock::now();
+    const double queryDuration = std::chrono::duration<double>(endTime-startTime).count();
+
+    std::cout << "sizeof Player: " << sizeof(Player)
+        << " ns/copy: " << copyDuration * 1e9 / iterations
+        << " ns/6 status queries: " << queryDuration * 1e9 / iterations
+        << '\n';
+    std::cout.flush();
+}
+
+// a uniformly random valid action, a target index is tried with every card so some cards are more likely
+static search::Action getRandomBattleAction(const BattleContext &bc, std::default_random_engine &rng) {
+    std::vector<search::Action> actions;
+    if (bc.inputState == InputState::PLAYER_NORMAL) {
+        for (int handIdx = 0; handIdx < bc.cards.cardsInHand; ++handIdx) {
+            for (int targetIdx = 0; targetIdx < bc.monsters.monsterCount; ++targetIdx) {
+                const search::Action a(search::ActionType::CARD, handIdx, targetIdx);
+                if (a.isValidAction(bc)) {
+                    actions.push_back(a);
+                }
+            }
+        }
+        actions.emplace_back(search::ActionType::END_TURN);
+    } else {
+        actions = search::Action::enumerateCardSelectActions(bc);
+    }
+    return actions[std::uniform_int_distribution<std::size_t>(0, actions.size()-1)(rng)];
+}
+
+static void playRandomBattle(BattleContext &bc, std::default_random_engine &rng, int actionLimit) {
+    for (int i = 0; i < actionLimit && bc.outcome == Outcome::UNDECIDED; ++i) {
+        getRandomBattleAction(bc, rng).execute(bc);
+    }
+}
+
+// checks that states from random battles survive an encode and decode, then times both
+void benchSerialize(std::uint64_t seed, int battleCount) {
+    static constexpr MonsterEncounter encounters[] {
+        MonsterEncounter::JAW_WORM,
+        MonsterEncounter::GREMLIN_NOB,
+        MonsterEncounter::LAGAVULIN,
+        MonsterEncounter::SLIME_BOSS,
+        MonsterEncounter::HEXAGHOST,
+    };
+
+    std::vector<BattleContext> states;
+    for (int i = 0; i < battleCount; ++i) {
+        GameContext gc(CharacterClass::IRONCLAD, seed+i, 0);
+        std::default_random_engine rng(seed+i);
+        BattleContext bc;
+        bc.init(gc, encounters[i % std::size(encounters)]);
+        while (bc.outcome == Outcome::UNDECIDED) {
+            states.push_back(bc);
+            playRandomBattle(bc, rng, 1);
+        }
+    }
+
+    int mismatchCount = 0;
+    std::int64_t encodedSizeSum = 0;
+    std::vector<std::uint8_t> bytes;
+    for (std::size_t i = 0; i < states.size(); ++i) {
+        const auto &bc = states[i];
+        bytes.clear();
+        encodeBattleContext(bc, bytes);
+        encodedSizeSum += static_cast<std::int64_t>(bytes.size());
+
+        BattleContext decoded;
+        const auto *header = getBattleStateHeader(bytes.data(), bytes.size());
+        bool ok = header != nullptr && header->playerCurHp == bc.player.curHp && header->turn == bc.turn
+                && decodeBattleContext(bytes.data(), bytes.size(), decoded)
+                && encodeBattleContext(decoded) == bytes;
+
+        // the same choices from the original and the decoded state end the same way. the bytes can't be compared,
+        // padding inside the actions queued from here on is whatever was on the stack
+        BattleContext original(bc);
+        std::default_random_engine rngA(i);
+        std::default_random_engine rngB(i);
+        playRandomBattle(original, rngA, 1000);
+        playRandomBattle(decoded, rngB, 1000);
+        ok = ok && original.outcome == decoded.outcome && original.player.curHp == decoded.player.curHp
+                && original.turn == decoded.turn && original.cards.cardsInHand == decoded.cards.cardsInHand
+                && original.monsters.monstersAlive == decoded.monsters.monstersAlive;
+
+        if (!ok) {
+            ++mismatchCount;
+        }
+    }
+
+    // a payload with a size past its capacity is refused and the state decoded into is left as it was
+    void (*const corruptions[])(BattleContext &) {
+        [](BattleContext &bc) { bc.cards.drawPile.resize(CardManager::MAX_GROUP_SIZE+1); },
+        [](BattleContext &bc) { bc.cards.cardsInHand = CardManager::MAX_HAND_SIZE+1; },
+        [](BattleContext &bc) { bc.monsters.monsterCount = 6; },
+        [](BattleContext &bc) { bc.potionCount = bc.potionCapacity+1; },
+        [](BattleContext &bc) { bc.actionQueue.back = bc.actionQueue.getCapacity()+1; },
+        [](BattleContext &bc) { bc.cardQueue.size = CardQueue::capacity+1; },
+    };
+    int acceptedCorruptions = 0;
+    for (auto corrupt : corruptions) {
+        BattleContext bad(states.front());
+        corrupt(bad);
+        const auto badBytes = encodeBattleContext(bad);
+        BattleContext target(states.back());
+        if (decodeBattleContext(badBytes.data(), badBytes.size(), target)
+            || target.turn != states.back().turn || target.player.curHp != states.back().player.curHp) {
+            ++acceptedCorruptions;
+        }
+    }
+
+    std::vector<std::vector<std::uint8_t>> encoded(states.size());
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (std::size_t i = 0; i < states.size(); ++i) {
+        encodeBattleContext(states[i], encoded[i]);
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    const double encodeDuration = std::chrono::duration<double>(endTime-startTime).count();
+
+    BattleContext decoded;
+    startTime = std::chrono::high_resolution_clock::now();
+    for (const auto &e : encoded) {
+        decodeBattleContext(e.data(), e.size(), decoded);
+        BattleContext::sum += decoded.turn;
+    }
+    endTime = std::chrono::high_resolution_clock::now();
+    const double decodeDuration = std::chrono::duration<double>(endTime-startTime).count();
+
+    std::cout << "states: " << states.size()
+        << " mismatches: " << mismatchCount
+        << " acceptedCorruptions: " << acceptedCorruptions
+        << " sizeof BattleContext: " << sizeof(BattleContext)
+        << " mean encoded bytes: " << static_cast<double>(encodedSizeSum) / states.size()
+        << " ns/encode: " << encodeDuration * 1e9 / states.size()
+        << " ns/decode: " << decodeDuration * 1e9 / states.size()
+        << '\n';
+    std::cout.flush();
+}
+
+// checks Random(seed, counter) and setCounter against calling the generator counter times, then times them
+void benchRandomCounter(std::uint64_t seed, int seedCount) {
+    static constexpr int counters[] {0, 1, 31, 32, 100, 250, 500, 750, 1000, 5000};
+
+    int mismatchCount = 0;
+    for (int i = 0; i < seedCount; ++i) {
+        for (auto counter : counters) {
+            Random stepped(seed+i);
+            for (int j = 0; j < counter; ++j) {
+                stepped.random(999);
+            }
+            const Random constructed(seed+i, counter);
+
+            Random booleans(seed+i, 7);
+            for (int j = 7; j < counter; ++j) {
+                booleans.randomBoolean();
+            }
+            Random jumped(seed+i, 7);
+            jumped.setCounter(counter);
+
+            mismatchCount += stepped.seed0 != constructed.seed0 || stepped.seed1 != constructed.seed1
+                    || stepped.counter != constructed.counter;
+            mismatchCount += booleans.seed0 != jumped.seed0 || booleans.seed1 != jumped.seed1
+                    || booleans.counter != jumped.counter;
+        }
+    }
+
+    const auto time = [=](auto f) {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < seedCount; ++i) {
+            BattleContext::sum += f(seed+i);
+        }
+        const auto endTime = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(endTime-startTime).count() * 1e9 / seedCount;
+    };
+
+    std::cout << "mismatches: " << mismatchCount;
+    for (auto counter : {250, 750}) {
+        std::cout << " counter " << counter << " ns/step random(999): " << time([=](std::uint64_t s) {
+                Random r(s);
+                for (int j = 0; j < counter; ++j) {
+                    r.random(999);
+                }
+                return static_cast<int>(r.seed0);
+            })
+            << " ns/construct: " << time([=](std::uint64_t s) { return static_cast<int>(Random(s, counter).seed0); })
+            << " ns/setCounter: " << time([=](std::uint64_t s) {
+                Random r(s);
+                r.setCounter(counter);
+                return static_cast<int>(r.seed0);
+            });
+    }
+    std::cout << '\n';
+    std::cout.flush();
+}
+
+static SeedPredicate getSeedPredicate(const std::string &name) {
+    if (name == "guardian") {
+        return [](SeedView &v) { return v.getBoss() == MonsterEncounter::THE_GUARDIAN; };
+    } else if (name == "neow_rare_relic") {
+        return [](SeedView &v) {
+            const auto &options = v.getNeowOptions();
+            return std::any_of(options.begin(), options.end(), [](auto o) { return o.r == Neow::Bonus::ONE_RARE_RELIC; });
+        };
+    } else if (name == "lagavulin_first") {
+        return [](SeedView &v) { return v.getEliteList()[0] == MonsterEncounter::LAGAVULIN; };
+    } else if (name == "guardian_full") { // the same as guardian by constructing a GameContext, for comparison
+        return [](SeedView &v) { return v.getGameContext().boss == MonsterEncounter::THE_GUARDIAN; };
+    }
+    return nullptr;
+}
+
+// prints each matching seed then the throughput
+void scanSeeds(std::uint64_t startSeed, std::int64_t seedCount, int threadCount, const std::string &predicateName, std::int64_t maxMatchCount) {
+    const auto predicate = getSeedPredicate(predicateName);
+    if (!predicate) {
+        std::cout << "unknown predicate: " << predicateName << std::endl;
+        return;
+    }
+
+    SeedScanner scanner;
+    scanner.threadCount = threadCount;
+    scanner.maxMatchCount = maxMatchCount;
+    const auto result = scanner.scan(startSeed, seedCount, predicate, [](std::uint64_t seed) {
+        std::cout << seed << ' ' << SeedHelper::getString(seed) << '\n';
+    });
+
+    std::cout << "seeds: " << result.seedCount
+        << " matches: " << result.matchCount
+        << " elapsed: " << result.elapsed
+        << " seeds/s: " << result.seedsPerSecond()
+        << '\n';
+    std::cout.flush();
+}
+
+// checks every part of SeedView against a constructed GameContext, with the views reused across seeds
+void checkSeedView(std::uint64_t startSeed, std::int64_t seedCount, int ascension) {
+    static constexpr CharacterClass classes[] {CharacterClass::IRONCLAD, CharacterClass::SILENT, CharacterClass::DEFECT, CharacterClass::WATCHER};
+
+    SeedView view;
+    int mismatchCount = 0;
+    for (std::int64_t i = 0; i < seedCount; ++i) {
+        const auto seed = startSeed + i;
+        const auto cc = classes[i % std::size(classes)];
+        const GameContext gc(cc, seed, ascension);
+        view.reset(cc, seed, ascension);
+
+        bool ok = view.getBoss() == gc.boss
+                && std::equal(view.getMonsterList().begin(), view.getMonsterList().end(), gc.monsterList.begin(), gc.monsterList.end())
+                && std::equal(view.getEliteList().begin(), view.getEliteList().end(), gc.eliteMonsterList.begin(), gc.eliteMonsterList.end())
+                && std::equal(view.getCommonRelicPool().begin(), view.getCommonRelicPool().end(), gc.commonRelicPool.begin(), gc.commonRelicPool.end())
+                && std::equal(view.getUncommonRelicPool().begin(), view.getUncommonRelicPool().end(), gc.uncommonRelicPool.begin(), gc.uncommonRelicPool.end())
+                && std::equal(view.getRareRelicPool().begin(), view.getRareRelicPool().end(), gc.rareRelicPool.begin(), gc.rareRelicPool.end())
+                && std::equal(view.getShopRelicPool().begin(), view.getShopRelicPool().end(), gc.shopRelicPool.begin(), gc.shopRelicPool.end())
+                && std::equal(view.getBossRelicPool().begin(), view.getBossRelicPool().end(), gc.bossRelicPool.begin(), gc.bossRelicPool.end());
+        for (int j = 0; j < 4; ++j) {
+            ok = ok && view.getNeowOptions()[j].r == gc.info.neowRewards[j].r && view.getNeowOptions()[j].d == gc.info.neowRewards[j].d;
+        }
+        for (int y = 0; y < 15; ++y) {
+            for (int x = 0; x < 7; ++x) {
+                ok = ok && view.getMap().getNode(x, y).room == gc.map->getNode(x, y).room
+                        && view.getMap().getNode(x, y).edgeCount == gc.map->getNode(x, y).edgeCount;
+            }
+        }
+        mismatchCount += !ok;
+    }
+    std::cout << "seeds: " << seedCount << " mismatches: " << mismatchCount << std::endl;
+}
+
+// plays SimpleAgent from a new game to the first decision of the kind given (neow, card or boss), then searches it
+void benchGameSearch(std::uint64_t seed, std::int64_t simulations, int threadCount, const std::string &decision) {
+    GameContext gc(CharacterClass::IRONCLAD, seed, 0);
+    search::SimpleAgent agent;
+    agent.curGameContext = &gc;
+
+    const auto isDecision = [&]() {
+        const auto &r = gc.info.rewardsContainer;
+        if (decision == "card") {
+            return gc.screenState == ScreenState::REWARDS && r.cardRewardCount > 0
+                && r.relicCount == 0 && r.cardRewardCount == r.getTotalCount();
+        }
+        if (decision == "boss") {
+            return gc.screenState == ScreenState::BOSS_RELIC_REWARDS;
+        }
+        return gc.screenState == ScreenState::EVENT_SCREEN && gc.curEvent == Event::NEOW;
+    };
+
+    while (gc.outcome == GameOutcome::UNDECIDED && !isDecision()) {
+        if (gc.screenState == ScreenState::BATTLE) {
+            BattleContext bc;
+            bc.init(gc);
+            agent.playoutBattle(bc);
+            bc.exitBattle(gc);
+        } else {
+            agent.stepOutOfCombat(gc);
+        }
+    }
+    if (gc.outcome != GameOutcome::UNDECIDED) {
+        std::cout << "the game ended before a " << decision << " decision\n";
+        return;
+    }
+
+    search::GameScumSearcher searcher(gc);
+    searcher.rng = std::default_random_engine(seed);
+    searcher.search(simulations, threadCount);
+    searcher.printRootEdges(std::cout);
+
+    std::cout << "floor: " << gc.floorNum << " horizonAct: " << searcher.horizonAct
+              << " best: " << std::hex << searcher.getBestAction().bits << std::dec << '\n';
+    std::cout << "simulations: " << searcher.simulationCount
+              << " battles: " << searcher.battleCount
+              << " elapsed: " << searcher.elapsed
+              << " simulations/s: " << searcher.simulationCount / searcher.elapsed << '\n';
+}
+
 int main(int argc, const char* argv[]) {
 
     if (argc < 2) {
@@ -283,8 +968,13 @@ int main(int argc, const char* argv[]) {
         g_print_level = printLevel;
         g_searchAscension = ascensionIn;
         g_simulationCount = depthArg;
+        g_reuseSearchTree = argc <= 8 || std::stoi(argv[8]) != 0;
+        const bool pinThreads = argc > 9 && std::stoi(argv[9]) != 0;
+        g_earlyTermination = argc > 10 && std::stoi(argv[10]) != 0;
+        g_searchTimeBudgetUs = argc > 11 ? std::stoll(argv[11]) : 0;
+        g_gameSimulationCount = argc > 12 ? std::stoll(argv[12]) : 0;
 
-        agentMt(threadCount, startSeedLong, playoutCount);
+        agentMt(threadCount, startSeedLong, playoutCount, pinThreads);
 
     } if (command == "simple_agent_mt") { // actually doing tree search now
         const int threadCount(std::stoi(argv[2]));
@@ -295,8 +985,9 @@ int main(int argc, const char* argv[]) {
         if (argc > 5) {
             print = true;
         }
+        const bool pinThreads = argc > 6 && std::stoi(argv[6]) != 0;
 
-        search::SimpleAgent::runAgentsMt(threadCount, startSeedLong, playoutCount, print);
+        search::SimpleAgent::runAgentsMt(threadCount, startSeedLong, playoutCount, print, pinThreads);
 
     } else if (command == "json") {
         const std::string saveFilePath(argv[2]);
@@ -322,6 +1013,82 @@ int main(int argc, const char* argv[]) {
 
     } else if (command == "mcts_save") {
         return mcts(argc, argv);
+
+    } else if (command == "bench_search") {
+        const std::uint64_t seed(std::stoull(argv[2]));
+        const std::int64_t simulationCount(std::stoll(argv[3]));
+        const bool progressiveWidening = argc > 4 && std::stoi(argv[4]) != 0;
+        benchSearch(seed, simulationCount, progressiveWidening);
+
+    } else if (command == "check_pruning") {
+        const std::uint64_t seed(std::stoull(argv[2]));
+        const std::int64_t simulationCount(std::stoll(argv[3]));
+        checkPruning(seed, simulationCount);
+
+    } else if (command == "bench_transpositions") {
+        const std::uint64_t seed(std::stoull(argv[2]));
+        const std::int64_t simulationCount(std::stoll(argv[3]));
+        const int tableSizeLog2(argc > 4 ? std::stoi(argv[4]) : 20);
+        benchTranspositions(seed, simulationCount, tableSizeLog2);
+
+    } else if (command == "bench_search_mt") {
+        const std::uint64_t seed(std::stoull(argv[2]));
+        const std::int64_t simulationCount(std::stoll(argv[3]));
+        const int maxThreads(std::stoi(argv[4]));
+        const auto parallelism = argc > 5 && std::string(argv[5]) == "tree" ?
+                search::SearchParallelism::TREE : search::SearchParallelism::ROOT;
+        const bool progressiveWidening = argc > 6 && std::stoi(argv[6]) != 0;
+        benchSearchParallel(seed, simulationCount, maxThreads, parallelism, progressiveWidening);
+
+    } else if (command == "bench_anytime") {
+        const std::uint64_t seed(std::stoull(argv[2]));
+        const double budgetMs(std::stod(argv[3]));
+        const int maxThreads(argc > 4 ? std::stoi(argv[4]) : 1);
+        const auto parallelism = argc > 5 && std::string(argv[5]) == "tree" ?
+                search::SearchParallelism::TREE : search::SearchParallelism::ROOT;
+        benchAnytimeSearch(seed, budgetMs, maxThreads, parallelism);
+
+    } else if (command == "bench_rollout") {
+        const std::string scenarioDir(argv[2]);
+        const std::int64_t simulationCount(std::stoll(argv[3]));
+        const double epsilon(argc > 4 ? std::stod(argv[4]) : 0);
+        const std::uint64_t seed(argc > 5 ? std::stoull(argv[5]) : 0);
+        benchRolloutPolicies(scenarioDir, simulationCount, epsilon, seed);
+
+    } else if (command == "bench_player") {
+        const std::int64_t iterations(std::stoll(argv[2]));
+        benchPlayerStatus(iterations);
+
+    } else if (command == "bench_serialize") {
+        const std::uint64_t seed(std::stoull(argv[2]));
+        const int battleCount(std::stoi(argv[3]));
+        benchSerialize(seed, battleCount);
+
+    } else if (command == "bench_rng") {
+        const std::uint64_t seed(std::stoull(argv[2]));
+        const int seedCount(std::stoi(argv[3]));
+        benchRandomCounter(seed, seedCount);
+
+    } else if (command == "scan_seeds") {
+        const std::uint64_t startSeed(std::stoull(argv[2]));
+        const std::int64_t seedCount(std::stoll(argv[3]));
+        const int threadCount(std::stoi(argv[4]));
+        const std::string predicateName(argv[5]);
+        const std::int64_t maxMatchCount(argc > 6 ? std::stoll(argv[6]) : 0);
+        scanSeeds(startSeed, seedCount, threadCount, predicateName, maxMatchCount);
+
+    } else if (command == "check_seed_view") {
+        const std::uint64_t startSeed(std::stoull(argv[2]));
+        const std::int64_t seedCount(std::stoll(argv[3]));
+        const int ascension(argc > 4 ? std::stoi(argv[4]) : 0);
+        checkSeedView(startSeed, seedCount, ascension);
+
+    } else if (command == "bench_game_search") {
+        const std::uint64_t seed(std::stoull(argv[2]));
+        const std::int64_t simulations(std::stoll(argv[3]));
+        const int threadCount(std::stoi(argv[4]));
+        const std::string decision(argc > 5 ? argv[5] : "neow");
+        benchGameSearch(seed, simulations, threadCount, decision);
     }
 
     //    printSizes();
@@ -0,0 +1,129 @@
+#include "BattleBatch.h"
+
+#include <algorithm>
+
+#include "BattleContext2.h"
+#include "GameContext2.h"
+#include "agents/AutoClad.h"
+#include "agents/SimpleAgent2.h"
+#include "sim/BatchRunner.h"
+#include "utils/scenarios.h"
+
+using namespace sts;
+
+const char *sts::getBattleAgentName(BattleAgent a) {
+    switch (a) {
+        case BattleAgent::SIMPLE:
+            return "SimpleAgent";
+        case BattleAgent::AUTOCLAD:
+            return "AutoClad";
+        default:
+            return "Unknown";
+    }
+}
+
+double BattleBatchResult::winRate() const {
+    return hpLoss.empty() ? 0 : static_cast<double>(winCount) / battleCount();
+}
+
+double BattleBatchResult::meanHpLoss() const {
+    if (hpLoss.empty()) {
+        return 0;
+    }
+    std::int64_t sum = 0;
+    for (auto x : hpLoss) {
+        sum += x;
+    }
+    return static_cast<double>(sum) / battleCount();
+}
+
+int BattleBatchResult::hpLossPercentile(int percent) const {
+    if (hpLoss.empty()) {
+        return 0;
+    }
+    auto sorted = hpLoss;
+    const auto idx = std::min(sorted.size()-1, sorted.size() * percent / 100);
+    std::nth_element(sorted.begin(), sorted.begin() + idx, sorted.end());
+    return sorted[idx];
+}
+
+struct BattleOutcome {
+    bool won;
+    int hpLoss;
+    int turns;
+};
+
+static BattleOutcome playBattle(const nlohmann::json &scenario, BattleAgent agentType, std::uint64_t seed) {
+    const GameContext gc = utils::createGameContextFromScenario(scenario, seed);
+
+    BattleContext bc;
+    bc.init(gc, gc.info.encounter, false);
+
+    search::SimpleAgent simpleAgent;
+    search::AutoClad autoClad;
+    search::SimpleAgent &agent = agentType == BattleAgent::AUTOCLAD ? autoClad : simpleAgent;
+    agent.playoutBattle(bc);
+
+    const bool won = bc.outcome == Outcome::PLAYER_VICTORY;
+    return {won, gc.curHp - (won ? bc.player.curHp : 0), bc.turn};
+}
+
+const std::vector<BattleBatchResult>& BattleBatch::run() {
+    const auto agentCount = static_cast<std::uint64_t>(agents.size());
+    const auto battlesPerScenario = agentCount * seedCount;
+
+    // battle idx = (scenarioIdx * agentCount + agentIdx) * seedCount + seedIdx
+    std::vector<BattleOutcome> outcomes(battleCount());
+
+    BatchRunner runner(threadCount);
+    runner.run(0, outcomes.size(), [&](std::uint64_t battleIdx, BatchResult &threadResult) {
+        const auto scenarioIdx = battleIdx / battlesPerScenario;
+        const auto agentIdx = battleIdx % battlesPerScenario / seedCount;
+        const auto seed = seedStart + battleIdx % seedCount;
+
+        outcomes[battleIdx] = playBattle(scenarios[scenarioIdx], agents[agentIdx], seed);
+        ++(outcomes[battleIdx].won ? threadResult.winCount : threadResult.lossCount);
+    });
+    elapsed = runner.elapsed;
+
+    results.clear();
+    for (std::size_t scenarioIdx = 0; scenarioIdx < scenarios.size(); ++scenarioIdx) {
+        for (std::uint64_t agentIdx = 0; agentIdx < agentCount; ++agentIdx) {
+            BattleBatchResult r;
+            r.scenarioName = scenarios[scenarioIdx]["name"].get<std::string>();
+            r.agent = agents[agentIdx];
+
+            const auto first = (scenarioIdx * agentCount + agentIdx) * seedCount;
+            for (auto i = first; i < first + seedCount; ++i) {
+                r.winCount += outcomes[i].won;
+                r.hpLoss.push_back(outcomes[i].hpLoss);
+                r.turns.push_back(outcomes[i].turns);
+            }
+            results.push_back(std::move(r));
+        }
+    }
+    return results;
+}
+
+std::int64_t BattleBatch::battleCount() const {
+    return static_cast<std::int64_t>(scenarios.size() * agents.size() * seedCount);
+}
+
+void BattleBatch::printResults(std::ostream &os) const {
+    for (const auto &r : results) {
+        os << r.scenarioName << " " << getBattleAgentName(r.agent)
+            << " battles: " << r.battleCount()
+            << " winRate: " << r.winRate()
+            << " hpLoss mean: " << r.meanHpLoss()
+            << " p10/p50/p90/max: " << r.hpLossPercentile(10)
+            << "/" << r.hpLossPercentile(50)
+            << "/" << r.hpLossPercentile(90)
+            << "/" << r.hpLossPercentile(100)
+            << '\n';
+    }
+    os << "battles: " << battleCount()
+        << " threads: " << threadCount
+        << " elapsed: " << elapsed
+        << " battles/s: " << battleCount() / elapsed
+        << std::endl;
+}
@@ -0,0 +1,57 @@
+#ifndef STS_LIGHTSPEED_BATTLEBATCH_H
+#define STS_LIGHTSPEED_BATTLEBATCH_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace sts {
+
+    enum class BattleAgent {
+        SIMPLE,
+        AUTOCLAD,
+    };
+
+    const char *getBattleAgentName(BattleAgent a);
+
+    // outcome of one agent on one scenario over the whole seed range
+    struct BattleBatchResult {
+        std::string scenarioName;
+        BattleAgent agent = BattleAgent::SIMPLE;
+
+        int winCount = 0;
+        std::vector<int> hpLoss; // one per seed, in seed order. a loss counts the whole starting hp
+        std::vector<int> turns;
+
+        [[nodiscard]] int battleCount() const { return static_cast<int>(hpLoss.size()); }
+        [[nodiscard]] double winRate() const;
+        [[nodiscard]] double meanHpLoss() const;
+        [[nodiscard]] int hpLossPercentile(int percent) const;
+    };
+
+    // plays every scenario x seed x agent combination on a thread pool. each battle writes to its own slot and
+    // the slots are merged in order afterwards, so the results don't depend on the thread count
+    struct BattleBatch {
+        std::vector<nlohmann::json> scenarios; // scenario files, as loaded by utils::loadScenarioJsonFromDirectory
+        std::vector<BattleAgent> agents {BattleAgent::SIMPLE};
+        std::uint64_t seedStart = 0;
+        std::uint64_t seedCount = 1;
+        int threadCount = 1;
+
+        // results of the last run, indexed by scenarioIdx * agents.size() + agentIdx
+        std::vector<BattleBatchResult> results;
+        double elapsed = 0;
+
+        const std::vector<BattleBatchResult>& run();
+
+        [[nodiscard]] std::int64_t battleCount() const;
+        void printResults(std::ostream &os) const;
+    };
+
+}
+
+
+#endif //STS_LIGHTSPEED_BATTLEBATCH_H
@@ -672,8 +672,8 @@ void BattleContext::executeActions() {
 
         if (!actionQueue.isEmpty()) {
             // do a action
-            auto a = std::move(actionQueue.popFront());
-            a(*this);
+            const auto a = actionQueue.popFront();
+            a.execute(*this);
             continue;
         }
 
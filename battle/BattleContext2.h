@@ -7,6 +7,8 @@
 
 #include <vector>
 #include <array>
+#include <cstring>
+#include <type_traits>
 
 #include "sts_common.h"
 
@@ -100,6 +102,11 @@ namespace sts {
         BattleContext() = default;
         BattleContext(const BattleContext &rhs) = default;
 
+        // BattleContext is trivially copyable, this is the fast path for snapshotting and restoring a battle
+        void clone_into(BattleContext &other) const {
+            std::memcpy(&other, this, sizeof(BattleContext));
+        }
+
 // ****************************************
 
         void init(const GameContext &gc, MonsterEncounter encounterToInit, bool burningElite = false);
@@ -219,52 +226,59 @@ namespace sts {
 
     };
 
+    static_assert(std::is_trivially_copyable_v<BattleContext>);
+
     std::ostream& operator<<(std::ostream &os, const BattleContext &bc);
 
     template <PlayerStatus s>
     Action Actions::BuffPlayer(int amount) {
-        return {[=] (BattleContext &bc) {
-            if (s == PlayerStatus::CORRUPTION && !bc.player.hasStatus<PS::CORRUPTION>()) {
-                bc.cards.onBuffCorruption();
-            }
-            bc.player.buff<s>(amount);
-        }};
+        Action a(ActionId::BUFF_PLAYER);
+        a.enumValue = static_cast<std::uint8_t>(s);
+        a.amount = amount;
+        return a;
     }
 
     template <PlayerStatus s>
     Action Actions::DebuffPlayer(int amount, bool isSourceMonster) {
-        return {[=] (BattleContext &bc) {
-            bc.player.debuff<s>(amount, isSourceMonster);
-        }};
+        Action a(ActionId::DEBUFF_PLAYER);
+        a.enumValue = static_cast<std::uint8_t>(s);
+        a.amount = amount;
+        a.flag = isSourceMonster;
+        return a;
     }
 
     template<PlayerStatus s>
     Action Actions::DecrementStatus(int amount) {
-        return {[=] (BattleContext &bc) {
-            bc.player.decrementStatus<s>(amount);
-        }};
+        Action a(ActionId::DECREMENT_STATUS);
+        a.enumValue = static_cast<std::uint8_t>(s);
+        a.amount = amount;
+        return a;
     }
 
     template <PlayerStatus s>
     Action Actions::RemoveStatus() {
-        return {[=] (BattleContext &bc) {
-            bc.player.setHasStatus<s>(false);
-        }};
+        Action a(ActionId::REMOVE_STATUS);
+        a.enumValue = static_cast<std::uint8_t>(s);
+        return a;
     }
 
     template<MonsterStatus s>
     Action Actions::BuffEnemy(int idx, int amount) {
-        return {[=] (BattleContext &bc) {
-            // todo check if alive?
-            bc.monsters.arr[idx].buff<s>(amount);
-        }};
+        Action a(ActionId::BUFF_ENEMY);
+        a.enumValue = static_cast<std::uint8_t>(s);
+        a.idx = idx;
+        a.amount = amount;
+        return a;
     }
 
     template <MonsterStatus s>
     Action Actions::DebuffEnemy(int idx, int amount, bool isSourceMonster) {
-        return {[=] (BattleContext &bc) {
-            bc.debuffEnemy<s>(idx, amount, isSourceMonster);
-        }};
+        Action a(ActionId::DEBUFF_ENEMY);
+        a.enumValue = static_cast<std::uint8_t>(s);
+        a.idx = idx;
+        a.amount = amount;
+        a.flag = isSourceMonster;
+        return a;
     }
 
     template <MonsterStatus s>
@@ -272,13 +286,11 @@ namespace sts {
         // todo this should just add all to bot immediately, not be called first
         // ^^ never mind i think adding to top is a workaround here
 
-        return {[=] (BattleContext &bc) {
-            for (int i = bc.monsters.monsterCount-1; i >= 0; --i) {
-                if (bc.monsters.arr[i].isTargetable()) {
-                    bc.addToTop(Actions::DebuffEnemy<s>(i, amount, isSourceMonster));
-                }
-            }
-        }};
+        Action a(ActionId::DEBUFF_ALL_ENEMY);
+        a.enumValue = static_cast<std::uint8_t>(s);
+        a.amount = amount;
+        a.flag = isSourceMonster;
+        return a;
     }
 
     template <MonsterStatus s>
@@ -58,7 +58,7 @@ int Player::getStatusRuntime(PlayerStatus s) const {
             return strength;
         default:
             if (hasStatusRuntime(s)) {
-                return statusMap.at(s);
+                return statusValues[static_cast<int>(s)];
             } else {
                 return 0;
             }
@@ -354,12 +354,8 @@ void Player::applyEndOfTurnPowers(BattleContext &bc) {
     bomb2 = bomb3;
     bomb3 = 0;
 
-    for (auto pair : statusMap) {
-        if (!hasStatusRuntime(pair.first)) {
-            continue;
-        }
-
-        switch (pair.first) {
+    forEachStatus([&] (PlayerStatus s, int value) {
+        switch (s) {
             case PS::BURST:
                 bc.addToBot(Actions::RemoveStatus<PS::BURST>());
                 break;
@@ -367,12 +363,12 @@ void Player::applyEndOfTurnPowers(BattleContext &bc) {
             case PS::COMBUST:
                 if (!bc.monsters.areMonstersBasicallyDead()) {
                     bc.addToBot(Actions::PlayerLoseHp(combustHpLoss, true)); // todo combust doesnt stack hp loss correctly
-                    bc.addToBot(Actions::DamageAllEnemy(pair.second));
+                    bc.addToBot(Actions::DamageAllEnemy(value));
                 }
                 break;
 
             case PS::CONSTRICTED:
-                bc.addToBot(Actions::DamagePlayer(pair.second));
+                bc.addToBot(Actions::DamagePlayer(value));
                 break;
 
             case PS::DOUBLE_TAP:
@@ -392,12 +388,12 @@ void Player::applyEndOfTurnPowers(BattleContext &bc) {
                 break;
 
             case PS::LOSE_DEXTERITY:
-                bc.addToBot(Actions::DebuffPlayer<PS::DEXTERITY>(-pair.second));
+                bc.addToBot(Actions::DebuffPlayer<PS::DEXTERITY>(-value));
                 bc.addToBot(Actions::RemoveStatus<PS::LOSE_DEXTERITY>());
                 break;
 
             case PS::LOSE_STRENGTH:
-                bc.addToBot(Actions::DebuffPlayer<PS::STRENGTH>(-pair.second));
+                bc.addToBot(Actions::DebuffPlayer<PS::STRENGTH>(-value));
                 bc.addToBot(Actions::RemoveStatus<PS::LOSE_STRENGTH>());
                 break;
 
@@ -406,7 +402,7 @@ void Player::applyEndOfTurnPowers(BattleContext &bc) {
                 break;
 
             case PS::OMEGA:
-                bc.addToBot(Actions::DamageAllEnemy(pair.second));
+                bc.addToBot(Actions::DamageAllEnemy(value));
                 break;
 
             case PS::RAGE:
@@ -418,25 +414,25 @@ void Player::applyEndOfTurnPowers(BattleContext &bc) {
                 break;
 
             case PS::REGEN:
-                bc.addToTop(Actions::HealPlayer(pair.second));
+                bc.addToTop(Actions::HealPlayer(value));
                 bc.addToTop(Actions::DecrementStatus<PS::REGEN>());
                 break;
 
                 //case RetainCardPower -> if not has relic runic pyramid and not has power equilibrium, addToBot retain cards action
 
             case PS::RITUAL:
-                bc.addToBot(Actions::BuffPlayer<PS::STRENGTH>(pair.second));
+                bc.addToBot(Actions::BuffPlayer<PS::STRENGTH>(value));
                 break;
                 // case TheBomb
 
             case PS::WRAITH_FORM: // todo does this debuff or just decrement?
-                bc.addToBot(Actions::DecrementStatus<PS::DEXTERITY>(pair.second));
+                bc.addToBot(Actions::DecrementStatus<PS::DEXTERITY>(value));
                 break;
 
             default:
                 break;
         }
-    }
+    });
 }
 
 void Player::applyAtEndOfRoundPowers() {
@@ -542,9 +538,7 @@ void Player::applyStartOfTurnRelics(BattleContext &bc) {
     if (hasRelic<R::INSERTER>()) {
         if (++inserterCounter == 2) {
             inserterCounter = 0; // todo
-            bc.addToBot( {[=](BattleContext &bc) {
-                bc.player.increaseOrbSlots(1);
-            }});
+            bc.addToBot( Actions::IncreaseOrbSlots(1) );
         }
     }
 
@@ -564,22 +558,18 @@ void Player::applyStartOfTurnRelics(BattleContext &bc) {
 
 void Player::applyStartOfTurnPowers(BattleContext &bc) {
     // ****** Player powers atStartOfTurn ******
-    for (auto pair : statusMap) {
-        if (!hasStatusRuntime(pair.first)) {
-            continue;
-        }
-
-        switch (pair.first) {
+    forEachStatus([&] (PlayerStatus s, int value) {
+        switch (s) {
             case PS::BATTLE_HYMN:
-                bc.addToBot(Actions::MakeTempCardInHand(CardId::SMITE, hasStatus<PS::MASTER_REALITY>(), pair.second) );
+                bc.addToBot(Actions::MakeTempCardInHand(CardId::SMITE, hasStatus<PS::MASTER_REALITY>(), value) );
                 break;
 
             case PS::BIAS:
-                bc.addToBot( Actions::DecrementStatus<PS::FOCUS>(pair.second) );
+                bc.addToBot( Actions::DecrementStatus<PS::FOCUS>(value) );
                 break;
 
             case PS::CREATIVE_AI:
-//                bc.addToBot( Actions::SetState(InputState::CREATE_RANDOM_CARD_IN_HAND_POWER, pair.second) ); // todo
+//                bc.addToBot( Actions::SetState(InputState::CREATE_RANDOM_CARD_IN_HAND_POWER, value) ); // todo
                 break;
 
             case PS::ECHO_FORM:
@@ -599,7 +589,7 @@ void Player::applyStartOfTurnPowers(BattleContext &bc) {
                 if (bc.cards.drawPile.empty()) {
                     bc.addToTop( Actions::SetState(InputState::SHUFFLE_DISCARD_TO_DRAW) );
                 }
-//                bc.addToBot( Actions::SetState(InputState::SCRY, pair.second) ); // tood
+//                bc.addToBot( Actions::SetState(InputState::SCRY, value) ); // tood
                 break;
 
             case PS::FLAME_BARRIER:
@@ -611,7 +601,7 @@ void Player::applyStartOfTurnPowers(BattleContext &bc) {
                 break;
 
             case PS::INFINITE_BLADES:
-                bc.addToBot(Actions::MakeTempCardInHand(CardId::SHIV, hasStatus<PS::MASTER_REALITY>(), pair.second) );
+                bc.addToBot(Actions::MakeTempCardInHand(CardId::SHIV, hasStatus<PS::MASTER_REALITY>(), value) );
                 break;
 
             case PS::LOOP:
@@ -619,17 +609,17 @@ void Player::applyStartOfTurnPowers(BattleContext &bc) {
                 break;
 
             case PS::MAGNETISM:
-//                bc.addToBot( Actions::SetState(InputState::CREATE_RANDOM_CARD_IN_HAND_COLORLESS, pair.second) );
+//                bc.addToBot( Actions::SetState(InputState::CREATE_RANDOM_CARD_IN_HAND_COLORLESS, value) );
                 break;
 
             case PS::MAYHEM:
-                for (int i = 0; i < pair.second; i++) {
+                for (int x = 0; x < value; x++) {
                     bc.addToBot( Actions::PlayTopCard(bc.monsters.getRandomMonsterIdx(bc.cardRandomRng), false) ); // todo fix target
                 }
                 break;
 
             case PS::NEXT_TURN_BLOCK:
-                bc.addToBot( Actions::GainBlock(pair.second) );
+                bc.addToBot( Actions::GainBlock(value) );
                 removeStatus<PS::NEXT_TURN_BLOCK>();
                 break;
 
@@ -655,7 +645,7 @@ void Player::applyStartOfTurnPowers(BattleContext &bc) {
                 break;
         }
 
-    }
+    });
 }
 
 void Player::applyStartOfTurnPostDrawRelics(BattleContext &bc) {
@@ -673,43 +663,39 @@ void Player::applyStartOfTurnPostDrawRelics(BattleContext &bc) {
 
 void Player::applyStartOfTurnPostDrawPowers(BattleContext &bc) {
     // ****** Player Powers AtStartOfTurnPostDraw ******
-    for (auto pair :statusMap) {
-        if (!hasStatusRuntime(pair.first)) {
-            continue;
-        }
-
-        switch (pair.first) {
+    forEachStatus([&] (PlayerStatus s, int value) {
+        switch (s) {
             case PS::BRUTALITY:
-                bc.addToBot( Actions::PlayerLoseHp(pair.second) );
-                bc.addToBot( Actions::DrawCards(pair.second) );
+                bc.addToBot( Actions::PlayerLoseHp(value) );
+                bc.addToBot( Actions::DrawCards(value) );
                 break;
 
             case PS::DEMON_FORM:
-                bc.addToBot( Actions::BuffPlayer<PS::STRENGTH>(pair.second) );
+                bc.addToBot( Actions::BuffPlayer<PS::STRENGTH>(value) );
                 break;
 
             case PS::DEVOTION: // the implementation of this is really weird in the game code
-                bc.addToBot( Actions::BuffPlayer<PS::MANTRA>(pair.second) ); // todo make buffing mantra switch stance
+                bc.addToBot( Actions::BuffPlayer<PS::MANTRA>(value) ); // todo make buffing mantra switch stance
                 break;
 
             case PS::DRAW_CARD_NEXT_TURN:
-                bc.addToBot( Actions::DrawCards(pair.second) );
+                bc.addToBot( Actions::DrawCards(value) );
                 removeStatus<PS::DRAW_CARD_NEXT_TURN>();
                 break;
 
             case PS::NOXIOUS_FUMES:
-                bc.addToBot( Actions::DebuffAllEnemy<MS::POISON>(pair.second) );
+                bc.addToBot( Actions::DebuffAllEnemy<MS::POISON>(value) );
                 break;
 
             case PS::TOOLS_OF_THE_TRADE:
-                bc.addToBot( Actions::DrawCards(pair.second) );
-//                bc.addToBot( Actions::SetState(InputState::CHOOSE_DISCARD_CARDS, pair.second) );
+                bc.addToBot( Actions::DrawCards(value) );
+//                bc.addToBot( Actions::SetState(InputState::CHOOSE_DISCARD_CARDS, value) );
                 break;
 
             default:
                 break;
         }
-    }
+    });
 }
 
 void Player::rechargeEnergy(BattleContext &bc) {
@@ -860,8 +846,20 @@ namespace sts {
         printIfHaveStatus(p, os, PS::DEXTERITY);
         printIfHaveStatus(p, os, PS::FOCUS);
         printIfHaveStatus(p, os, PS::STRENGTH);
-        for (auto pair : p.statusMap) {
-            printIfHaveStatus(p, os, pair.first);
+        for (int i = 0; i < Player::PLAYER_STATUS_COUNT; ++i) {
+            const auto s = static_cast<PlayerStatus>(i);
+            switch (s) {
+                case PS::ARTIFACT:
+                case PS::DEXTERITY:
+                case PS::FOCUS:
+                case PS::STRENGTH:
+                case PS::BARRICADE:
+                case PS::CORRUPTION:
+                    break; // printed above
+
+                default:
+                    printIfHaveStatus(p, os, s);
+            }
         }
         os << "}\n";
     }
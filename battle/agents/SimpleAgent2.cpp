@@ -16,447 +16,19 @@
 #include "../Action2.h"
 
 
-#include <map>
 #include <array>
-#include <bitset>
+#include <iterator>
 #include <thread>
 #include <mutex>
 #include <vector>
 
 using namespace sts;
 
-static bool haveInitMaps = false;
-static int cardPriorityMap[372] {};
-static int cardPlayMap[372] {};
-static int bossRelicPriorityMap[200] {};
-static std::bitset<372> isAoeCard;
-static std::bitset<372> isDefensiveCard;
-static std::map<CardId, int> *maxCopies;
-
-static constexpr int mapWeights[3][6] = {
-        {100,1000,100,10,1,0},
-        {10,1000,10,100,1,0},
-        {100,1000,100,1,10,0},
-};
-
-
-void initMaps();
-
-bool shouldSkip(CardId id) {
-    return cardPriorityMap[static_cast<int>(id)] > cardPriorityMap[static_cast<int>(CardId::ANGER)];
-}
-
-int getHighHpMonster(const BattleContext &bc) {
-    int highHp = -1;
-    int highIdx = -1;
-    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-        if (bc.monsters.arr[i].isTargetable() && bc.monsters.arr[i].curHp > highHp) {
-            highHp = bc.monsters.arr[i].curHp;
-            highIdx = i;
-        }
-    }
-    return highIdx;
-}
-
-int getLowHpMonster(const BattleContext &bc) {
-    int lowHp = 10000;
-    int lowIdx = -1;
-    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-        if (bc.monsters.arr[i].isTargetable() && bc.monsters.arr[i].curHp < lowHp) {
-            lowHp = bc.monsters.arr[i].curHp;
-            lowIdx = i;
-        }
-    }
-    return lowIdx;
-}
-
-int getBestCardToPlay(const BattleContext &bc, fixed_list<int,10> handIdxs) {
-    int bestPriority = 10000;
-    int bestHandIdx;
-    for (int i = 0; i < handIdxs.size(); ++i) {
-        const auto c = bc.cards.hand[handIdxs[i]];
-        const int priority = 2 * cardPlayMap[static_cast<int>(c.getId())] + (c.isUpgraded() ? -1 : 0);
-        if (priority < bestPriority) {
-            bestPriority = priority;
-            bestHandIdx = handIdxs[i];
-        }
-    }
-    return bestHandIdx;
-}
-
-
-
-// Removed sortCardOptions - not needed for battle-only mode
-// void sortCardOptions(const GameContext &gc, fixed_list<int,96> &sortedCardIdxs) { ... }
-
-//void sortCardOptions(const GameContext &gc, fixed_list<int,96> &sortedCardIdxs) {
-//    sortedCardIdxs.clear();
-//    for (int i = 0; i < gc.info.toSelectCards.size(); ++i) {
-//        sortedCardIdxs.push_back(i);
-//    }
-//
-//    if (gc.info.selectScreenType == sts::CardSelectScreenType::UPGRADE ||
-//        gc.info.selectScreenType == sts::CardSelectScreenType::DUPLICATE)
-//    {
-//        std::sort(sortedCardIdxs.begin(), sortedCardIdxs.end(), [&](int a, int b) {
-//            auto ca = gc.info.toSelectCards[a].card;
-//            auto cb = gc.info.toSelectCards[b].card;
-//            return cardPriorityMap[static_cast<int>(ca.id)] < cardPriorityMap[static_cast<int>(cb.id)];
-//        });
-//
-//    } else {
-//        std::sort(sortedCardIdxs.begin(), sortedCardIdxs.end(), [&](int a, int b) {
-//            auto ca = gc.info.toSelectCards[a].card;
-//            auto cb = gc.info.toSelectCards[b].card;
-//            auto pa = cardPriorityMap[static_cast<int>(ca.id)];
-//            auto pb = cardPriorityMap[static_cast<int>(cb.id)];
-//            if (gc.info.selectScreenType == sts::CardSelectScreenType::TRANSFORM ||
-//                gc.info.selectScreenType == sts::CardSelectScreenType::TRANSFORM_UPGRADE) {
-//                if (ca.getType() == sts::CardType::CURSE) {
-//                    pa -= 1000;
-//                }
-//                if (cb.getType() == sts::CardType::CURSE) {
-//                    pb -= 1000;
-//                }
-//            }
-//            return  pa > pb;
-//        });
-//    }
-//}
-
-int search::SimpleAgent::getIncomingDamage(const BattleContext &bc) const {
-    int incomingDamage = 0;
-    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-        const auto &m = bc.monsters.arr[i];
-        if (m.isDeadOrEscaped() || m.isHalfDead()) {
-            continue;
-        }
-
-        // NOTE(ben): No idea what this Runic Dome thing is about
-        DamageInfo dInfo;
-        if (bc.player.hasRelic<R::RUNIC_DOME>()) {
-            // dInfo = {5*curGameContext->act, 1}; // Commented out - curGameContext not available in battle-only mode
-            dInfo = {5, 1}; // Simplified for battle-only mode
-
-        } else {
-            dInfo = m.getMoveBaseDamage(bc);
-            dInfo.damage = m.calculateDamageToPlayer(bc, dInfo.damage);
-        }
-
-        incomingDamage += dInfo.damage * dInfo.attackCount;
-    }
-    return incomingDamage;
-}
-
-struct Path {
-    fixed_list<int,16> route;
-    int weight= 0;
-};
-
-// Removed getBestMapPathForWeights - not needed for battle-only mode
-// fixed_list<int,16> search::SimpleAgent::getBestMapPathForWeights(const Map &m, const int *weights) { ... }
-
-static void printHelper(const BattleContext &bc, const search::Action &a) {
-    std::cout << bc << std::endl;
-    a.printDesc(std::cout, bc) << " ";
-    std::cout
-            << " turn: " << bc.turn
-            << " energy: " << bc.player.energy
-            << " cardsPlayedThisTurn: " << bc.player.cardsPlayedThisTurn
-            << " state: " << (bc.inputState == InputState::PLAYER_NORMAL ? "normal" : " probably card select")
-            << std::endl;
-}
-
-search::SimpleAgent::SimpleAgent() {
-    initMaps();
-}
-
-// Removed non-battle takeAction - not needed for battle-only mode
-// void search::SimpleAgent::takeAction(GameContext &gc, search::GameAction a) { ... }
-
-void search::SimpleAgent::takeAction(BattleContext &bc, search::Action a) {
-    actionHistory.emplace_back(a.bits);
-    if (print) {
-        printHelper(bc, a);
-    }
-    a.execute(bc);
-}
-
-// Removed playoutBattleOnly wrapper - just use playoutBattle directly
-
-// returns whether all potions have been tried
-bool search::SimpleAgent::playPotion(BattleContext &bc) {
-    bool usedAll = true;
-    int i = 0;
-    for (; i < bc.potionCapacity; ++i) {
-        auto p = bc.potions[i];
-
-        bool canDrink = !(p == sts::Potion::FAIRY_POTION || p == sts::Potion::EMPTY_POTION_SLOT);
-
-        if (canDrink) {
-            int target = 0;
-            if (potionRequiresTarget(bc.potions[i]) ) {
-                if (bc.monsters.getTargetableCount() <= 0) {
-                    continue;
-                }
-                target = getHighHpMonster(bc);
-
-            } else {
-
-            }
-            takeAction(bc, search::Action(search::ActionType::POTION, i, target));
-            break;
-        }
-    }
-    return i == bc.potionCapacity;
-}
-
-void search::SimpleAgent::playoutBattle(BattleContext &bc) {
-    bool usedPotions = !isBossEncounter(bc.encounter);
-    while (bc.outcome == Outcome::UNDECIDED) {
-        if (bc.inputState == InputState::CARD_SELECT) {
-            stepBattleCardSelect(bc);
-
-        } else if (bc.inputState == InputState::PLAYER_NORMAL) {
-            if (usedPotions) {
-                stepBattleCardPlay(bc);
-
-            } else {
-                usedPotions = playPotion(bc);
-            }
-        } else {
-            assert(false);
-        }
-    }
-}
-
-void search::SimpleAgent::stepBattleCardPlay(BattleContext &bc) {
-    if (!bc.isCardPlayAllowed() || bc.player.cardsPlayedThisTurn > 1000) {
-        takeAction(bc, Action(ActionType::END_TURN));
-        return;
-    }
-
-    fixed_list<int,10> playableCardsIdxs;
-    for (int i = 0; i < bc.cards.cardsInHand; ++i) {
-        const auto &c = bc.cards.hand[i];
-        if (c.canUseOnAnyTarget(bc)) {
-            playableCardsIdxs.push_back(i);
-        }
-    }
-
-    if (playableCardsIdxs.empty()) {
-        takeAction(bc, Action(ActionType::END_TURN));
-        return;
-    }
-
-    fixed_list<int,10> zeroCost;
-    fixed_list<int,10> zeroCostAttacks;
-    fixed_list<int,10> zeroCostNonAttacks;
-    fixed_list<int,10> nonZeroCostCards;
-    fixed_list<int,10> aoeCards;
-
-    for (auto handIdx : playableCardsIdxs) {
-        const auto &c = bc.cards.hand[handIdx];
-        if (isAoeCard.test(static_cast<int>(c.getId()))) {
-            aoeCards.push_back(handIdx);
-        }
-        if (c.cost == 0 || c.costForTurn == 0) {
-            zeroCost.push_back(handIdx);
-            if (c.getType() == CardType::ATTACK) {
-                zeroCostAttacks.push_back(handIdx);
-            } else {
-                zeroCostNonAttacks.push_back(handIdx);
-            }
-        } else {
-            nonZeroCostCards.push_back(handIdx);
-        }
-    }
-
-    const int incomingDamage = getIncomingDamage(bc);
-    // if (bc.player.block > (incomingDamage - curGameContext->act - 4)) { // Commented out - curGameContext not available in battle-only mode
-    if (bc.player.block > (incomingDamage - 1 - 4)) { // Simplified for battle-only mode
-        fixed_list<int,10> offensiveCards;
-        for (auto handIdx : nonZeroCostCards) {
-            const auto &c = bc.cards.hand[handIdx];
-            const bool isDefensive = isDefensiveCard.test(static_cast<int>(c.getId()));
-            if (!isDefensive) {
-                offensiveCards.push_back(handIdx);
-            }
-        }
-
-        if (offensiveCards.empty()) {
-            for (int i = nonZeroCostCards.size()-1; i >= 0; --i) {
-                const auto &c = bc.cards.hand[nonZeroCostCards[i]];
-                if (c.doesExhaust()) {
-                    nonZeroCostCards.remove(i);
-                }
-            }
-        } else {
-            nonZeroCostCards = offensiveCards;
-        }
-    }
-
-    int bestCardIdx = playableCardsIdxs.front();
-    if (!zeroCostNonAttacks.empty()) {
-        bestCardIdx = getBestCardToPlay(bc, zeroCostNonAttacks);
-
-    } else if (!nonZeroCostCards.empty()) {
-        bestCardIdx = getBestCardToPlay(bc, nonZeroCostCards);
-        if (!aoeCards.empty() && bc.monsters.monstersAlive > 1 && bc.cards.hand[bestCardIdx].getType() == CardType::ATTACK) {
-            bestCardIdx = getBestCardToPlay(bc, aoeCards);
-        }
-
-    } else if (!zeroCostAttacks.empty()) {
-        bestCardIdx = getBestCardToPlay(bc, zeroCostAttacks);
-
-    } else {
-        takeAction(bc, Action(ActionType::END_TURN));
-        return;
-    }
-
-    const auto &c = bc.cards.hand[bestCardIdx];
-    if (!c.requiresTarget()) {
-        takeAction(bc, Action(ActionType::CARD, bestCardIdx));
-        return;
-    }
-
-    int targetIdx;
-    if (c.getType() == CardType::ATTACK) {
-         targetIdx = getLowHpMonster(bc);
-    } else {
-        targetIdx = getHighHpMonster(bc);
-    }
-    takeAction(bc, Action(ActionType::CARD, bestCardIdx, targetIdx));
-}
-
-template <typename ForwardIt>
-void setupCardOptionsHelper(std::vector<std::pair<search::Action,CardInstance>> &actions, const ForwardIt begin, const ForwardIt end, const std::function<bool(const CardInstance &)> &p= nullptr) {
-    for (int i = 0; begin+i != end; ++i) {
-        const auto &c = begin[i];
-        if (!p || (p(c))) {
-            actions.emplace_back(std::make_pair(search::Action(search::ActionType::SINGLE_CARD_SELECT, i), c));
-        }
-    }
-}
-
-
-
-
-
-void search::SimpleAgent::stepBattleCardSelect(BattleContext &bc) {
-
-    std::vector<std::pair<search::Action,CardInstance>> actions;
-    switch (bc.cardSelectInfo.cardSelectTask) {
-        case CardSelectTask::ARMAMENTS:
-            setupCardOptionsHelper( actions, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand,
-                                    [] (const CardInstance &c) { return c.canUpgrade(); });
-            break;
-
-        case CardSelectTask::CODEX:
-            for (int i = 0; i < 3; ++i) { // i -> 3 action means skip
-                actions.emplace_back(search::Action(search::ActionType::SINGLE_CARD_SELECT, i), bc.cardSelectInfo.codexCards()[i]);
-            }
-            break;
-
-        case CardSelectTask::DISCOVERY:
-            for (int i = 0; i < 3; ++i) {
-                actions.emplace_back(search::Action(search::ActionType::SINGLE_CARD_SELECT, i), bc.cardSelectInfo.codexCards()[i]);
-            }
-            break;
-
-        case CardSelectTask::DUAL_WIELD:
-            setupCardOptionsHelper( actions, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand,
-                                    [] (const CardInstance &c) {
-                                        return c.getType() == CardType::POWER || c.getType() == CardType::ATTACK;
-                                    });
-            break;
-
-        case CardSelectTask::EXHUME:
-            setupCardOptionsHelper(actions, bc.cards.exhaustPile.begin(), bc.cards.exhaustPile.end(),
-                                   [](const auto &c) { return c.getId() != CardId::EXHUME; });
-            break;
-
-        case CardSelectTask::EXHAUST_ONE:
-            setupCardOptionsHelper(actions, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand);
-            break;
-
-        case CardSelectTask::FORETHOUGHT:
-        case CardSelectTask::WARCRY:
-            setupCardOptionsHelper(actions, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand);
-            break;
-
-        case CardSelectTask::HEADBUTT:
-        case CardSelectTask::LIQUID_MEMORIES_POTION:
-            setupCardOptionsHelper(actions, bc.cards.discardPile.begin(), bc.cards.discardPile.end());
-            break;
-
-        case CardSelectTask::SECRET_TECHNIQUE:
-            setupCardOptionsHelper(actions, bc.cards.drawPile.begin(), bc.cards.drawPile.end(),
-                                   [] (const CardInstance &c) {
-                                       return c.getType() == CardType::SKILL;
-                                   });
-            break;
-
-        case CardSelectTask::SECRET_WEAPON:
-            setupCardOptionsHelper(actions, bc.cards.drawPile.begin(), bc.cards.drawPile.end(),
-                                   [] (const CardInstance &c) {
-                                       return c.getType() == CardType::ATTACK;
-                                   });
-            break;
-
-        case CardSelectTask::EXHAUST_MANY:
-        case CardSelectTask::GAMBLE: // just select none
-            takeAction(bc, search::Action(search::ActionType::MULTI_CARD_SELECT, 0));
-            return;
-
-        default:
-#ifdef sts_asserts
-            assert(false);
-#endif
-            break;
-    }
-
-    std::sort(actions.begin(), actions.end(), [](std::pair<search::Action,CardInstance> a, std::pair<search::Action,CardInstance> b) {
-        auto pa = 2 * cardPriorityMap[static_cast<int>(a.second.id)] + (a.second.isUpgraded() ? -1 : 0);
-        auto pb = 2 * cardPriorityMap[static_cast<int>(b.second.id)] + (b.second.isUpgraded() ? -1 : 0);
-        return pa < pb;
-    });
-
-    switch (bc.cardSelectInfo.cardSelectTask) {
-        case CardSelectTask::ARMAMENTS:
-        case CardSelectTask::DUAL_WIELD:
-        case CardSelectTask::CODEX:
-        case CardSelectTask::DISCOVERY:
-        case CardSelectTask::EXHUME:
-        case CardSelectTask::FORETHOUGHT:
-        case CardSelectTask::HEADBUTT:
-        case CardSelectTask::HOLOGRAM:
-        case CardSelectTask::LIQUID_MEMORIES_POTION:
-        case CardSelectTask::NIGHTMARE:
-        case CardSelectTask::MEDITATE:
-        case CardSelectTask::SECRET_TECHNIQUE:
-        case CardSelectTask::SECRET_WEAPON:
-        case CardSelectTask::SETUP:
-        case CardSelectTask::SEEK:
-        case CardSelectTask::WARCRY:
-            takeAction(bc, actions.front().first);
-            break;
-
-        case CardSelectTask::EXHAUST_ONE:
-        case CardSelectTask::RECYCLE:
-            takeAction(bc, actions.back().first);
-            break;
-
-        case CardSelectTask::EXHAUST_MANY:
-        case CardSelectTask::INVALID:
-        case CardSelectTask::GAMBLE:
-        default:
-#ifdef sts_asserts
-            assert(false);
-#endif
-            break;
-    }
-}
+static constexpr int mapWeights[3][6] = {
+        {100,1000,100,10,1,0},
+        {10,1000,10,100,1,0},
+        {100,1000,100,1,10,0},
+};
 
 constexpr std::array<CardId,133> cardsPriorities = {
         CardId::APOTHEOSIS,
@@ -730,110 +302,498 @@ constexpr std::array<CardId,133> cardPlayPriorities = {
         CardId::PRIDE,
 };
 
-constexpr std::array<CardId,13>  defensiveCards = {
-        CardId::POWER_THROUGH,
-        CardId::TRUE_GRIT,
-        CardId::IMPERVIOUS,
-        CardId::SHRUG_IT_OFF,
-        CardId::FLAME_BARRIER,
-        CardId::ENTRENCH,
-        CardId::DEFEND_RED,
-        CardId::SENTINEL,
-        CardId::SECOND_WIND,
-        CardId::GHOSTLY_ARMOR,
-        CardId::DARK_SHACKLES,
-        CardId::PANIC_BUTTON,
-        CardId::RAGE,
-};
+constexpr std::array<CardId,13> defensiveCards = {
+        CardId::POWER_THROUGH,
+        CardId::TRUE_GRIT,
+        CardId::IMPERVIOUS,
+        CardId::SHRUG_IT_OFF,
+        CardId::FLAME_BARRIER,
+        CardId::ENTRENCH,
+        CardId::DEFEND_RED,
+        CardId::SENTINEL,
+        CardId::SECOND_WIND,
+        CardId::GHOSTLY_ARMOR,
+        CardId::DARK_SHACKLES,
+        CardId::PANIC_BUTTON,
+        CardId::RAGE,
+};
+
+constexpr std::array<RelicId,24> bossRelicPriorities = {
+        R::SOZU,
+        R::SNECKO_EYE,
+        R::PHILOSOPHERS_STONE,
+        R::RUNIC_DOME,
+        R::CURSED_KEY,
+        R::FUSION_HAMMER,
+        R::VELVET_CHOKER,
+        R::ECTOPLASM,
+        R::MARK_OF_PAIN,
+        R::BUSTED_CROWN,
+        R::EMPTY_CAGE,
+        R::ASTROLABE,
+        R::RUNIC_PYRAMID,
+        R::LIZARD_TAIL,
+        R::ETERNAL_FEATHER,
+        R::COFFEE_DRIPPER,
+        R::BLACK_BLOOD,
+        R::TINY_HOUSE,
+        R::BLACK_STAR,
+        R::ORRERY,
+        R::RUNIC_CUBE,
+        R::PANDORAS_BOX,
+        R::WHITE_BEAST_STATUE,
+        R::CALLING_BELL,
+};
+
+constexpr std::array<CardId,4> aoeCards = {
+        CardId::CLEAVE,
+        CardId::IMMOLATE,
+        CardId::THUNDERCLAP,
+        CardId::WHIRLWIND,
+};
+
+// the lookup tables below are indexed by id and built at compile time, so there is nothing to initialize when
+// several agents start on different threads
+static constexpr std::size_t cardIdCount = std::size(cardNames);
+
+// priority is the 1 based position in the list, 0 for ids not in it
+template <std::size_t IdCount, typename Id, std::size_t N>
+static constexpr std::array<int,IdCount> makePriorityMap(const std::array<Id,N> &priorities) {
+    std::array<int,IdCount> ret {};
+    for (std::size_t i = 0; i < N; ++i) {
+        ret[static_cast<int>(priorities[i])] = static_cast<int>(i) + 1;
+    }
+    return ret;
+}
+
+template <std::size_t N>
+static constexpr std::array<bool,cardIdCount> makeCardSet(const std::array<CardId,N> &cards) {
+    std::array<bool,cardIdCount> ret {};
+    for (auto c : cards) {
+        ret[static_cast<int>(c)] = true;
+    }
+    return ret;
+}
+
+static constexpr auto cardPriorityMap = makePriorityMap<cardIdCount>(cardsPriorities);
+static constexpr auto cardPlayMap = makePriorityMap<cardIdCount>(cardPlayPriorities);
+static constexpr auto isAoeCard = makeCardSet(aoeCards);
+static constexpr auto isDefensiveCard = makeCardSet(defensiveCards);
+
+bool shouldSkip(CardId id) {
+    return cardPriorityMap[static_cast<int>(id)] > cardPriorityMap[static_cast<int>(CardId::ANGER)];
+}
+
+int getHighHpMonster(const BattleContext &bc) {
+    int highHp = -1;
+    int highIdx = -1;
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        if (bc.monsters.arr[i].isTargetable() && bc.monsters.arr[i].curHp > highHp) {
+            highHp = bc.monsters.arr[i].curHp;
+            highIdx = i;
+        }
+    }
+    return highIdx;
+}
+
+int getLowHpMonster(const BattleContext &bc) {
+    int lowHp = 10000;
+    int lowIdx = -1;
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        if (bc.monsters.arr[i].isTargetable() && bc.monsters.arr[i].curHp < lowHp) {
+            lowHp = bc.monsters.arr[i].curHp;
+            lowIdx = i;
+        }
+    }
+    return lowIdx;
+}
+
+int getBestCardToPlay(const BattleContext &bc, fixed_list<int,10> handIdxs) {
+    int bestPriority = 10000;
+    int bestHandIdx;
+    for (int i = 0; i < handIdxs.size(); ++i) {
+        const auto c = bc.cards.hand[handIdxs[i]];
+        const int priority = 2 * cardPlayMap[static_cast<int>(c.getId())] + (c.isUpgraded() ? -1 : 0);
+        if (priority < bestPriority) {
+            bestPriority = priority;
+            bestHandIdx = handIdxs[i];
+        }
+    }
+    return bestHandIdx;
+}
+
+
+
+// Removed sortCardOptions - not needed for battle-only mode
+// void sortCardOptions(const GameContext &gc, fixed_list<int,96> &sortedCardIdxs) { ... }
+
+//void sortCardOptions(const GameContext &gc, fixed_list<int,96> &sortedCardIdxs) {
+//    sortedCardIdxs.clear();
+//    for (int i = 0; i < gc.info.toSelectCards.size(); ++i) {
+//        sortedCardIdxs.push_back(i);
+//    }
+//
+//    if (gc.info.selectScreenType == sts::CardSelectScreenType::UPGRADE ||
+//        gc.info.selectScreenType == sts::CardSelectScreenType::DUPLICATE)
+//    {
+//        std::sort(sortedCardIdxs.begin(), sortedCardIdxs.end(), [&](int a, int b) {
+//            auto ca = gc.info.toSelectCards[a].card;
+//            auto cb = gc.info.toSelectCards[b].card;
+//            return cardPriorityMap[static_cast<int>(ca.id)] < cardPriorityMap[static_cast<int>(cb.id)];
+//        });
+//
+//    } else {
+//        std::sort(sortedCardIdxs.begin(), sortedCardIdxs.end(), [&](int a, int b) {
+//            auto ca = gc.info.toSelectCards[a].card;
+//            auto cb = gc.info.toSelectCards[b].card;
+//            auto pa = cardPriorityMap[static_cast<int>(ca.id)];
+//            auto pb = cardPriorityMap[static_cast<int>(cb.id)];
+//            if (gc.info.selectScreenType == sts::CardSelectScreenType::TRANSFORM ||
+//                gc.info.selectScreenType == sts::CardSelectScreenType::TRANSFORM_UPGRADE) {
+//                if (ca.getType() == sts::CardType::CURSE) {
+//                    pa -= 1000;
+//                }
+//                if (cb.getType() == sts::CardType::CURSE) {
+//                    pb -= 1000;
+//                }
+//            }
+//            return  pa > pb;
+//        });
+//    }
+//}
+
+int search::SimpleAgent::getIncomingDamage(const BattleContext &bc) const {
+    int incomingDamage = 0;
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        const auto &m = bc.monsters.arr[i];
+        if (m.isDeadOrEscaped() || m.isHalfDead()) {
+            continue;
+        }
+
+        // NOTE(ben): No idea what this Runic Dome thing is about
+        DamageInfo dInfo;
+        if (bc.player.hasRelic<R::RUNIC_DOME>()) {
+            // dInfo = {5*curGameContext->act, 1}; // Commented out - curGameContext not available in battle-only mode
+            dInfo = {5, 1}; // Simplified for battle-only mode
+
+        } else {
+            dInfo = m.getMoveBaseDamage(bc);
+            dInfo.damage = m.calculateDamageToPlayer(bc, dInfo.damage);
+        }
+
+        incomingDamage += dInfo.damage * dInfo.attackCount;
+    }
+    return incomingDamage;
+}
+
+struct Path {
+    fixed_list<int,16> route;
+    int weight= 0;
+};
+
+// Removed getBestMapPathForWeights - not needed for battle-only mode
+// fixed_list<int,16> search::SimpleAgent::getBestMapPathForWeights(const Map &m, const int *weights) { ... }
+
+static void printHelper(const BattleContext &bc, const search::Action &a) {
+    std::cout << bc << std::endl;
+    a.printDesc(std::cout, bc) << " ";
+    std::cout
+            << " turn: " << bc.turn
+            << " energy: " << bc.player.energy
+            << " cardsPlayedThisTurn: " << bc.player.cardsPlayedThisTurn
+            << " state: " << (bc.inputState == InputState::PLAYER_NORMAL ? "normal" : " probably card select")
+            << std::endl;
+}
+
+// Removed non-battle takeAction - not needed for battle-only mode
+// void search::SimpleAgent::takeAction(GameContext &gc, search::GameAction a) { ... }
+
+void search::SimpleAgent::takeAction(BattleContext &bc, search::Action a) {
+    actionHistory.emplace_back(a.bits);
+    if (print) {
+        printHelper(bc, a);
+    }
+    a.execute(bc);
+}
+
+// Removed playoutBattleOnly wrapper - just use playoutBattle directly
+
+// returns whether all potions have been tried
+bool search::SimpleAgent::playPotion(BattleContext &bc) {
+    bool usedAll = true;
+    int i = 0;
+    for (; i < bc.potionCapacity; ++i) {
+        auto p = bc.potions[i];
+
+        bool canDrink = !(p == sts::Potion::FAIRY_POTION || p == sts::Potion::EMPTY_POTION_SLOT);
+
+        if (canDrink) {
+            int target = 0;
+            if (potionRequiresTarget(bc.potions[i]) ) {
+                if (bc.monsters.getTargetableCount() <= 0) {
+                    continue;
+                }
+                target = getHighHpMonster(bc);
+
+            } else {
+
+            }
+            takeAction(bc, search::Action(search::ActionType::POTION, i, target));
+            break;
+        }
+    }
+    return i == bc.potionCapacity;
+}
+
+void search::SimpleAgent::playoutBattle(BattleContext &bc) {
+    bool usedPotions = !isBossEncounter(bc.encounter);
+    while (bc.outcome == Outcome::UNDECIDED) {
+        if (bc.inputState == InputState::CARD_SELECT) {
+            stepBattleCardSelect(bc);
+
+        } else if (bc.inputState == InputState::PLAYER_NORMAL) {
+            if (usedPotions) {
+                stepBattleCardPlay(bc);
+
+            } else {
+                usedPotions = playPotion(bc);
+            }
+        } else {
+            assert(false);
+        }
+    }
+}
+
+void search::SimpleAgent::stepBattleCardPlay(BattleContext &bc) {
+    if (!bc.isCardPlayAllowed() || bc.player.cardsPlayedThisTurn > 1000) {
+        takeAction(bc, Action(ActionType::END_TURN));
+        return;
+    }
 
-constexpr std::array<RelicId,24> bossRelicPriorities = {
-        R::SOZU,
-        R::SNECKO_EYE,
-        R::PHILOSOPHERS_STONE,
-        R::RUNIC_DOME,
-        R::CURSED_KEY,
-        R::FUSION_HAMMER,
-        R::VELVET_CHOKER,
-        R::ECTOPLASM,
-        R::MARK_OF_PAIN,
-        R::BUSTED_CROWN,
-        R::EMPTY_CAGE,
-        R::ASTROLABE,
-        R::RUNIC_PYRAMID,
-        R::LIZARD_TAIL,
-        R::ETERNAL_FEATHER,
-        R::COFFEE_DRIPPER,
-        R::BLACK_BLOOD,
-        R::TINY_HOUSE,
-        R::BLACK_STAR,
-        R::ORRERY,
-        R::RUNIC_CUBE,
-        R::PANDORAS_BOX,
-        R::WHITE_BEAST_STATUE,
-        R::CALLING_BELL,
-};
+    fixed_list<int,10> playableCardsIdxs;
+    for (int i = 0; i < bc.cards.cardsInHand; ++i) {
+        const auto &c = bc.cards.hand[i];
+        if (c.canUseOnAnyTarget(bc)) {
+            playableCardsIdxs.push_back(i);
+        }
+    }
+
+    if (playableCardsIdxs.empty()) {
+        takeAction(bc, Action(ActionType::END_TURN));
+        return;
+    }
+
+    fixed_list<int,10> zeroCost;
+    fixed_list<int,10> zeroCostAttacks;
+    fixed_list<int,10> zeroCostNonAttacks;
+    fixed_list<int,10> nonZeroCostCards;
+    fixed_list<int,10> aoeCards;
+
+    for (auto handIdx : playableCardsIdxs) {
+        const auto &c = bc.cards.hand[handIdx];
+        if (isAoeCard[static_cast<int>(c.getId())]) {
+            aoeCards.push_back(handIdx);
+        }
+        if (c.cost == 0 || c.costForTurn == 0) {
+            zeroCost.push_back(handIdx);
+            if (c.getType() == CardType::ATTACK) {
+                zeroCostAttacks.push_back(handIdx);
+            } else {
+                zeroCostNonAttacks.push_back(handIdx);
+            }
+        } else {
+            nonZeroCostCards.push_back(handIdx);
+        }
+    }
+
+    const int incomingDamage = getIncomingDamage(bc);
+    // if (bc.player.block > (incomingDamage - curGameContext->act - 4)) { // Commented out - curGameContext not available in battle-only mode
+    if (bc.player.block > (incomingDamage - 1 - 4)) { // Simplified for battle-only mode
+        fixed_list<int,10> offensiveCards;
+        for (auto handIdx : nonZeroCostCards) {
+            const auto &c = bc.cards.hand[handIdx];
+            const bool isDefensive = isDefensiveCard[static_cast<int>(c.getId())];
+            if (!isDefensive) {
+                offensiveCards.push_back(handIdx);
+            }
+        }
+
+        if (offensiveCards.empty()) {
+            for (int i = nonZeroCostCards.size()-1; i >= 0; --i) {
+                const auto &c = bc.cards.hand[nonZeroCostCards[i]];
+                if (c.doesExhaust()) {
+                    nonZeroCostCards.remove(i);
+                }
+            }
+        } else {
+            nonZeroCostCards = offensiveCards;
+        }
+    }
+
+    int bestCardIdx = playableCardsIdxs.front();
+    if (!zeroCostNonAttacks.empty()) {
+        bestCardIdx = getBestCardToPlay(bc, zeroCostNonAttacks);
+
+    } else if (!nonZeroCostCards.empty()) {
+        bestCardIdx = getBestCardToPlay(bc, nonZeroCostCards);
+        if (!aoeCards.empty() && bc.monsters.monstersAlive > 1 && bc.cards.hand[bestCardIdx].getType() == CardType::ATTACK) {
+            bestCardIdx = getBestCardToPlay(bc, aoeCards);
+        }
+
+    } else if (!zeroCostAttacks.empty()) {
+        bestCardIdx = getBestCardToPlay(bc, zeroCostAttacks);
 
+    } else {
+        takeAction(bc, Action(ActionType::END_TURN));
+        return;
+    }
 
-void initMaps() {
-    // there are synchronization issues with this if multiple threads start at once
-    if (haveInitMaps) {
+    const auto &c = bc.cards.hand[bestCardIdx];
+    if (!c.requiresTarget()) {
+        takeAction(bc, Action(ActionType::CARD, bestCardIdx));
         return;
     }
-    haveInitMaps = true;
-    for (int i = 0; i < cardPlayPriorities.size(); ++i) {
-        CardId c = cardPlayPriorities[i];
-        cardPlayMap[static_cast<int>(c)] = i + 1;
+
+    int targetIdx;
+    if (c.getType() == CardType::ATTACK) {
+         targetIdx = getLowHpMonster(bc);
+    } else {
+        targetIdx = getHighHpMonster(bc);
     }
+    takeAction(bc, Action(ActionType::CARD, bestCardIdx, targetIdx));
+}
 
-    for (int i = 0; i < cardsPriorities.size(); ++i) {
-        CardId c = cardsPriorities[i];
-        cardPriorityMap[static_cast<int>(c)] = i + 1;
+template <typename ForwardIt>
+void setupCardOptionsHelper(std::vector<std::pair<search::Action,CardInstance>> &actions, const ForwardIt begin, const ForwardIt end, const std::function<bool(const CardInstance &)> &p= nullptr) {
+    for (int i = 0; begin+i != end; ++i) {
+        const auto &c = begin[i];
+        if (!p || (p(c))) {
+            actions.emplace_back(std::make_pair(search::Action(search::ActionType::SINGLE_CARD_SELECT, i), c));
+        }
     }
+}
+
+
+
+
+
+void search::SimpleAgent::stepBattleCardSelect(BattleContext &bc) {
+
+    std::vector<std::pair<search::Action,CardInstance>> actions;
+    switch (bc.cardSelectInfo.cardSelectTask) {
+        case CardSelectTask::ARMAMENTS:
+            setupCardOptionsHelper( actions, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand,
+                                    [] (const CardInstance &c) { return c.canUpgrade(); });
+            break;
+
+        case CardSelectTask::CODEX:
+            for (int i = 0; i < 3; ++i) { // i -> 3 action means skip
+                actions.emplace_back(search::Action(search::ActionType::SINGLE_CARD_SELECT, i), bc.cardSelectInfo.codexCards()[i]);
+            }
+            break;
+
+        case CardSelectTask::DISCOVERY:
+            for (int i = 0; i < 3; ++i) {
+                actions.emplace_back(search::Action(search::ActionType::SINGLE_CARD_SELECT, i), bc.cardSelectInfo.codexCards()[i]);
+            }
+            break;
+
+        case CardSelectTask::DUAL_WIELD:
+            setupCardOptionsHelper( actions, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand,
+                                    [] (const CardInstance &c) {
+                                        return c.getType() == CardType::POWER || c.getType() == CardType::ATTACK;
+                                    });
+            break;
+
+        case CardSelectTask::EXHUME:
+            setupCardOptionsHelper(actions, bc.cards.exhaustPile.begin(), bc.cards.exhaustPile.end(),
+                                   [](const auto &c) { return c.getId() != CardId::EXHUME; });
+            break;
+
+        case CardSelectTask::EXHAUST_ONE:
+            setupCardOptionsHelper(actions, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand);
+            break;
+
+        case CardSelectTask::FORETHOUGHT:
+        case CardSelectTask::WARCRY:
+            setupCardOptionsHelper(actions, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand);
+            break;
+
+        case CardSelectTask::HEADBUTT:
+        case CardSelectTask::LIQUID_MEMORIES_POTION:
+            setupCardOptionsHelper(actions, bc.cards.discardPile.begin(), bc.cards.discardPile.end());
+            break;
 
-    for (int i = 0; i < bossRelicPriorities.size(); ++i) {
-        RelicId r = bossRelicPriorities[i];
-        bossRelicPriorityMap[static_cast<int>(r)] = i + 1;
+        case CardSelectTask::SECRET_TECHNIQUE:
+            setupCardOptionsHelper(actions, bc.cards.drawPile.begin(), bc.cards.drawPile.end(),
+                                   [] (const CardInstance &c) {
+                                       return c.getType() == CardType::SKILL;
+                                   });
+            break;
+
+        case CardSelectTask::SECRET_WEAPON:
+            setupCardOptionsHelper(actions, bc.cards.drawPile.begin(), bc.cards.drawPile.end(),
+                                   [] (const CardInstance &c) {
+                                       return c.getType() == CardType::ATTACK;
+                                   });
+            break;
+
+        case CardSelectTask::EXHAUST_MANY:
+        case CardSelectTask::GAMBLE: // just select none
+            takeAction(bc, search::Action(search::ActionType::MULTI_CARD_SELECT, 0));
+            return;
+
+        default:
+#ifdef sts_asserts
+            assert(false);
+#endif
+            break;
     }
 
-    maxCopies = new std::map<CardId, int>({
-        {CardId::OFFERING, 1},
-        {CardId::IMPERVIOUS, 99},
-        {CardId::APOTHEOSIS, 1},
-        {CardId::GHOSTLY_ARMOR, 99},
-        {CardId::PERFECTED_STRIKE, 99},
-        {CardId::WHIRLWIND, 2},
-        {CardId::BATTLE_TRANCE, 2},
-        {CardId::DEMON_FORM, 1},
-        {CardId::IMMOLATE, 1},
-        {CardId::RAGE, 2},
-        {CardId::LIMIT_BREAK, 3},
-        {CardId::FLAME_BARRIER, 2},
-        {CardId::MASTER_OF_STRATEGY, 99},
-        {CardId::INFLAME, 1},
-        {CardId::DISARM, 2},
-        {CardId::SHRUG_IT_OFF, 3},
-        {CardId::DOUBLE_TAP, 1},
-        {CardId::THUNDERCLAP, 1},
-        {CardId::METALLICIZE, 1},
-        {CardId::POMMEL_STRIKE, 1},
-        {CardId::SHOCKWAVE, 1},
-        {CardId::UPPERCUT, 1},
-        {CardId::JAX, 1},
-        {CardId::PANIC_BUTTON, 1},
-        {CardId::FLASH_OF_STEEL, 99},
-        {CardId::FLEX, 1}
+    std::sort(actions.begin(), actions.end(), [](std::pair<search::Action,CardInstance> a, std::pair<search::Action,CardInstance> b) {
+        auto pa = 2 * cardPriorityMap[static_cast<int>(a.second.id)] + (a.second.isUpgraded() ? -1 : 0);
+        auto pb = 2 * cardPriorityMap[static_cast<int>(b.second.id)] + (b.second.isUpgraded() ? -1 : 0);
+        return pa < pb;
     });
 
-    for (auto c : defensiveCards) {
-        isDefensiveCard.set(static_cast<int>(c));
-    }
+    switch (bc.cardSelectInfo.cardSelectTask) {
+        case CardSelectTask::ARMAMENTS:
+        case CardSelectTask::DUAL_WIELD:
+        case CardSelectTask::CODEX:
+        case CardSelectTask::DISCOVERY:
+        case CardSelectTask::EXHUME:
+        case CardSelectTask::FORETHOUGHT:
+        case CardSelectTask::HEADBUTT:
+        case CardSelectTask::HOLOGRAM:
+        case CardSelectTask::LIQUID_MEMORIES_POTION:
+        case CardSelectTask::NIGHTMARE:
+        case CardSelectTask::MEDITATE:
+        case CardSelectTask::SECRET_TECHNIQUE:
+        case CardSelectTask::SECRET_WEAPON:
+        case CardSelectTask::SETUP:
+        case CardSelectTask::SEEK:
+        case CardSelectTask::WARCRY:
+            takeAction(bc, actions.front().first);
+            break;
 
-    isAoeCard.set(static_cast<int>(CardId::CLEAVE));
-    isAoeCard.set(static_cast<int>(CardId::IMMOLATE));
-    isAoeCard.set(static_cast<int>(CardId::THUNDERCLAP));
-    isAoeCard.set(static_cast<int>(CardId::WHIRLWIND));
+        case CardSelectTask::EXHAUST_ONE:
+        case CardSelectTask::RECYCLE:
+            takeAction(bc, actions.back().first);
+            break;
+
+        case CardSelectTask::EXHAUST_MANY:
+        case CardSelectTask::INVALID:
+        case CardSelectTask::GAMBLE:
+        default:
+#ifdef sts_asserts
+            assert(false);
+#endif
+            break;
+    }
 }
 
+
+
 struct SimpleAgentInfo {
     bool shouldPrint;
     std::uint64_t seedStart;
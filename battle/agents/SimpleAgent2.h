@@ -25,8 +25,6 @@ namespace sts::search {
 
         bool print = false;
 
-        SimpleAgent();
-
         [[nodiscard]] int getIncomingDamage(const BattleContext &bc) const;
 
         // void playout(GameContext &gc);
@@ -7,25 +7,158 @@
 
 #include "sts_common.h"
 
+#include "combat/CardInstance.h"
+#include "combat/CardQueue.h"
+
+#include <array>
 #include <bitset>
-#include <functional>
 #include <cassert>
+#include <cstdint>
+#include <type_traits>
 
 
 namespace sts {
 
     class BattleContext;
-    typedef std::function<void (BattleContext &)> ActionFunction;
 
+    typedef std::array<std::uint16_t,5> DamageMatrix;
+
+    // selects the behaviour of an Action in Action::execute, one per factory in Actions
+    enum class ActionId : std::uint8_t {
+        NO_OP=0,
+        SET_STATE,
+
+        BUFF_PLAYER,
+        DEBUFF_PLAYER,
+        DECREMENT_STATUS,
+        REMOVE_STATUS,
+        BUFF_ENEMY,
+        DEBUFF_ENEMY,
+        DEBUFF_ALL_ENEMY,
+
+        ATTACK_ENEMY,
+        ATTACK_ALL_ENEMY,
+        ATTACK_ALL_ENEMY_MATRIX,
+        DAMAGE_ENEMY,
+        DAMAGE_ALL_ENEMY,
+        ATTACK_PLAYER,
+        DAMAGE_PLAYER,
+        VAMPIRE_ATTACK,
+        PLAYER_LOSE_HP,
+        HEAL_PLAYER,
+
+        MONSTER_GAIN_BLOCK,
+        ROLL_MOVE,
+        REACTIVE_ROLL_MOVE,
+        NO_OP_ROLL_MOVE,
+
+        GAIN_ENERGY,
+        GAIN_BLOCK,
+        DRAW_CARDS,
+        EMPTY_DECK_SHUFFLE,
+        SHUFFLE_DRAW_PILE,
+        SHUFFLE_TEMP_CARD_INTO_DRAW_PILE,
+
+        PLAY_TOP_CARD,
+        MAKE_TEMP_CARD_IN_HAND,
+        MAKE_TEMP_CARD_IN_DRAW_PILE,
+        MAKE_TEMP_CARD_IN_DISCARD,
+        DISCARD_NO_TRIGGER_CARD,
+
+        CLEAR_CARD_QUEUE,
+        DISCARD_AT_END_OF_TURN,
+        DISCARD_AT_END_OF_TURN_HELPER,
+        RESTORE_RETAINED_CARDS,
+        UNNAMED_END_OF_TURN,
+        MONSTER_START_TURN,
+        EXHAUST_TOP_CARD_IN_HAND,
+        EXHAUST_SPECIFIC_CARD_IN_HAND,
+
+        DAMAGE_RANDOM_ENEMY,
+        GAIN_BLOCK_RANDOM_ENEMY,
+        SUMMON_GREMLINS,
+        SPAWN_TORCH_HEADS,
+        SPIRE_SHIELD_DEBUFF,
+
+        EXHAUST_RANDOM_CARD_IN_HAND,
+        MADNESS,
+        RANDOMIZE_HAND_COST,
+        UPGRADE_RANDOM_CARD,
+        CODEX,
+        EXHAUST_MANY,
+        GAMBLE,
+        TOOLBOX,
+        FIEND_FIRE,
+        SWORD_BOOMERANG,
+
+        PUT_RANDOM_CARDS_IN_DRAW_PILE,
+        DISCOVERY,
+        INFERNAL_BLADE,
+        JACK_OF_ALL_TRADES,
+        TRANSMUTATION,
+        VIOLENCE,
+
+        BETTER_DISCARD_PILE_TO_HAND,
+        ARMAMENTS,
+        DUAL_WIELD,
+        EXHUME,
+        FORETHOUGHT,
+        HEADBUTT,
+        CHOOSE_EXHAUST_ONE,
+        DRAW_TO_HAND,
+        WARCRY,
+
+        TIME_EATER_PLAY_CARD_QUEUE_ITEM,
+        UPGRADE_ALL_CARDS_IN_HAND,
+        ON_AFTER_CARD_USED,
+        INCREASE_ORB_SLOTS,
+        SUICIDE,
+        REMOVE_PLAYER_DEBUFFS,
+        DUALITY,
+
+        APOTHEOSIS,
+        DROPKICK,
+        ENLIGHTENMENT,
+        ENTRENCH,
+        FEED,
+        HAND_OF_GREED,
+        LIMIT_BREAK,
+        REAPER,
+        RITUAL_DAGGER,
+        SECOND_WIND,
+        SEVER_SOUL_EXHAUST,
+        SPOT_WEAKNESS,
+        WHIRLWIND,
+        ATTACK_ALL_MONSTER_RECURSIVE,
+
+        INVALID,
+    };
+
+    // An action is plain data: an id and a small fixed payload whose meaning depends on the id.
+    // It is trivially copyable so the action queue can be copied with the BattleContext without allocating.
     struct Action {
-        ActionFunction actFunc;
+        ActionId id = ActionId::NO_OP;
         bool clearOnCombatVictory = true;
-
-        Action() = default;
-        Action(ActionFunction a) : actFunc(std::move(a)) {}
-        Action(ActionFunction a, bool b) : actFunc(std::move(a)), clearOnCombatVictory(b) {}
+        bool flag = false;
+        bool flag2 = false;
+        std::uint8_t enumValue = 0; // a PlayerStatus, MonsterStatus, CardType, etc. depending on the id
+        std::int32_t idx = 0;
+        std::int32_t amount = 0;
+
+        union {
+            DamageMatrix damageMatrix;
+            CardInstance card;
+            CardQueueItem item;
+        };
+
+        Action() : damageMatrix() {}
+        explicit Action(ActionId id, bool clearOnCombatVictory=true) : id(id), clearOnCombatVictory(clearOnCombatVictory), damageMatrix() {}
+
+        void execute(BattleContext &bc) const; // implemented in Actions.cpp
     };
 
+    static_assert(std::is_trivially_copyable_v<Action>);
+
 
     // Simple deque
     template<int capacity>
@@ -35,28 +168,13 @@ namespace sts {
         int back = 0;
         int size = 0;
         std::bitset<capacity> bits; // for the shouldClear field
-
-#ifdef sts_action_queue_use_raw_array
-        ActionFunction arr[capacity];
-        ActionQueue() = default;
-        ActionQueue(const ActionQueue &rhs) : size(rhs.size), back(rhs.back), front(rhs.front), bits(rhs.bits) {
-            int cur = rhs.front;
-            for (int i = 0; i < rhs.size; ++i) {
-                if (cur >= capacity) {
-                    cur = 0;
-                }
-                arr[cur] = rhs.arr[cur];
-            }
-        }
-#else
-        std::array<ActionFunction,capacity> arr;
-#endif
+        std::array<Action,capacity> arr;
 
         void clear();
-        void pushFront(Action a);
-        void pushBack(Action a);
+        void pushFront(const Action &a);
+        void pushBack(const Action &a);
         bool isEmpty();
-        ActionFunction popFront();
+        Action popFront();
         [[nodiscard]] int getCapacity() const;
     };
 
@@ -68,7 +186,7 @@ namespace sts {
     }
 
     template <int capacity>
-    void ActionQueue<capacity>::pushFront(Action a) {
+    void ActionQueue<capacity>::pushFront(const Action &a) {
 #ifdef sts_asserts
         assert(size != capacity);
 #endif
@@ -78,11 +196,11 @@ namespace sts {
             front = capacity-1;
         }
         bits.set(front, a.clearOnCombatVictory);
-        arr[front] = std::move(a.actFunc);
+        arr[front] = a;
     }
 
     template<int capacity>
-    void ActionQueue<capacity>::pushBack(Action a) {
+    void ActionQueue<capacity>::pushBack(const Action &a) {
 #ifdef sts_asserts
         if (size >= capacity) {
             assert(false);
@@ -92,7 +210,7 @@ namespace sts {
             back = 0;
         }
         bits.set(back, a.clearOnCombatVictory);
-        arr[back] = std::move(a.actFunc);
+        arr[back] = a;
         ++back;
         ++size;
     }
@@ -103,11 +221,11 @@ namespace sts {
     }
 
     template<int capacity>
-    ActionFunction ActionQueue<capacity>::popFront() {
+    Action ActionQueue<capacity>::popFront() {
 #ifdef sts_asserts
         assert(size > 0 );
 #endif
-        ActionFunction a = arr[front];
+        Action a = arr[front];
         ++front;
         --size;
         if (front >= capacity) {
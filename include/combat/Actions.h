@@ -6,7 +6,6 @@
 #define STS_LIGHTSPEED_ACTIONS_H
 
 #include <utility>
-#include <functional>
 #include <cstdint>
 
 #include "constants/PlayerStatusEffects.h"
@@ -25,8 +24,7 @@ namespace sts {
     class CardInstance;
     class CardQueueItem;
 
-    typedef std::array<std::uint16_t,5> DamageMatrix;
-
+    // factories for the actions queued by the BattleContext, the behaviour of each is in Action::execute
     struct Actions {
         static Action SetState(InputState state);
 
@@ -90,7 +88,6 @@ namespace sts {
         static Action MakeTempCardInHand(CardInstance c, int amount = 1);
         static Action MakeTempCardInDrawPile(const CardInstance &c, int amount, bool shuffleInto);
         static Action MakeTempCardInDiscard(const CardInstance &c, int amount = 1);
-        static Action MakeTempCardsInHand(std::vector<CardInstance> cards);
 
         static Action DiscardNoTriggerCard(); // for doubt, shame, etc, discards the BattleContext.curCard
 
@@ -7,6 +7,8 @@
 
 #include <vector>
 #include <array>
+#include <cstring>
+#include <type_traits>
 
 #include "sts_common.h"
 
@@ -45,7 +47,7 @@ namespace sts {
     struct BattleContext {
 
         // begin for debugging purposes
-        inline static int sum = 0; // for preventing optimization in benchmarks
+        inline static thread_local int sum = 0; // for preventing optimization in benchmarks, per thread since search threads execute actions
         bool haveUsedDiscoveryAction = false; // for tracking undefined behavior resulting from using the action
         bool undefinedBehaviorEvoked = false; // some cards cause inconsistent outcomes in games
         std::uint64_t seed = 0;
@@ -94,6 +96,11 @@ namespace sts {
         BattleContext() = default;
         BattleContext(const BattleContext &rhs) = default;
 
+        // BattleContext is trivially copyable, this is the fast path for snapshotting and restoring a battle
+        void clone_into(BattleContext &other) const {
+            std::memcpy(&other, this, sizeof(BattleContext));
+        }
+
 // ****************************************
 
         void init(const GameContext &gc);
@@ -212,52 +219,59 @@ namespace sts {
 
     };
 
+    static_assert(std::is_trivially_copyable_v<BattleContext>);
+
     std::ostream& operator<<(std::ostream &os, const BattleContext &bc);
 
     template <PlayerStatus s>
     Action Actions::BuffPlayer(int amount) {
-        return {[=] (BattleContext &bc) {
-            if (s == PlayerStatus::CORRUPTION && !bc.player.hasStatus<PS::CORRUPTION>()) {
-                bc.cards.onBuffCorruption();
-            }
-            bc.player.buff<s>(amount);
-        }};
+        Action a(ActionId::BUFF_PLAYER);
+        a.enumValue = static_cast<std::uint8_t>(s);
+        a.amount = amount;
+        return a;
     }
 
     template <PlayerStatus s>
     Action Actions::DebuffPlayer(int amount, bool isSourceMonster) {
-        return {[=] (BattleContext &bc) {
-            bc.player.debuff<s>(amount, isSourceMonster);
-        }};
+        Action a(ActionId::DEBUFF_PLAYER);
+        a.enumValue = static_cast<std::uint8_t>(s);
+        a.amount = amount;
+        a.flag = isSourceMonster;
+        return a;
     }
 
     template<PlayerStatus s>
     Action Actions::DecrementStatus(int amount) {
-        return {[=] (BattleContext &bc) {
-            bc.player.decrementStatus<s>(amount);
-        }};
+        Action a(ActionId::DECREMENT_STATUS);
+        a.enumValue = static_cast<std::uint8_t>(s);
+        a.amount = amount;
+        return a;
     }
 
     template <PlayerStatus s>
     Action Actions::RemoveStatus() {
-        return {[=] (BattleContext &bc) {
-            bc.player.setHasStatus<s>(false);
-        }};
+        Action a(ActionId::REMOVE_STATUS);
+        a.enumValue = static_cast<std::uint8_t>(s);
+        return a;
     }
 
     template<MonsterStatus s>
     Action Actions::BuffEnemy(int idx, int amount) {
-        return {[=] (BattleContext &bc) {
-            // todo check if alive?
-            bc.monsters.arr[idx].buff<s>(amount);
-        }};
+        Action a(ActionId::BUFF_ENEMY);
+        a.enumValue = static_cast<std::uint8_t>(s);
+        a.idx = idx;
+        a.amount = amount;
+        return a;
     }
 
     template <MonsterStatus s>
     Action Actions::DebuffEnemy(int idx, int amount, bool isSourceMonster) {
-        return {[=] (BattleContext &bc) {
-            bc.debuffEnemy<s>(idx, amount, isSourceMonster);
-        }};
+        Action a(ActionId::DEBUFF_ENEMY);
+        a.enumValue = static_cast<std::uint8_t>(s);
+        a.idx = idx;
+        a.amount = amount;
+        a.flag = isSourceMonster;
+        return a;
     }
 
     template <MonsterStatus s>
@@ -265,13 +279,11 @@ namespace sts {
         // todo this should just add all to bot immediately, not be called first
         // ^^ never mind i think adding to top is a workaround here
 
-        return {[=] (BattleContext &bc) {
-            for (int i = bc.monsters.monsterCount-1; i >= 0; --i) {
-                if (bc.monsters.arr[i].isTargetable()) {
-                    bc.addToTop(Actions::DebuffEnemy<s>(i, amount, isSourceMonster));
-                }
-            }
-        }};
+        Action a(ActionId::DEBUFF_ALL_ENEMY);
+        a.enumValue = static_cast<std::uint8_t>(s);
+        a.amount = amount;
+        a.flag = isSourceMonster;
+        return a;
     }
 
     template <MonsterStatus s>
@@ -0,0 +1,72 @@
+#ifndef STS_LIGHTSPEED_BATTLESERIALIZATION_H
+#define STS_LIGHTSPEED_BATTLESERIALIZATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sts {
+
+    struct BattleContext;
+
+    // binary encoding of a BattleContext, for checkpoints and for sending states between processes.
+    //
+    // an encoded state is a BattleStateHeader followed by the bytes of the BattleContext with runs of zeros
+    // collapsed. BattleContext is trivially copyable so every field is covered (rngs, piles, monsters, player,
+    // queues, input state), the unused slots of the piles and queues are zeroed first so they collapse.
+    // the bytes are only meaningful to a build with the same BattleContext layout, decoding checks the format
+    // version and a fingerprint of the layout and the enum counts and refuses anything else. bump the version
+    // when an enum is renumbered without changing its count (CardId, RelicId, MonsterId ...), the fingerprint
+    // can't see that. little endian hosts only.
+    // padding is encoded as it is, so a state re-encodes to the same bytes but two equal battles may not
+    static constexpr std::uint16_t BATTLE_STATE_FORMAT_VERSION = 1;
+
+    // the fixed layout start of an encoded state. the summary fields can be read in place with
+    // getBattleStateHeader, without decoding the state
+    struct alignas(8) BattleStateHeader {
+        char magic[4]; // "STSB"
+        std::uint16_t version;
+        std::uint16_t headerSize;
+        std::uint32_t layoutHash; // fingerprint of the BattleContext layout that was encoded
+        std::uint32_t payloadSize; // bytes after the header
+
+        // summary
+        std::uint64_t seed;
+        std::int32_t floorNum;
+        std::int32_t turn;
+        std::uint16_t encounter;
+        std::uint8_t outcome;
+        std::uint8_t inputState;
+        std::int16_t playerCurHp;
+        std::int16_t playerMaxHp;
+        std::int16_t playerBlock;
+        std::int16_t playerEnergy;
+        std::uint8_t monsterCount;
+        std::uint8_t monstersAlive;
+        std::uint8_t potionCount;
+        std::uint8_t cardsInHand;
+        std::uint16_t drawPileSize;
+        std::uint16_t discardPileSize;
+        std::uint16_t exhaustPileSize;
+        std::int16_t monsterCurHp[5];
+    };
+    static_assert(sizeof(BattleStateHeader) == 64);
+
+    std::uint32_t getBattleContextLayoutHash();
+
+    void encodeBattleContext(const BattleContext &bc, std::vector<std::uint8_t> &out); // appends to out
+    std::vector<std::uint8_t> encodeBattleContext(const BattleContext &bc);
+
+    // returns false and leaves bc unchanged if data isn't a complete state encoded by this format version and layout,
+    // or if a pile, queue or group size in it is beyond its capacity
+    bool decodeBattleContext(const std::uint8_t *data, std::size_t size, BattleContext &bc);
+
+    // the header of the state at data, in place. nullptr if it isn't a header of this format version, isn't
+    // 8 byte aligned or the state is incomplete. the state takes headerSize + payloadSize bytes,
+    // so encoded states can be concatenated and walked with this
+    const BattleStateHeader *getBattleStateHeader(const std::uint8_t *data, std::size_t size);
+
+}
+
+
+#endif //STS_LIGHTSPEED_BATTLESERIALIZATION_H
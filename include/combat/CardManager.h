@@ -10,6 +10,7 @@
 
 #include "sts_common.h"
 
+#include "data_structure/fixed_list.h"
 #include "combat/CardInstance.h"
 #include "game/Random.h"
 #include "game/Deck.h"
@@ -22,7 +23,7 @@ namespace sts {
     struct CardManager {
 
         static constexpr int MAX_HAND_SIZE = 10;
-        static constexpr int MAX_GROUP_SIZE = 64;
+        static constexpr int MAX_GROUP_SIZE = 128; // room for a full deck (Deck::MAX_SIZE) plus cards created in combat
 
         int nextUniqueCardId = 0; // unique card ids that are less than the masterDeckSize are non-temporary
 
@@ -31,15 +32,9 @@ namespace sts {
         std::array<CardInstance, MAX_HAND_SIZE> limbo; // used only for end of turn during discard, for retained cards
         std::array<CardInstance,2> stasisCards { CardId::INVALID, CardId::INVALID }; // for bronze automaton fight
 
-#ifdef sts_card_manager_use_fixed_list
         fixed_list<CardInstance, MAX_GROUP_SIZE> drawPile;
         fixed_list<CardInstance, MAX_GROUP_SIZE> discardPile;
         fixed_list<CardInstance, MAX_GROUP_SIZE> exhaustPile;
-#else
-        std::vector<CardInstance> drawPile;
-        std::vector<CardInstance> discardPile;
-        std::vector<CardInstance> exhaustPile;
-#endif
         int handNormalityCount = 0;
         int handPainCount = 0;
         int strikeCount = 0;
@@ -16,7 +16,7 @@
 #include <vector>
 #include <cstdint>
 #include <bitset>
-#include <map>
+#include <array>
 
 #include <constants/CharacterClasses.h>
 #include <constants/Relics.h>
@@ -31,6 +31,8 @@ namespace sts {
     class BattleContext;
 
     struct Player {
+        static constexpr int PLAYER_STATUS_COUNT = static_cast<int>(PlayerStatus::THE_BOMB)+1;
+
         CharacterClass cc;
 
         int16_t gold = 0;
@@ -56,7 +58,7 @@ namespace sts {
         std::uint32_t justAppliedBits = 0;
         std::uint64_t statusBits0 = 0;
         std::uint32_t statusBits1 = 0;
-        std::map<PlayerStatus, std::int16_t> statusMap;
+        std::array<std::int16_t, PLAYER_STATUS_COUNT> statusValues {}; // indexed by PlayerStatus, only valid when hasStatus
 
         std::uint64_t relicBits0 = 0;
         std::uint64_t relicBits1 = 0;
@@ -117,6 +119,9 @@ namespace sts {
 
         template <Stance> void changeStance();
 
+        // calls f(status, value) for each status with a set status bit, in PlayerStatus order
+        template <typename F> void forEachStatus(F f);
+
         void removeDebuffs();
         void increaseMaxHp(int amount);
         void heal(int amount);
@@ -194,8 +199,8 @@ namespace sts {
                 break;
 
             default:
-                statusMap.at(s) -= amount;
-                if (!statusMap.at(s)) {
+                statusValues[static_cast<int>(s)] -= amount;
+                if (!statusValues[static_cast<int>(s)]) {
                     setHasStatus<s>(false);
                 }
         }
@@ -222,7 +227,7 @@ namespace sts {
                 return strength;
             default:
                 if (hasStatus<s>()) {
-                    return statusMap.at(s);
+                    return statusValues[static_cast<int>(s)];
                 } else {
                     return 0;
                 }
@@ -260,6 +265,19 @@ namespace sts {
         }
     }
 
+    template <typename F>
+    void Player::forEachStatus(F f) {
+        // the bits are read once up front, f should only remove the status it was called with
+        for (auto bits = statusBits0; bits; bits &= bits-1) {
+            const int idx = __builtin_ctzll(bits);
+            f(static_cast<PlayerStatus>(idx), statusValues[idx]);
+        }
+        for (auto bits = statusBits1; bits; bits &= bits-1) {
+            const int idx = 64 + __builtin_ctz(bits);
+            f(static_cast<PlayerStatus>(idx), statusValues[idx]);
+        }
+    }
+
     template <PlayerStatus s>
     bool Player::hasStatus() const {
 //        static_assert(s != PlayerStatus::THE_BOMB);
@@ -351,10 +369,10 @@ namespace sts {
         }
 
         if (hasStatus<s>()) {
-            statusMap[s] += amount;
+            statusValues[static_cast<int>(s)] += amount;
         } else {
             setHasStatus<s>(true);
-            statusMap[s] = amount;
+            statusValues[static_cast<int>(s)] = amount;
         }
     }
 
@@ -409,9 +427,9 @@ namespace sts {
         }
 
         if (hasStatus<s>()) {
-            statusMap[s] += amount;
+            statusValues[static_cast<int>(s)] += amount;
         } else {
-            statusMap[s] = amount;
+            statusValues[static_cast<int>(s)] = amount;
         }
 
         setHasStatus<s>(true);
@@ -437,7 +455,7 @@ namespace sts {
                 break;
 
             default:
-                statusMap[s] = value;
+                statusValues[static_cast<int>(s)] = value;
         }
     }
 
@@ -5,6 +5,7 @@
 #ifndef STS_LIGHTSPEED_FIXEDLIST_H
 #define STS_LIGHTSPEED_FIXEDLIST_H
 
+#include <algorithm>
 #include <array>
 
 namespace sts {
@@ -34,6 +35,10 @@ namespace sts {
             return list_size;
         }
 
+        static constexpr int max_size() {
+            return capacity;
+        }
+
         iterator begin() {
             return arr.begin();
         }
@@ -88,7 +93,7 @@ namespace sts {
         }
 
         void insert(iterator it, T t) {
-            for (T* i = arr.end()-1; i != it; --i) {
+            for (T* i = end(); i != it; --i) {
                 *i = *(i-1);
             }
             *it = t;
@@ -131,6 +136,12 @@ namespace sts {
             list_size = size;
         }
 
+        // copies only the used elements, cheaper than assignment when the list is far from full
+        void copy_into(fixed_list &other) const {
+            other.list_size = list_size;
+            std::copy(begin(), end(), other.begin());
+        }
+
     };
 
 
@@ -172,16 +172,21 @@ namespace sts {
         Random shuffleRng;
         Random treasureRng;
 
-        // todo change these to fixed lists
-        std::vector<Event> eventList;
-        std::vector<Event> shrineList;
-        std::vector<Event> specialOneTimeEventList;
-
-        std::vector<RelicId> commonRelicPool;
-        std::vector<RelicId> uncommonRelicPool;
-        std::vector<RelicId> rareRelicPool;
-        std::vector<RelicId> shopRelicPool;
-        std::vector<RelicId> bossRelicPool;
+        // inline so a copy of the game doesn't allocate, the lists only shrink from the act and character pools
+        static constexpr int MAX_EVENT_LIST_SIZE = 16;
+        static constexpr int MAX_RELIC_POOL_SIZE = 40;
+        typedef fixed_list<Event, MAX_EVENT_LIST_SIZE> EventList;
+        typedef fixed_list<RelicId, MAX_RELIC_POOL_SIZE> RelicPool;
+
+        EventList eventList;
+        EventList shrineList;
+        EventList specialOneTimeEventList;
+
+        RelicPool commonRelicPool;
+        RelicPool uncommonRelicPool;
+        RelicPool rareRelicPool;
+        RelicPool shopRelicPool;
+        RelicPool bossRelicPool;
 
         std::array<CardId, 35> colorlessCardPool = baseColorlessPool;
 
@@ -212,7 +217,8 @@ namespace sts {
 
         int curMapNodeX = -1;
         int curMapNodeY = -1;
-        std::shared_ptr<Map> map = nullptr; // todo fix memory leak
+        // shared by copies of the game, it is replaced rather than changed so changing acts in one copy leaves the others' map alone
+        std::shared_ptr<const Map> map = nullptr;
 
         int act = 1;
         int ascension = 0;
@@ -239,6 +245,12 @@ namespace sts {
         GameContext() = default;
         GameContext(CharacterClass cc, std::uint64_t seed, int ascensionLevel);
 
+        // for lookahead, the copies are independent but share the map. assigning into a reused GameContext is the
+        // cheap path, only the relic list can allocate
+        void clone_into(GameContext &other) const {
+            other = *this;
+        }
+
         void initFromSave(const SaveFile &s);
         void initRelicsFromSave(const SaveFile &s);
 
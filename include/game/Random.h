@@ -5,6 +5,9 @@
 #ifndef STS_LIGHTSPEED_RANDOM_H
 #define STS_LIGHTSPEED_RANDOM_H
 
+#include <cstdint>
+#include <utility>
+
 namespace java {
 
     class Random {
@@ -73,6 +76,11 @@ namespace sts {
         std::uint64_t seed0;
         std::uint64_t seed1;
 
+        // nextLong(n) draws again when nextLong() >> 1 is at or above this
+        static constexpr std::uint64_t getRejectionThreshold(std::uint64_t n) {
+            return ONE_IN_MOST_SIGNIFICANT - ONE_IN_MOST_SIGNIFICANT % n;
+        }
+
         static constexpr std::uint64_t murmurHash3(std::uint64_t x) {
             x ^= x >> 33;
             x *= static_cast<std::uint64_t>(-49064778989728563LL);
@@ -139,18 +147,26 @@ namespace sts {
             seed1 = murmurHash3(seed0);
         }
 
+        // the same as targetCounter calls of random(999). a call almost always takes one nextLong, but can take more,
+        // so the generator is stepped rather than jumped. the rejection test replaces the division of nextLong(n)
         Random(std::uint64_t seed, std::int32_t targetCounter) : Random(seed) {
-            for (int i = 0; i < targetCounter; i++) {
-                random(999);
+            constexpr auto threshold = getRejectionThreshold(1000);
+            for (; counter < targetCounter; ++counter) {
+                while ((nextLong() >> 1) >= threshold) {}
             }
         }
 
+        // randomBoolean takes exactly one nextLong, so the generator is jumped
         void setCounter(int targetCounter) {
-            while (counter < targetCounter) {
-                randomBoolean();
+            if (counter < targetCounter) {
+                jump(targetCounter - counter);
+                counter = targetCounter;
             }
         }
 
+        // advances the generator as if nextLong was called steps times, counter is unchanged. O(log steps)
+        void jump(std::uint64_t steps);
+
         std::int32_t random(std::int32_t range) {
             ++counter;
             return nextInt(range + 1);
@@ -0,0 +1,52 @@
+#ifndef STS_LIGHTSPEED_BATCHRUNNER_H
+#define STS_LIGHTSPEED_BATCHRUNNER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace sts {
+
+    void pinCurrentThread(int coreIdx); // to core coreIdx % hardware_concurrency, does nothing if not on linux
+
+    struct BatchResult {
+        std::int64_t gameCount = 0;
+        std::int64_t winCount = 0;
+        std::int64_t lossCount = 0;
+        std::int64_t floorSum = 0;
+        std::int64_t simulationCount = 0;
+
+        void add(const BatchResult &rhs);
+    };
+
+    // plays a range of seeds on several threads. seeds are handed out in blocks from an atomic counter and each
+    // thread keeps its own results, so there is no lock shared between games
+    struct BatchRunner {
+        typedef std::function<void (std::uint64_t seed, BatchResult &threadResult)> PlaySeedFnc;
+
+        int threadCount = 1;
+        bool pinThreads = false; // pin thread i to core i % hardware_concurrency, linux only
+        std::uint64_t seedBlockSize = 0; // seeds taken from the counter at once, 0 to choose from the seed count
+        const std::atomic<bool> *stopFlag = nullptr; // if set, threads stop taking seeds once it's true
+
+        // results of the last run
+        BatchResult result;
+        std::vector<BatchResult> threadResults;
+        double elapsed = 0; // seconds, from when every thread is ready to when the last one finishes
+
+        BatchRunner() = default;
+        explicit BatchRunner(int threadCount, bool pinThreads=false) : threadCount(threadCount), pinThreads(pinThreads) {}
+
+        // playSeed is called concurrently, for each seed in [startSeed, startSeed+seedCount) or until stopFlag is set.
+        // gameCount counts the seeds playSeed was called for
+        const BatchResult& run(std::uint64_t startSeed, std::uint64_t seedCount, const PlaySeedFnc &playSeed);
+
+        void printThroughput(std::ostream &os) const;
+    };
+
+}
+
+
+#endif //STS_LIGHTSPEED_BATCHRUNNER_H
@@ -0,0 +1,53 @@
+#ifndef STS_LIGHTSPEED_BENCHMARK_H
+#define STS_LIGHTSPEED_BENCHMARK_H
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace sts {
+
+    // keeps the compiler from optimizing away a value that is never read
+    template <typename T>
+    inline void doNotOptimize(T &t) {
+        asm volatile("" : : "r"(&t) : "memory");
+    }
+
+    struct BenchmarkResult {
+        std::string name;
+        std::int64_t iterations = 0; // per repetition
+        std::vector<double> nsPerIteration; // one per repetition
+
+        [[nodiscard]] double minNs() const;
+        [[nodiscard]] double medianNs() const;
+        [[nodiscard]] double maxNs() const;
+    };
+
+    // a small google benchmark style runner. the body of a benchmark runs its operation a given number of times,
+    // anything it needs is set up before it is added so only the loop is timed. the iteration count is grown until
+    // one run takes minTime, then the benchmark is repeated with that count
+    struct BenchmarkRunner {
+        typedef std::function<void (std::int64_t iterations)> BenchmarkFnc;
+
+        std::string filter; // only run benchmarks with this in their name
+        double minTime = 0.2; // seconds
+        int repetitions = 5;
+        int pinCore = -1; // if >= 0, the benchmarks run on this core
+        std::uint64_t seed = 1; // recorded in the json output, the benchmarks use it to build their states
+
+        std::vector<std::pair<std::string, BenchmarkFnc>> benchmarks;
+        std::vector<BenchmarkResult> results;
+
+        void add(const std::string &name, const BenchmarkFnc &fnc);
+        const std::vector<BenchmarkResult>& run();
+
+        void printResults(std::ostream &os) const;
+        void printJson(std::ostream &os) const; // in the layout of google benchmark's --benchmark_format=json
+    };
+
+}
+
+
+#endif //STS_LIGHTSPEED_BENCHMARK_H
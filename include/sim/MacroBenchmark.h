@@ -0,0 +1,47 @@
+#ifndef STS_LIGHTSPEED_MACROBENCHMARK_H
+#define STS_LIGHTSPEED_MACROBENCHMARK_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace sts {
+
+    // the peak resident set size since the process started or the last resetPeakRss, 0 if not on linux. a workload
+    // resets it before running so its peak isn't hidden by an earlier, larger one
+    std::int64_t getPeakRssKb();
+    void resetPeakRss(); // to the current resident set size, does nothing if not on linux
+
+    // throughput of one end to end workload
+    struct MacroBenchmarkResult {
+        std::string name;
+        int threadCount = 1;
+        std::int64_t gameCount = 0; // games or battles played
+        std::int64_t simulationCount = 0; // search simulations, 0 for workloads that don't search
+        double elapsed = 0; // seconds
+        std::int64_t peakRssKb = 0; // while the workload ran
+
+        [[nodiscard]] double gamesPerSecond() const;
+        [[nodiscard]] double simulationsPerSecond() const;
+    };
+
+    // the baseline is a json file with an object per workload name holding its threads, games_per_second and
+    // simulations_per_second. a run on a different thread count is compared per thread. several programs can share
+    // one file, each only reads and writes the workloads it ran
+    struct MacroBenchmarkSuite {
+        std::vector<MacroBenchmarkResult> results;
+        double threshold = 0.1; // a workload regresses if its throughput is more than this fraction below the baseline
+
+        void add(const MacroBenchmarkResult &r);
+        void printResults(std::ostream &os) const;
+
+        // prints a line per compared workload, returns false if any regressed. workloads missing from the baseline pass
+        bool checkBaseline(const std::string &path, std::ostream &os) const;
+        void writeBaseline(const std::string &path) const; // replaces the entries of the workloads that ran
+    };
+
+}
+
+
+#endif //STS_LIGHTSPEED_MACROBENCHMARK_H
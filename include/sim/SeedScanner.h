@@ -0,0 +1,93 @@
+#ifndef STS_LIGHTSPEED_SEEDSCANNER_H
+#define STS_LIGHTSPEED_SEEDSCANNER_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "game/GameContext.h"
+
+namespace sts {
+
+    // what a new game on a seed starts with. each part comes from its own rng stream and is generated the first
+    // time it's asked for, the same way GameContext(cc, seed, ascension) generates it. a view is reused across seeds
+    // so the lists and pools keep their memory
+    class SeedView {
+    public:
+        SeedView();
+
+        void reset(CharacterClass cc, std::uint64_t seed, int ascension);
+
+        [[nodiscard]] std::uint64_t getSeed() const { return seed; }
+        [[nodiscard]] CharacterClass getCharacterClass() const { return cc; }
+        [[nodiscard]] int getAscension() const { return ascension; }
+
+        const NeowOptions &getNeowOptions(); // neowRng
+        const Map &getMap(); // the seed itself
+
+        // monsterRng
+        const fixed_list<MonsterEncounter, 16> &getMonsterList();
+        const fixed_list<MonsterEncounter, 10> &getEliteList();
+        MonsterEncounter getBoss();
+
+        // relicRng, the pools after the start of game shuffle
+        const GameContext::RelicPool &getCommonRelicPool();
+        const GameContext::RelicPool &getUncommonRelicPool();
+        const GameContext::RelicPool &getRareRelicPool();
+        const GameContext::RelicPool &getShopRelicPool();
+        const GameContext::RelicPool &getBossRelicPool();
+
+        // everything else, by constructing the whole GameContext
+        const GameContext &getGameContext();
+
+    private:
+        enum GeneratedBits : std::uint32_t {
+            NEOW = 1 << 0,
+            MAP = 1 << 1,
+            MONSTERS = 1 << 2,
+            RELICS = 1 << 3,
+            GAME_CONTEXT = 1 << 4,
+        };
+
+        CharacterClass cc = CharacterClass::IRONCLAD;
+        std::uint64_t seed = 0;
+        int ascension = 0;
+        std::uint32_t generated = 0;
+
+        NeowOptions neowOptions {};
+        Map map;
+        std::unique_ptr<GameContext> scratch; // the monster and relic generation run on this, so they share GameContext's code
+        std::unique_ptr<GameContext> gameContext;
+
+        void generateMonsters();
+        void generateRelics();
+    };
+
+    typedef std::function<bool (SeedView &view)> SeedPredicate;
+
+    struct SeedScanResult {
+        std::int64_t seedCount = 0; // the predicate was run on, fewer than scanned if the match limit stopped the scan
+        std::int64_t matchCount = 0;
+        double elapsed = 0; // seconds
+
+        [[nodiscard]] double seedsPerSecond() const;
+    };
+
+    // runs a predicate over a range of seeds on several threads with a SeedView per thread
+    struct SeedScanner {
+        typedef std::function<void (std::uint64_t seed)> MatchFnc;
+
+        int threadCount = 1;
+        bool pinThreads = false;
+        CharacterClass cc = CharacterClass::IRONCLAD;
+        int ascension = 0;
+        std::int64_t maxMatchCount = 0; // the scan stops after this many matches, 0 for no limit
+
+        // onMatch is called under a lock as each match is found, so matches arrive roughly in seed order but not exactly
+        SeedScanResult scan(std::uint64_t startSeed, std::uint64_t seedCount, const SeedPredicate &predicate, const MatchFnc &onMatch) const;
+    };
+
+}
+
+
+#endif //STS_LIGHTSPEED_SEEDSCANNER_H
@@ -34,6 +34,8 @@ namespace sts::search {
 //        ActionType actionType;
 //        int idx1;
 //        int idx2;
+        static constexpr int MAX_CARD_SELECT_ACTIONS = CardManager::MAX_GROUP_SIZE; // a select from the draw, discard or exhaust pile
+
         std::uint32_t bits = -1;
 
         Action() = default;
@@ -57,9 +59,12 @@ namespace sts::search {
         void execute(BattleContext &bc) const;
 
 
+        static void enumerateCardSelectActions(const BattleContext &bc, fixed_list<Action, MAX_CARD_SELECT_ACTIONS> &actions); // clears actions first
         static std::vector<Action> enumerateCardSelectActions(const BattleContext &bc);
     };
 
+    typedef fixed_list<Action, Action::MAX_CARD_SELECT_ACTIONS> CardSelectActionList;
+
 }
 
 
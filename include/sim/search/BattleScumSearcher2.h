@@ -6,68 +6,208 @@
 #define STS_LIGHTSPEED_BATTLESCUMSEARCHER2_H
 
 #include "sim/search/Action.h"
+#include "sim/search/SearchStats.h"
+#include "sim/search/TranspositionTable.h"
+#include "data_structure/fixed_list.h"
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <random>
 #include <iostream>
 #include <limits>
+#include <type_traits>
+#include <vector>
 
 namespace sts::search {
 
     typedef std::function<double (const BattleContext&)> EvalFnc;
 
+    // the most actions a state can have, a card select can offer every card of a pile
+    static constexpr int MAX_ACTIONS_PER_STATE = 128;
+    typedef fixed_list<Action, MAX_ACTIONS_PER_STATE> ActionList;
+
+    enum class SearchParallelism {
+        ROOT, // an independent tree per thread, the trees are merged when the search finishes
+        TREE, // one shared tree, every thread selects, expands and backs up on its own. not deterministic
+    };
+
+    // how actions are picked in the playout after a leaf of the search tree. card selects are always random
+    enum class RolloutPolicy {
+        RANDOM, // uniformly random legal actions
+        EXPERT, // the playable card first in Expert::getPlayOrdering, end turn when there is none. never uses potions
+        SIMPLE_AGENT, // the card plays SimpleAgent would make
+    };
+
+    const char *getRolloutPolicyName(RolloutPolicy policy);
+
+    // what a time budgeted search found by its deadline
+    struct AnytimeSearchResult {
+        std::int64_t simulationCount = 0; // completed by this search
+        double elapsed = 0; // seconds
+        double bestActionValue = 0;
+        int outcomePlayerHp = 0;
+        double confidence = 0; // share of the root's simulations that went through the first action of the best sequence
+        std::vector<Action> bestActionSequence;
+    };
+
     // to find a solution to a battle with tree pruning
     struct BattleScumSearcher2 {
-        class Edge;
+        static constexpr std::uint32_t ROOT_IDX = 0;
+
+        // the shape of the tree, the statistics of a node are in stats at the node's index
         struct Node {
-            std::int64_t simulationCount = 0;
-            double evaluationSum = 0;
-            std::vector<Edge> edges;
+            std::uint32_t edgeBegin = 0; // the edges of a node are contiguous in the tree arena
+            std::uint16_t edgeCount = 0;
+            std::uint16_t actionCount = 0; // legal actions in the node's state, with progressive widening only the first edgeCount have edges
+            std::uint32_t transpositionIdx = TranspositionTable::INVALID_IDX;
         };
 
         struct Edge {
             Action action;
             Node node;
         };
+        static_assert(std::is_trivially_destructible_v<Edge>); // so resetting the arena is O(1)
+
+        // the statistics of every node as a structure of arrays indexed like tree. the edges of a node are contiguous,
+        // so selection scores them from contiguous arrays
+        struct NodeStats {
+            std::vector<std::int64_t> simulationCount;
+            std::vector<double> evaluationSum;
+            std::vector<std::int32_t> virtualLoss; // playouts in flight through the node, only used by the tree parallel search
+
+            void push_back(std::int64_t simulations, double evaluation);
+            void reserve(std::size_t size);
+            void clear();
+            void swap(NodeStats &rhs);
+        };
+        static constexpr std::size_t EDGE_MEMORY = sizeof(Edge) + sizeof(std::int64_t) + sizeof(double) + sizeof(std::int32_t);
 
         std::unique_ptr<const BattleContext> rootState;
-        Node root;
+
+        // arena holding every edge of the search tree, nodes are addressed by the index of the edge leading to them.
+        // tree[ROOT_IDX] holds the root node, its action is unused
+        std::vector<Edge> tree;
+        NodeStats stats;
+        std::size_t treeMemoryLimit = std::size_t(1) << 30; // in bytes, leaves stop being expanded past this. split between the trees of a root parallel search
+
+        // when set, nodes of transposed states share their statistics for selection. only the calling thread of a root
+        // parallel search uses it so the helper threads stay deterministic, every thread of a tree parallel search does
+        std::shared_ptr<TranspositionTable> transpositionTable;
 
         EvalFnc evalFnc;
         double explorationParameter = 3*sqrt(2);
+        bool simdSelection = true; // score the edges with the AVX2 kernel if the cpu has it, the result is the same
+
+        RolloutPolicy rolloutPolicy = RolloutPolicy::RANDOM;
+        double rolloutEpsilon = 0; // chance a guided playout takes a random action instead, for an epsilon-greedy policy
+
+        // early termination, all off by default
+        bool prunePlayouts = false; // stop a playout once it can't end better than bestActionValue, it's backed up as a loss
+        bool stopOnOptimalSolution = false; // stop searching once a win loses no hp and uses no potions
+        std::int64_t stableSimulationLimit = 0; // if > 0, stop searching once a win hasn't improved for this many simulations
+
+        // progressive widening, a node with n simulations has edges for its first ceil(C * n^alpha) actions and more are
+        // added as n grows. when it is on the end turn action is moved first, the card actions follow in
+        // Expert::getPlayOrdering order. the tree parallel search adds every edge of a leaf at once and only limits selection
+        bool progressiveWidening = false;
+        double wideningConstant = 1;
+        double wideningExponent = 0.5;
+
+        // the clock is only read every DEADLINE_CHECK_INTERVAL simulations, a simulation takes microseconds
+        static constexpr int DEADLINE_CHECK_INTERVAL = 8;
+        SearchClock::time_point deadline = SearchClock::time_point::max();
+        std::int64_t deadlineCheckCount = 0;
 
         double bestActionValue = std::numeric_limits<double>::min();
         double minActionValue = std::numeric_limits<double>::max();
         int outcomePlayerHp = 0;
+        bool foundOptimalSolution = false; // nothing can beat bestActionValue, except a win in fewer turns
+        std::int64_t simulationsSinceImprovement = 0;
+        bool rootCanRecover = true; // if something from the root state can raise the player's hp or potion count
 
         std::vector<Action> bestActionSequence;
         std::default_random_engine randGen;
 
-        std::vector<Node*> searchStack;
+        SearchStats searchStats; // of the last call to search
+        std::ostream *statsLog = nullptr; // if set, every search writes its searchStats to it as a json line
+
+        std::vector<std::uint32_t> searchStack;
         std::vector<Action> actionStack;
+        std::vector<Action> actionBuffer;
+        std::unique_ptr<BattleContext> stepState; // reused by every step, constructing a BattleContext isn't free
 
         explicit BattleScumSearcher2(const BattleContext &bc, EvalFnc evalFnc=&evaluateEndState);
 
         // public methods
+        void reset(const BattleContext &bc); // keeps the memory of the tree arena
+        bool reroot(const std::vector<Action> &actionsTaken, const BattleContext &bc);
         void search(int64_t simulations);
+        void search(int64_t simulations, int threadCount, SearchParallelism parallelism=SearchParallelism::ROOT);
+        AnytimeSearchResult searchUntil(SearchClock::time_point deadline, int threadCount=1, SearchParallelism parallelism=SearchParallelism::ROOT);
+        AnytimeSearchResult searchFor(std::chrono::microseconds budget, int threadCount=1, SearchParallelism parallelism=SearchParallelism::ROOT);
+        [[nodiscard]] double getBestActionConfidence() const;
         void step();
 
+        Node &root() { return tree[ROOT_IDX].node; }
+        const Node &root() const { return tree[ROOT_IDX].node; }
+        Node &getNode(std::uint32_t idx) { return tree[idx].node; }
+        const Node &getNode(std::uint32_t idx) const { return tree[idx].node; }
+        std::int64_t getRootSimulationCount() const { return stats.simulationCount[ROOT_IDX]; }
+
+        // the statistics used for selection, shared with the transpositions of the node if it has any
+        std::int64_t getSimulationCount(std::uint32_t idx) const {
+            const auto transpositionIdx = getNode(idx).transpositionIdx;
+            return transpositionIdx == TranspositionTable::INVALID_IDX ?
+                stats.simulationCount[idx] : transpositionTable->getSimulationCount(transpositionIdx);
+        }
+        double getEvaluationSum(std::uint32_t idx) const {
+            const auto transpositionIdx = getNode(idx).transpositionIdx;
+            return transpositionIdx == TranspositionTable::INVALID_IDX ?
+                stats.evaluationSum[idx] : transpositionTable->getEvaluationSum(transpositionIdx);
+        }
+
         // private helpers
-        void updateFromPlayout(const std::vector<Node*> &stack, const std::vector<Action> &actionStack, const BattleContext &endState);
+        void searchSerial(int64_t simulations);
+        void finishSearchStats(SearchClock::time_point startTime, std::int64_t startSimulationCount);
+        void assignTransposition(std::uint32_t nodeIdx, const BattleContext &bc);
+        bool expandNode(std::uint32_t nodeIdx, const std::vector<Action> &actions, int edgeCount);
+        void appendEdge(std::uint32_t srcIdx); // copies an edge and its statistics to the end of the arena
+        void widenNode(std::uint32_t nodeIdx, const BattleContext &bc);
+        void updateFromPlayout(const std::vector<std::uint32_t> &stack, const std::vector<Action> &actionStack, const BattleContext &endState);
         [[nodiscard]] bool isTerminalState(const BattleContext &bc) const;
-
-        double evaluateEdge(const Node &parent, int edgeIdx);
-        int selectBestEdgeToSearch(const Node &cur);
-        int selectFirstActionForLeafNode(const Node &leafNode);
-
+        [[nodiscard]] bool canStopSearch();
+        [[nodiscard]] bool isPastDeadline();
+        [[nodiscard]] double getPlayoutUpperBound(const BattleContext &bc) const; // the best evaluation a playout from bc can end with
+        [[nodiscard]] bool canPrunePlayout(const BattleContext &bc) const;
+
+        double evaluateEdge(std::uint32_t parentIdx, int edgeIdx);
+        int selectBestEdgeToSearch(std::uint32_t nodeIdx);
+        [[nodiscard]] int getOpenEdgeCount(std::int64_t simulationCount, int edgeCount) const;
+        void orderLeafActions(std::vector<Action> &actions) const;
+        int selectFirstActionForLeafNode(int edgeCount);
+
+        void playout(BattleContext &state, std::vector<Action> &actionStack, std::default_random_engine &rng);
         void playoutRandom(BattleContext &state, std::vector<Action> &actionStack);
-
-        void enumerateActionsForNode(Node &node, const BattleContext &bc);
-        void enumerateCardActions(Node &node, const BattleContext &bc);
-        void enumeratePotionActions(Node &node, const BattleContext &bc);
-        void enumerateCardSelectActions(Node &node, const BattleContext &bc);
+        void playoutRandom(BattleContext &state, std::vector<Action> &actionStack, std::default_random_engine &rng);
+        void playoutGuided(BattleContext &state, std::vector<Action> &actionStack, std::default_random_engine &rng);
+
+        void searchRootParallel(int64_t simulations, int threadCount);
+        void searchTreeParallel(int64_t simulations, int threadCount);
+        void mergeSearch(BattleScumSearcher2 &other); // merges the tree and results of other, which searched the same root state
+        void mergeNode(std::uint32_t dstIdx, const BattleScumSearcher2 &other, std::uint32_t srcIdx);
+
+        // appends the legal actions of bc to actions, a std::vector<Action> or an ActionList
+        template <typename ActionContainer>
+        void enumerateActionsForNode(ActionContainer &actions, const BattleContext &bc);
+        template <typename ActionContainer>
+        void enumerateCardActions(ActionContainer &actions, const BattleContext &bc);
+        template <typename ActionContainer>
+        void enumeratePotionActions(ActionContainer &actions, const BattleContext &bc);
+        template <typename ActionContainer>
+        void enumerateCardSelectActions(ActionContainer &actions, const BattleContext &bc);
         static double evaluateEndState(const BattleContext &bc);
+        static bool canRecoverDuringBattle(const BattleContext &bc);
 
         void printSearchTree(std::ostream &os, int levels);
         void printSearchStack(std::ostream &os, bool skipLast=false);
@@ -6,6 +6,7 @@
 #define STS_LIGHTSPEED_GAMEACTION_H
 
 #include "sts_common.h"
+#include "data_structure/fixed_list.h"
 
 #include <iostream>
 #include <vector>
@@ -28,6 +29,8 @@ namespace sts::search {
             SKIP,       // 6
         };
 
+        static constexpr int MAX_ACTIONS_IN_STATE = 96; // the card select screen, one per card in the deck
+
         std::uint32_t bits = -1;
         GameAction() = default;
         GameAction(std::uint32_t bits);
@@ -49,11 +52,14 @@ namespace sts::search {
         [[nodiscard]] bool isValidAction(const sts::GameContext &gc) const;
 
         void execute(GameContext &gc) const;
+        static void getAllActionsInState(const sts::GameContext &gc, fixed_list<GameAction, MAX_ACTIONS_IN_STATE> &actions); // clears actions first
         static std::vector<GameAction> getAllActionsInState(const sts::GameContext &gc);
         static int getValidEventSelectBits(const sts::GameContext &gc);
 
     };
 
+    typedef fixed_list<GameAction, GameAction::MAX_ACTIONS_IN_STATE> GameActionList;
+
 
 
 
@@ -0,0 +1,84 @@
+#ifndef STS_LIGHTSPEED_GAMESCUMSEARCHER_H
+#define STS_LIGHTSPEED_GAMESCUMSEARCHER_H
+
+#include "game/GameContext.h"
+#include "sim/search/GameAction.h"
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace sts::search {
+
+    struct SimpleAgent;
+
+    // mcts over the out of combat decisions of a game: map paths, rewards, shops, events, neow and boss relics.
+    // the battles between two decisions are played by SimpleAgent as part of the transition, so like the battle
+    // searcher it relies on the game's rng making every transition deterministic. rollouts play SimpleAgent's out of
+    // combat policy, with rolloutEpsilon random actions, until the end of the act
+    struct GameScumSearcher {
+        static constexpr std::uint32_t INVALID_IDX = -1;
+
+        struct Edge {
+            GameAction action;
+            std::uint32_t childIdx = INVALID_IDX;
+            std::int64_t simulationCount = 0;
+            double evaluationSum = 0;
+        };
+
+        struct Node {
+            GameContext state; // at the decision, with the battles before it played
+            std::vector<Edge> edges;
+            std::int64_t simulationCount = 0;
+        };
+
+        // nodes[0] is the root
+        std::vector<Node> nodes;
+
+        // the search looks until the end of horizonAct, the act after the root's if the root is past its act's boss
+        int horizonAct = 1;
+        int rootFloor = 0;
+
+        double explorationParameter = std::sqrt(2.0);
+        double rolloutEpsilon = 0.1; // chance a rollout takes a random action instead of SimpleAgent's
+        int maxRolloutSteps = 2000; // out of combat actions, in case a policy gets stuck on a screen
+        std::default_random_engine rng;
+
+        // of the last call to search
+        std::int64_t simulationCount = 0;
+        std::int64_t battleCount = 0; // played by SimpleAgent, in transitions and rollouts
+        double elapsed = 0; // seconds
+
+        explicit GameScumSearcher(const GameContext &gc);
+
+        // public interface
+        void search(std::int64_t simulations, int threadCount=1);
+        [[nodiscard]] int getBestEdgeIdx() const; // the most simulated action of the root
+        [[nodiscard]] GameAction getBestAction() const;
+        [[nodiscard]] double getEdgeValue(const Edge &edge) const; // mean evaluation, 0 if not simulated
+        void printRootEdges(std::ostream &os) const;
+
+        // the value of an end state: half for the floors climbed towards the horizon, the other half for the hp left
+        // if the player reached it
+        [[nodiscard]] double evaluateEndState(const GameContext &gc) const;
+        [[nodiscard]] bool isTerminalState(const GameContext &gc) const;
+
+        // private helpers
+        void searchSerial(std::int64_t simulations);
+        void searchRootParallel(std::int64_t simulations, int threadCount);
+        void mergeRoot(const GameScumSearcher &other); // adds the root statistics of other, which searched the same root state
+        void simulate(SimpleAgent &agent, std::vector<std::pair<std::uint32_t, int>> &path, GameContext &rolloutState);
+        std::uint32_t addNode(GameContext &&gc);
+        int selectEdge(const Node &node) const;
+
+        void playBattles(GameContext &gc, SimpleAgent &agent); // until the next out of combat decision
+        bool stepRollout(GameContext &gc, SimpleAgent &agent);
+        void rollout(GameContext &gc, SimpleAgent &agent);
+    };
+
+}
+
+
+#endif //STS_LIGHTSPEED_GAMESCUMSEARCHER_H
@@ -9,15 +9,19 @@
 #include "sim/search/Action.h"
 #include "sim/search/GameAction.h"
 
+#include <chrono>
+#include <iostream>
 #include <memory>
 #include <random>
 
 namespace sts::search {
 
     class BattleScumSearcher2;
+    enum class SearchParallelism;
+    enum class RolloutPolicy;
 
     struct ScumSearchAgent2 {
-        std::int64_t simulationCountTotal;
+        std::int64_t simulationCountTotal = 0;
         std::vector<int> gameActionHistory;
 
         int stepCount = 0;
@@ -32,6 +36,24 @@ namespace sts::search {
         int stepsNoSolution = 5;
         int stepsWithSolution = 15;
 
+        bool reuseSearchTree = true; // keep the subtree under the actions taken since the last search
+        int searchThreadCount = 1;
+        SearchParallelism searchParallelism {};
+        RolloutPolicy rolloutPolicy {};
+        double rolloutEpsilon = 0;
+        bool progressiveWidening = false;
+
+        // prune playouts and stop a search early once its win is optimal, or hasn't improved for
+        // stableSimulationFraction of the simulation target, so easy fights take fewer simulations
+        bool earlyTermination = false;
+        double stableSimulationFraction = 0.25;
+
+        // if > 0, neow, boss relic and card reward choices are made by a GameScumSearcher with this many simulations
+        std::int64_t gameSimulationCount = 0;
+
+        std::chrono::microseconds searchTimeBudget {0}; // if > 0, each search runs this long instead of to the simulation target
+        std::ostream *searchStatsLog = nullptr; // if set, the stats of every search are written to it as json lines
+
         std::default_random_engine rng;
 
 
@@ -44,10 +66,11 @@ namespace sts::search {
         void takeAction(GameContext &gc, GameAction a);
         void takeAction(BattleContext &bc, Action a);
 
-        void stepThroughSolution(BattleContext &bc, std::vector<search::Action> &actions);
-        void stepThroughSearchTree(BattleContext &bc, const search::BattleScumSearcher2 &s);
+        void stepThroughSolution(BattleContext &bc, std::vector<search::Action> &actions, std::vector<search::Action> &actionsTaken);
+        void stepThroughSearchTree(BattleContext &bc, const search::BattleScumSearcher2 &s, std::vector<search::Action> &actionsTaken);
 
         void stepOutOfCombatPolicy(GameContext &gc);
+        bool stepGameSearch(GameContext &gc); // returns whether a search made the decision
         void cardSelectPolicy(GameContext &gc);
         void stepEventPolicy(GameContext &gc);
         void stepRandom(GameContext &gc);
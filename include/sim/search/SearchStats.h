@@ -0,0 +1,70 @@
+#ifndef STS_LIGHTSPEED_SEARCHSTATS_H
+#define STS_LIGHTSPEED_SEARCHSTATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+namespace sts::search {
+
+    typedef std::chrono::steady_clock SearchClock;
+
+    // profile of one search. the per simulation counters and phase times are only collected when built with
+    // sts_search_stats, without it only the totals filled in once per search are set
+#ifdef sts_search_stats
+    static constexpr bool SEARCH_STATS_ENABLED = true;
+#else
+    static constexpr bool SEARCH_STATS_ENABLED = false;
+#endif
+
+    struct SearchStats {
+        std::int64_t simulationCount = 0;
+        double elapsed = 0; // seconds of wall time
+
+        // the tree when the search finished
+        std::int64_t nodeCount = 0;
+        std::size_t treeMemory = 0; // bytes reserved for the tree arena and the node statistics
+
+        // per simulation, with sts_search_stats
+        std::int64_t rolloutLengthSum = 0; // actions taken in playouts, after the leaf of the tree
+        std::int64_t maxRolloutLength = 0;
+        std::int64_t treeDepthSum = 0; // edges from the root to the leaf a simulation expanded or ended at
+        std::int64_t maxTreeDepth = 0;
+        std::int64_t executeActionsLoopCount = 0; // iterations of BattleContext::executeActions over all simulations
+
+        // seconds spent in each phase, summed over the threads searching
+        double selectionTime = 0; // walking down the tree, including executing the actions on the path
+        double expansionTime = 0; // enumerating the leaf's actions and adding its edges
+        double rolloutTime = 0;
+        double backpropTime = 0;
+
+        void addSimulation(std::int64_t treeDepth, std::int64_t rolloutLength, std::int64_t executeActionsLoops);
+        void add(const SearchStats &rhs); // counters and phase times of another searcher of the same search
+
+        [[nodiscard]] double simulationsPerSecond() const;
+        [[nodiscard]] double meanRolloutLength() const;
+        [[nodiscard]] double meanTreeDepth() const;
+
+        void printJson(std::ostream &os) const; // a single line
+    };
+
+    // splits the time of a simulation between the phases, every lap adds the time since the last one.
+    // compiles to nothing without sts_search_stats
+    struct SearchPhaseTimer {
+#ifdef sts_search_stats
+        SearchClock::time_point last = SearchClock::now();
+
+        void lap(double &seconds) {
+            const auto now = SearchClock::now();
+            seconds += std::chrono::duration<double>(now - last).count();
+            last = now;
+        }
+#else
+        void lap(double &) {}
+#endif
+    };
+
+}
+
+
+#endif //STS_LIGHTSPEED_SEARCHSTATS_H
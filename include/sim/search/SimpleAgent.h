@@ -15,15 +15,15 @@ namespace sts::search {
     struct SimpleAgent {
 
         std::vector<int> actionHistory;
-        GameContext *curGameContext; // unsafe only use in private methods during playout
+        GameContext *curGameContext = nullptr; // unsafe only use in private methods during playout
 
         fixed_list<int,16> mapPath;
 
         bool print = false;
 
-        SimpleAgent();
-
+        [[nodiscard]] int getAct(const BattleContext &bc) const;
         [[nodiscard]] int getIncomingDamage(const BattleContext &bc) const;
+        [[nodiscard]] Action getBattleCardPlayAction(const BattleContext &bc) const; // the action stepBattleCardPlay takes
 
         void playout(GameContext &gc);
 
@@ -43,7 +43,7 @@ namespace sts::search {
 
         bool playPotion(BattleContext &bc);
         static fixed_list<int,16> getBestMapPathForWeights(const Map &m, const int *weights);
-        static void runAgentsMt(int threadCount, std::uint64_t startSeed, int playoutCount, bool print);
+        static void runAgentsMt(int threadCount, std::uint64_t startSeed, int playoutCount, bool print, bool pinThreads=false);
 
         // static void myRunAgentMt(int threadCount, std::uint64_t startSeed, int playoutCount, bool print);
     };
@@ -0,0 +1,52 @@
+#ifndef STS_LIGHTSPEED_TRANSPOSITIONTABLE_H
+#define STS_LIGHTSPEED_TRANSPOSITIONTABLE_H
+
+#include "sts_common.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace sts {
+    class BattleContext;
+}
+
+namespace sts::search {
+
+    // Zobrist style hash of the parts of a battle that decide its future: player, monsters, card piles, rng counters.
+    // the hand, discard and exhaust piles are hashed as multisets, so play orderings that only differ in the order
+    // of those piles are transpositions
+    std::uint64_t getBattleStateHash(const BattleContext &bc);
+
+    // fixed size open addressing table of simulation statistics shared by the nodes of transposed states,
+    // safe to use from several searches at once
+    class TranspositionTable {
+    public:
+        static constexpr std::uint32_t INVALID_IDX = -1;
+
+        explicit TranspositionTable(int sizeLog2=20);
+
+        std::uint32_t findOrInsert(std::uint64_t hash); // returns INVALID_IDX if the table is too full
+        void update(std::uint32_t idx, double evaluation);
+
+        [[nodiscard]] std::int64_t getSimulationCount(std::uint32_t idx) const;
+        [[nodiscard]] double getEvaluationSum(std::uint32_t idx) const;
+        [[nodiscard]] std::size_t size() const { return mask+1; }
+
+    private:
+        static constexpr int MAX_PROBES = 32;
+
+        struct Entry {
+            std::atomic<std::uint64_t> key {0}; // 0 is empty
+            std::atomic<std::int64_t> simulationCount {0};
+            std::atomic<double> evaluationSum {0};
+        };
+
+        std::unique_ptr<Entry[]> entries;
+        std::uint64_t mask;
+    };
+
+}
+
+
+#endif //STS_LIGHTSPEED_TRANSPOSITIONTABLE_H
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <filesystem>
@@ -256,6 +257,42 @@ inline std::vector<GameContext> loadScenariosFromDirectory(const std::string& di
     return gameContexts;
 }
 
+// Loads the raw scenario files, sorted by file name so batch runs see them in a stable order.
+// Scenarios without a name are named after their file
+inline std::vector<nlohmann::json> loadScenarioJsonFromDirectory(const std::string& directoryPath) {
+    std::vector<std::filesystem::path> paths;
+    try {
+        for (const auto& entry : std::filesystem::directory_iterator(directoryPath)) {
+            if (entry.path().extension() == ".json") {
+                paths.push_back(entry.path());
+            }
+        }
+    } catch (const std::exception& e) {
+        return {};
+    }
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<nlohmann::json> scenarios;
+    for (const auto& path : paths) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            continue;
+        }
+
+        nlohmann::json scenario;
+        try {
+            file >> scenario;
+        } catch (const std::exception& e) {
+            continue;
+        }
+        if (!scenario.contains("name")) {
+            scenario["name"] = path.stem().string();
+        }
+        scenarios.push_back(std::move(scenario));
+    }
+    return scenarios;
+}
+
 // Snapshot formatting helper functions
 
 inline bool isAttackCard(CardId id) {
@@ -6,146 +6,206 @@
 #include "combat/BattleContext.h"
 #include "game/Game.h"
 
+#include <utility>
+
 using namespace sts;
 
 Action Actions::SetState(InputState state) {
-    return {[=] (BattleContext &bc) {
-        bc.setState(state);
-    }};
+    Action a(ActionId::SET_STATE);
+    a.enumValue = static_cast<std::uint8_t>(state);
+    return a;
+}
+
+static void setState(BattleContext &bc, const Action &a) {
+    bc.setState(static_cast<InputState>(a.enumValue));
 }
 
 Action Actions::AttackEnemy(int idx, int damage) {
-    return {[=] (BattleContext &bc) {
-        if (bc.monsters.arr[idx].isDeadOrEscaped()) {
-            return;
-        }
+    Action a(ActionId::ATTACK_ENEMY);
+    a.idx = idx;
+    a.amount = damage;
+    return a;
+}
 
-        bc.monsters.arr[idx].attacked(bc, damage);
-        bc.checkCombat();
-    }};
+static void attackEnemy(BattleContext &bc, const Action &a) {
+    if (bc.monsters.arr[a.idx].isDeadOrEscaped()) {
+        return;
+    }
+
+    bc.monsters.arr[a.idx].attacked(bc, a.amount);
+    bc.checkCombat();
 }
 
 Action Actions::AttackAllEnemy(int baseDamage) {
-    return {[=] (BattleContext &bc) {
-        // assume bc.curCard is the card being used
+    Action a(ActionId::ATTACK_ALL_ENEMY);
+    a.amount = baseDamage;
+    return a;
+}
 
-        int damageMatrix[5];
-        for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-            if (!bc.monsters.arr[i].isDeadOrEscaped()) {
-                damageMatrix[i] = bc.calculateCardDamage(bc.curCardQueueItem.card, i, baseDamage);
-            }
+static void attackAllEnemy(BattleContext &bc, const Action &a) {
+    // assume bc.curCard is the card being used
+
+    int damageMatrix[5];
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        if (!bc.monsters.arr[i].isDeadOrEscaped()) {
+            damageMatrix[i] = bc.calculateCardDamage(bc.curCardQueueItem.card, i, a.amount);
         }
+    }
 
-        for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-            if (!bc.monsters.arr[i].isDeadOrEscaped()) {
-                bc.monsters.arr[i].attacked(bc, damageMatrix[i]);
-            }
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        if (!bc.monsters.arr[i].isDeadOrEscaped()) {
+            bc.monsters.arr[i].attacked(bc, damageMatrix[i]);
         }
+    }
 
-        bc.checkCombat();
-    }};
+    bc.checkCombat();
 }
 
 Action Actions::AttackAllEnemy(DamageMatrix damageMatrix) {
-    return {[=] (BattleContext &bc) {
-        // assume bc.curCard is the card being used
+    Action a(ActionId::ATTACK_ALL_ENEMY_MATRIX);
+    a.damageMatrix = damageMatrix;
+    return a;
+}
 
-        for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-            if (!bc.monsters.arr[i].isDeadOrEscaped()) {
-                bc.monsters.arr[i].attacked(bc, static_cast<int>(damageMatrix[i]));
-            }
+static void attackAllEnemyMatrix(BattleContext &bc, const Action &a) {
+    // assume bc.curCard is the card being used
+
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        if (!bc.monsters.arr[i].isDeadOrEscaped()) {
+            bc.monsters.arr[i].attacked(bc, static_cast<int>(a.damageMatrix[i]));
         }
+    }
 
-        bc.checkCombat();
-    }};
+    bc.checkCombat();
 }
 
 Action Actions::DamageEnemy(int idx, int damage) {
-    return {[=] (BattleContext &bc) {
-        if (bc.monsters.arr[idx].isDeadOrEscaped()) {
-            return;
-        }
+    Action a(ActionId::DAMAGE_ENEMY);
+    a.idx = idx;
+    a.amount = damage;
+    return a;
+}
 
-        bc.monsters.arr[idx].damage(bc, damage);
-        bc.checkCombat();
-    }};
+static void damageEnemy(BattleContext &bc, const Action &a) {
+    if (bc.monsters.arr[a.idx].isDeadOrEscaped()) {
+        return;
+    }
+
+    bc.monsters.arr[a.idx].damage(bc, a.amount);
+    bc.checkCombat();
 }
 
 Action Actions::DamageAllEnemy(int damage) { // todo this is probably broken
-    return {[=] (BattleContext &bc) {
-        for (int idx = 0; idx < bc.monsters.monsterCount; idx++) {
-            if (!bc.monsters.arr[idx].isDeadOrEscaped()) {
-                bc.monsters.arr[idx].damage(bc, damage); // possible should addToBot here todo
-            }
+    Action a(ActionId::DAMAGE_ALL_ENEMY);
+    a.amount = damage;
+    return a;
+}
+
+static void damageAllEnemy(BattleContext &bc, const Action &a) {
+    for (int idx = 0; idx < bc.monsters.monsterCount; idx++) {
+        if (!bc.monsters.arr[idx].isDeadOrEscaped()) {
+            bc.monsters.arr[idx].damage(bc, a.amount); // possible should addToBot here todo
         }
-        bc.checkCombat();
-    }};
+    }
+    bc.checkCombat();
 }
 
 Action Actions::AttackPlayer(int idx, int damage) {
-    return {[=] (BattleContext &bc) {
-        bc.player.attacked(bc, idx, damage);
-    }, false};
+    Action a(ActionId::ATTACK_PLAYER, false);
+    a.idx = idx;
+    a.amount = damage;
+    return a;
+}
+
+static void attackPlayer(BattleContext &bc, const Action &a) {
+    bc.player.attacked(bc, a.idx, a.amount);
 }
 
 Action Actions::DamagePlayer(int damage, bool selfDamage) {
-    return {[=] (BattleContext &bc) {
-        bc.player.damage(bc, damage, selfDamage);
-    }, false};
+    Action a(ActionId::DAMAGE_PLAYER, false);
+    a.amount = damage;
+    a.flag = selfDamage;
+    return a;
+}
+
+static void damagePlayer(BattleContext &bc, const Action &a) {
+    bc.player.damage(bc, a.amount, a.flag);
 }
 
 Action Actions::VampireAttack(int damage) {
-    return {[=] (BattleContext &bc) {
-        const auto mIdx = 0;
-        auto &m = bc.monsters.arr[mIdx]; // only used by shelled parasite so idx is 0
-        bc.player.attacked(bc, mIdx, damage);
-        if (m.isAlive()) {
-            m.heal(std::min(damage, static_cast<int>(bc.player.lastAttackUnblockedDamage)));
-        }
-    }};
+    Action a(ActionId::VAMPIRE_ATTACK);
+    a.amount = damage;
+    return a;
+}
+
+static void vampireAttack(BattleContext &bc, const Action &a) {
+    const auto mIdx = 0;
+    auto &m = bc.monsters.arr[mIdx]; // only used by shelled parasite so idx is 0
+    bc.player.attacked(bc, mIdx, a.amount);
+    if (m.isAlive()) {
+        m.heal(std::min(a.amount, static_cast<int>(bc.player.lastAttackUnblockedDamage)));
+    }
 }
 
 Action Actions::PlayerLoseHp(int hp, bool selfDamage) { // TODO this doesn't take into account intangible or relics
-    return {[=] (BattleContext &bc) {
-        bc.player.loseHp(bc, hp, selfDamage);
-    }, false};
+    Action a(ActionId::PLAYER_LOSE_HP, false);
+    a.amount = hp;
+    a.flag = selfDamage;
+    return a;
+}
+
+static void playerLoseHp(BattleContext &bc, const Action &a) {
+    bc.player.loseHp(bc, a.amount, a.flag);
 }
 
 Action Actions::HealPlayer(int amount) {
-    return {[=] (BattleContext &bc) {
-        bc.player.heal(amount);
-    }, false};
+    Action a(ActionId::HEAL_PLAYER, false);
+    a.amount = amount;
+    return a;
+}
+
+static void healPlayer(BattleContext &bc, const Action &a) {
+    bc.player.heal(a.amount);
 }
 
 Action Actions::MonsterGainBlock(int idx, int amount) {
-    return {[=] (BattleContext &bc) {
-        bc.monsters.arr[idx].block += amount;
-    }};
+    Action a(ActionId::MONSTER_GAIN_BLOCK);
+    a.idx = idx;
+    a.amount = amount;
+    return a;
+}
+
+static void monsterGainBlock(BattleContext &bc, const Action &a) {
+    bc.monsters.arr[a.idx].block += a.amount;
 }
 
 Action Actions::RollMove(int monsterIdx) {
-    return {[=] (BattleContext &bc) {
-        Monster &m = bc.monsters.arr[monsterIdx];
-        m.rollMove(bc);
-    }};
+    Action a(ActionId::ROLL_MOVE);
+    a.idx = monsterIdx;
+    return a;
+}
+
+static void rollMove(BattleContext &bc, const Action &a) {
+    Monster &m = bc.monsters.arr[a.idx];
+    m.rollMove(bc);
 }
 
 Action Actions::ReactiveRollMove() {
-    return {[=] (BattleContext &bc) {
-        // writhing mass is always monster 0
-        Monster &m = bc.monsters.arr[0];
+    return Action(ActionId::REACTIVE_ROLL_MOVE);
+}
 
-        for (int i = 0 ; i < m.getStatus<MS::REACTIVE>(); ++i) {
-            m.rollMove(bc);
-        }
-        m.setStatus<MS::REACTIVE>(0);
-    }};
+static void reactiveRollMove(BattleContext &bc, const Action &a) {
+    // writhing mass is always monster 0
+    Monster &m = bc.monsters.arr[0];
+
+    for (int i = 0 ; i < m.getStatus<MS::REACTIVE>(); ++i) {
+        m.rollMove(bc);
+    }
+    m.setStatus<MS::REACTIVE>(0);
 }
 
 Action Actions::NoOpRollMove() {
-    return {[=] (BattleContext &bc) {
-        bc.noOpRollMove();
-    }};
+    return Action(ActionId::NO_OP_ROLL_MOVE);
 }
 
 Action Actions::ChangeStance(Stance stance) {
@@ -153,15 +213,15 @@ Action Actions::ChangeStance(Stance stance) {
 }
 
 Action Actions::GainEnergy(int amount) {
-    return {[=] (BattleContext &bc) {
-        bc.player.gainEnergy(amount);
-    }};
+    Action a(ActionId::GAIN_ENERGY);
+    a.amount = amount;
+    return a;
 }
 
 Action Actions::GainBlock(int amount) {
-    return {[=] (BattleContext &bc) {
-        bc.player.gainBlock(bc, amount);
-    }, false};
+    Action a(ActionId::GAIN_BLOCK, false);
+    a.amount = amount;
+    return a;
 }
 //
 //Action Actions::GainBlockFromCard(int amount) {
@@ -173,47 +233,56 @@ Action Actions::GainBlock(int amount) {
 //}
 
 Action Actions::DrawCards(int amount) {
-    return {[=] (BattleContext &bc) {
-        bc.drawCards(amount);
-    }};
+    Action a(ActionId::DRAW_CARDS);
+    a.amount = amount;
+    return a;
 }
 
 Action Actions::EmptyDeckShuffle() {
-    return {[=] (BattleContext &bc) {
-        java::Collections::shuffle(
-                bc.cards.discardPile.begin(),
-                bc.cards.discardPile.end(),
-                java::Random(bc.shuffleRng.randomLong())
-        );
+    return Action(ActionId::EMPTY_DECK_SHUFFLE);
+}
+
+static void emptyDeckShuffle(BattleContext &bc, const Action &a) {
+    java::Collections::shuffle(
+            bc.cards.discardPile.begin(),
+            bc.cards.discardPile.end(),
+            java::Random(bc.shuffleRng.randomLong())
+    );
 
-        bc.cards.moveDiscardPileIntoToDrawPile();
-    }};
+    bc.cards.moveDiscardPileIntoToDrawPile();
 }
 
 Action Actions::ShuffleDrawPile() {
-    return {[=] (BattleContext &bc) {
-        java::Collections::shuffle(
-                bc.cards.drawPile.begin(),
-                bc.cards.drawPile.end(),
-                java::Random(bc.shuffleRng.randomLong())
-        );
-    }};
+    return Action(ActionId::SHUFFLE_DRAW_PILE);
+}
+
+static void shuffleDrawPile(BattleContext &bc, const Action &a) {
+    java::Collections::shuffle(
+            bc.cards.drawPile.begin(),
+            bc.cards.drawPile.end(),
+            java::Random(bc.shuffleRng.randomLong())
+    );
 }
 
 Action Actions::ShuffleTempCardIntoDrawPile(CardId id, int count) {
-    return {[=] (BattleContext &bc) {
-        CardInstance c(id);
-        for (int i = 0; i < count; ++i) {
-            const int idx = bc.cards.drawPile.empty() ? 0 : bc.cardRandomRng.random(static_cast<int>(bc.cards.drawPile.size()-1));
-            bc.cards.createTempCardInDrawPile(idx, c);
-        }
-    }};
+    Action a(ActionId::SHUFFLE_TEMP_CARD_INTO_DRAW_PILE);
+    a.card = CardInstance(id);
+    a.amount = count;
+    return a;
+}
+
+static void shuffleTempCardIntoDrawPile(BattleContext &bc, const Action &a) {
+    for (int i = 0; i < a.amount; ++i) {
+        const int idx = bc.cards.drawPile.empty() ? 0 : bc.cardRandomRng.random(static_cast<int>(bc.cards.drawPile.size()-1));
+        bc.cards.createTempCardInDrawPile(idx, a.card);
+    }
 }
 
 Action Actions::PlayTopCard(int monsterTargetIdx, bool exhausts) {
-    return {[=](BattleContext &bc) {
-        bc.playTopCardInDrawPile(monsterTargetIdx, exhausts);
-    }};
+    Action a(ActionId::PLAY_TOP_CARD);
+    a.idx = monsterTargetIdx;
+    a.flag = exhausts;
+    return a;
 }
 
 
@@ -226,79 +295,80 @@ Action Actions::MakeTempCardInHand(CardId card, bool upgraded, int amount) {
 
 Action Actions::MakeTempCardInHand(CardInstance card, int amount) {
     // todo master reality when the action is created
-    return {[=](BattleContext &bc) {
-        for (int i = 0; i < amount; ++i) {
-            CardInstance c(card);
-            c.uniqueId = bc.cards.nextUniqueCardId++;
-            bc.cards.notifyAddCardToCombat(c);
-            bc.moveToHandHelper(c);
-        }
-    }};
+    Action a(ActionId::MAKE_TEMP_CARD_IN_HAND);
+    a.card = card;
+    a.amount = amount;
+    return a;
+}
+
+static void makeTempCardInHand(BattleContext &bc, const Action &a) {
+    for (int i = 0; i < a.amount; ++i) {
+        CardInstance c(a.card);
+        c.uniqueId = bc.cards.nextUniqueCardId++;
+        bc.cards.notifyAddCardToCombat(c);
+        bc.moveToHandHelper(c);
+    }
 }
 
 Action Actions::MakeTempCardInDrawPile(const CardInstance &c, int amount, bool shuffleInto) {
     // the random calculation is done in an effect so it be wrong to do it here?
-    return {[=](BattleContext &bc) {
-        for (int i = 0; i < amount; ++i) {
-            if (shuffleInto) {
-                const int idx = bc.cards.drawPile.empty() ? 0 : bc.cardRandomRng.random(static_cast<int>(bc.cards.drawPile.size()-1));
-                bc.cards.createTempCardInDrawPile(idx, c);
-            }
-            // todo else
+    Action a(ActionId::MAKE_TEMP_CARD_IN_DRAW_PILE);
+    a.card = c;
+    a.amount = amount;
+    a.flag = shuffleInto;
+    return a;
+}
+
+static void makeTempCardInDrawPile(BattleContext &bc, const Action &a) {
+    for (int i = 0; i < a.amount; ++i) {
+        if (a.flag) {
+            const int idx = bc.cards.drawPile.empty() ? 0 : bc.cardRandomRng.random(static_cast<int>(bc.cards.drawPile.size()-1));
+            bc.cards.createTempCardInDrawPile(idx, a.card);
         }
-    }};
+        // todo else
+    }
 }
 
 Action Actions::MakeTempCardInDiscard(const CardInstance &c, int amount) {
-    CardInstance c_copy(c);
-    return {[=](BattleContext &bc) { // todo maybe store by reference instead of copy if CardInstance is too big to fit directly in the lambda. Make a seperate space where the card will be stored
-        for (int i = 0; i < amount; ++i) {
-            bc.cards.createTempCardInDiscard(c_copy);
-        }
-    }};
+    Action a(ActionId::MAKE_TEMP_CARD_IN_DISCARD);
+    a.card = c;
+    a.amount = amount;
+    return a;
 }
 
-Action Actions::MakeTempCardsInHand(std::vector<CardInstance> cards) {
-    return {[=](BattleContext &bc) {
-        for (auto c : cards) {
-            c.uniqueId = bc.cards.nextUniqueCardId++;
-            bc.cards.notifyAddCardToCombat(c);
-            bc.moveToHandHelper(c);
-        }
-    }};
+static void makeTempCardInDiscard(BattleContext &bc, const Action &a) {
+    for (int i = 0; i < a.amount; ++i) {
+        bc.cards.createTempCardInDiscard(a.card);
+    }
 }
 
 
 Action Actions::DiscardNoTriggerCard() {
-    return {[](BattleContext &bc) {
-        const auto &c = bc.curCardQueueItem.card;
-        bc.cards.notifyRemoveFromHand(c);
-        bc.cards.moveToDiscardPile(c);
-    }};
+    return Action(ActionId::DISCARD_NO_TRIGGER_CARD);
+}
+
+static void discardNoTriggerCard(BattleContext &bc, const Action &a) {
+    const auto &c = bc.curCardQueueItem.card;
+    bc.cards.notifyRemoveFromHand(c);
+    bc.cards.moveToDiscardPile(c);
 }
 
 Action Actions::ClearCardQueue() {
-    return {[](BattleContext &bc) {
-        bc.cardQueue.clear();
-    }};
+    return Action(ActionId::CLEAR_CARD_QUEUE);
 }
 
 Action Actions::DiscardAtEndOfTurn() {
-    return {[] (BattleContext &bc) {
-        bc.discardAtEndOfTurn();
-    }};
+    return Action(ActionId::DISCARD_AT_END_OF_TURN);
 }
 
 Action Actions::DiscardAtEndOfTurnHelper() {
-    return {[] (BattleContext &bc) {
-        bc.discardAtEndOfTurnHelper();
-    }};
+    return Action(ActionId::DISCARD_AT_END_OF_TURN_HELPER);
 }
 
 Action Actions::RestoreRetainedCards(int count) {
-    return {[=] (BattleContext &bc) {
-        bc.restoreRetainedCards(count);
-    }};
+    Action a(ActionId::RESTORE_RETAINED_CARDS);
+    a.amount = count;
+    return a;
 }
 
 Action Actions::UnnamedEndOfTurnAction() {
@@ -307,399 +377,465 @@ Action Actions::UnnamedEndOfTurnAction() {
     //        this.turnHasEnded = true;
     //        playerHpLastTurn = AbstractDungeon.player.currentHealth;
 
-    return {[=] (BattleContext &bc) {
-        bc.turnHasEnded = true;
-        if (!bc.skipMonsterTurn) {
-            bc.addToBot(Actions::MonsterStartTurnAction());
-            bc.monsterTurnIdx = 0; // monstergroup preincrements this
-        }
-    }};
+    return Action(ActionId::UNNAMED_END_OF_TURN);
+}
+
+static void unnamedEndOfTurnAction(BattleContext &bc, const Action &a) {
+    bc.turnHasEnded = true;
+    if (!bc.skipMonsterTurn) {
+        bc.addToBot(Actions::MonsterStartTurnAction());
+        bc.monsterTurnIdx = 0; // monstergroup preincrements this
+    }
 }
 
 Action Actions::MonsterStartTurnAction() {
-    return {[] (BattleContext &bc) {
-        bc.monsters.applyPreTurnLogic(bc);
-    }};
+    return Action(ActionId::MONSTER_START_TURN);
 }
 
 Action Actions::TriggerEndOfTurnOrbsAction() {
-    return {[] (BattleContext &bc) {
-        // todo
-    }};
+    // todo
+    return Action(ActionId::NO_OP);
 }
 
 Action Actions::ExhaustTopCardInHand() {
-    return {[=] (BattleContext &bc) {
-        bc.exhaustTopCardInHand();
-    }};
+    return Action(ActionId::EXHAUST_TOP_CARD_IN_HAND);
 }
 
 Action Actions::ExhaustSpecificCardInHand(int idx, std::int16_t uniqueId) {
-    return {[=] (BattleContext &bc) {
-        bc.exhaustSpecificCardInHand(idx, uniqueId);
-    }};
+    Action a(ActionId::EXHAUST_SPECIFIC_CARD_IN_HAND);
+    a.idx = idx;
+    a.amount = uniqueId;
+    return a;
 }
 
 Action Actions::DamageRandomEnemy(int damage) {
-    return {[=] (BattleContext &bc) {
-        const int idx = bc.monsters.getRandomMonsterIdx(bc.cardRandomRng, true);
-        if (idx == -1) {
-            return;
-        }
-        bc.monsters.arr[idx].damage(bc, damage);
-        bc.checkCombat();
-    }};
+    Action a(ActionId::DAMAGE_RANDOM_ENEMY);
+    a.amount = damage;
+    return a;
+}
+
+static void damageRandomEnemy(BattleContext &bc, const Action &a) {
+    const int idx = bc.monsters.getRandomMonsterIdx(bc.cardRandomRng, true);
+    if (idx == -1) {
+        return;
+    }
+    bc.monsters.arr[idx].damage(bc, a.amount);
+    bc.checkCombat();
 }
 
 Action Actions::ExhaustRandomCardInHand(int count) {
-    return {[=] (BattleContext &bc) {
-        for (int i = 0; i < count; ++i) {
-            if (bc.cards.cardsInHand <= 0) {
-                return;
-            }
-            const auto idx = bc.cards.getRandomCardIdxInHand(bc.cardRandomRng);
-            auto c = bc.cards.hand[idx];
-            bc.cards.removeFromHandAtIdx(idx);
-            bc.triggerAndMoveToExhaustPile(c);
+    Action a(ActionId::EXHAUST_RANDOM_CARD_IN_HAND);
+    a.amount = count;
+    return a;
+}
+
+static void exhaustRandomCardInHand(BattleContext &bc, const Action &a) {
+    for (int i = 0; i < a.amount; ++i) {
+        if (bc.cards.cardsInHand <= 0) {
+            return;
         }
-    }};
+        const auto idx = bc.cards.getRandomCardIdxInHand(bc.cardRandomRng);
+        auto c = bc.cards.hand[idx];
+        bc.cards.removeFromHandAtIdx(idx);
+        bc.triggerAndMoveToExhaustPile(c);
+    }
 }
 
 Action Actions::MadnessAction() {
-    return {[=] (BattleContext &bc) {
+    return Action(ActionId::MADNESS);
+}
 
-        bool haveNonZeroCost = false;
-        bool haveNonZeroTurnCost = false;
-        for (int i = 0; i < bc.cards.cardsInHand; ++i) {
-            const auto &c = bc.cards.hand[i];
+static void madnessAction(BattleContext &bc, const Action &a) {
 
-            if (c.costForTurn > 0) {
-                haveNonZeroTurnCost = true;
-                break;
-            }
+    bool haveNonZeroCost = false;
+    bool haveNonZeroTurnCost = false;
+    for (int i = 0; i < bc.cards.cardsInHand; ++i) {
+        const auto &c = bc.cards.hand[i];
 
-            if (c.cost > 0) {
-                haveNonZeroCost = true;
-            }
+        if (c.costForTurn > 0) {
+            haveNonZeroTurnCost = true;
+            break;
         }
 
-        const auto haveValidCard = haveNonZeroCost || haveNonZeroTurnCost;
-        if (!haveValidCard) {
-            return;
+        if (c.cost > 0) {
+            haveNonZeroCost = true;
         }
+    }
+
+    const auto haveValidCard = haveNonZeroCost || haveNonZeroTurnCost;
+    if (!haveValidCard) {
+        return;
+    }
 
-        // always have 1 or more cards in hand here
+    // always have 1 or more cards in hand here
 //#pragma clang diagnostic push
 //#pragma ide diagnostic ignored "EndlessLoop"
-        while (true) {
-            const auto randomIdx = bc.cardRandomRng.random(bc.cards.cardsInHand-1);
-            auto &c = bc.cards.hand[randomIdx];
-
-            if (haveNonZeroTurnCost) {
-                if (c.costForTurn > 0) {
-                    c.cost = 0;
-                    c.costForTurn = 0;
-                    break;
-                } else {
-                    continue;
-                }
+    while (true) {
+        const auto randomIdx = bc.cardRandomRng.random(bc.cards.cardsInHand-1);
+        auto &c = bc.cards.hand[randomIdx];
 
+        if (haveNonZeroTurnCost) {
+            if (c.costForTurn > 0) {
+                c.cost = 0;
+                c.costForTurn = 0;
+                break;
             } else {
-                if (c.cost > 0) {
-                    c.cost = 0;
-                    c.costForTurn = 0;
-                    break;
-
-                } else {
-                    continue;
-                }
+                continue;
+            }
+
+        } else {
+            if (c.cost > 0) {
+                c.cost = 0;
+                c.costForTurn = 0;
+                break;
+
+            } else {
+                continue;
             }
         }
+    }
 //#pragma clang diagnostic pop
 
-    }};
 }
 
 Action Actions::RandomizeHandCost() {
-    return {[=] (BattleContext &bc) {
-        for (int i = 0; i < bc.cards.cardsInHand; ++i) {
-            auto &c = bc.cards.hand[i];
-            if (c.cost >= 0) {
-                int newCost = bc.cardRandomRng.random(3);
-                c.cost = newCost;
-                c.costForTurn = newCost;
-            }
+    return Action(ActionId::RANDOMIZE_HAND_COST);
+}
+
+static void randomizeHandCost(BattleContext &bc, const Action &a) {
+    for (int i = 0; i < bc.cards.cardsInHand; ++i) {
+        auto &c = bc.cards.hand[i];
+        if (c.cost >= 0) {
+            int newCost = bc.cardRandomRng.random(3);
+            c.cost = newCost;
+            c.costForTurn = newCost;
         }
-    }};
+    }
 }
 
 Action Actions::GainBlockRandomEnemy(int sourceMonster, int amount) {
-    return {[=] (BattleContext &bc) {
-        int validIdxs[5];
-        int validCount = 0;
-
-        for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-            const auto &m = bc.monsters.arr[i];
-            if (i != sourceMonster && !m.isDying()) {
-                validIdxs[validCount++] = i;
-            }
-        }
+    Action a(ActionId::GAIN_BLOCK_RANDOM_ENEMY);
+    a.idx = sourceMonster;
+    a.amount = amount;
+    return a;
+}
 
-        int targetIdx;
-        if (validCount > 0) {
-            targetIdx = validIdxs[bc.aiRng.random(validCount - 1)];
-        } else {
-            targetIdx = sourceMonster;
+static void gainBlockRandomEnemy(BattleContext &bc, const Action &a) {
+    const int sourceMonster = a.idx;
+    int validIdxs[5];
+    int validCount = 0;
+
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        const auto &m = bc.monsters.arr[i];
+        if (i != sourceMonster && !m.isDying()) {
+            validIdxs[validCount++] = i;
         }
+    }
 
-        bc.monsters.arr[targetIdx].addBlock(amount);
-    }};
+    int targetIdx;
+    if (validCount > 0) {
+        targetIdx = validIdxs[bc.aiRng.random(validCount - 1)];
+    } else {
+        targetIdx = sourceMonster;
+    }
+
+    bc.monsters.arr[targetIdx].addBlock(a.amount);
 }
 
 Action Actions::SummonGremlins() {
     // gremlin leader searches in the order 1, 2, 0 for open space
-
-    return {[=] (BattleContext &bc) {
-        int openIdxCount = 0;
-        int newGremlinIdxs[2];
-        if (bc.monsters.arr[1].isDying()) {
-            newGremlinIdxs[openIdxCount++] = 1;
-        }
-        if (bc.monsters.arr[2].isDying()) {
-            newGremlinIdxs[openIdxCount++] = 2;
-        }
-        if (openIdxCount < 2 && bc.monsters.arr[0].isDying()) {
-            newGremlinIdxs[openIdxCount++] = 0;
-        }
+    return Action(ActionId::SUMMON_GREMLINS);
+}
+
+static void summonGremlins(BattleContext &bc, const Action &a) {
+    int openIdxCount = 0;
+    int newGremlinIdxs[2];
+    if (bc.monsters.arr[1].isDying()) {
+        newGremlinIdxs[openIdxCount++] = 1;
+    }
+    if (bc.monsters.arr[2].isDying()) {
+        newGremlinIdxs[openIdxCount++] = 2;
+    }
+    if (openIdxCount < 2 && bc.monsters.arr[0].isDying()) {
+        newGremlinIdxs[openIdxCount++] = 0;
+    }
 #ifdef sts_asserts
-        assert(openIdxCount == 2);
+    assert(openIdxCount == 2);
 #endif
 
-        auto &gremlin0 = bc.monsters.arr[newGremlinIdxs[0]];
-        auto &gremlin1 = bc.monsters.arr[newGremlinIdxs[1]];
+    auto &gremlin0 = bc.monsters.arr[newGremlinIdxs[0]];
+    auto &gremlin1 = bc.monsters.arr[newGremlinIdxs[1]];
 
-        gremlin0 = Monster();
-        gremlin1 = Monster();
+    gremlin0 = Monster();
+    gremlin1 = Monster();
 
-        gremlin0.construct(bc, MonsterGroup::getGremlin(bc.aiRng), newGremlinIdxs[0]);
-        gremlin1.construct(bc, MonsterGroup::getGremlin(bc.aiRng), newGremlinIdxs[1]);
-        bc.monsters.monstersAlive += 2;
+    gremlin0.construct(bc, MonsterGroup::getGremlin(bc.aiRng), newGremlinIdxs[0]);
+    gremlin1.construct(bc, MonsterGroup::getGremlin(bc.aiRng), newGremlinIdxs[1]);
+    bc.monsters.monstersAlive += 2;
 
-        if (bc.player.hasRelic<R::PHILOSOPHERS_STONE>()) {
-            gremlin0.buff<MS::STRENGTH>(1);
-            gremlin1.buff<MS::STRENGTH>(1);
-        }
-        gremlin0.buff<MS::MINION>();
-        gremlin1.buff<MS::MINION>();
+    if (bc.player.hasRelic<R::PHILOSOPHERS_STONE>()) {
+        gremlin0.buff<MS::STRENGTH>(1);
+        gremlin1.buff<MS::STRENGTH>(1);
+    }
+    gremlin0.buff<MS::MINION>();
+    gremlin1.buff<MS::MINION>();
 
-        gremlin0.rollMove(bc);
-        gremlin1.rollMove(bc);
-    }};
+    gremlin0.rollMove(bc);
+    gremlin1.rollMove(bc);
 }
 
 Action Actions::SpawnTorchHeads() {
-    return {[=] (BattleContext &bc) {
-        const auto spawnCount = 3-bc.monsters.monstersAlive;
+    return Action(ActionId::SPAWN_TORCH_HEADS);
+}
+
+static void spawnTorchHeads(BattleContext &bc, const Action &a) {
+    const auto spawnCount = 3-bc.monsters.monstersAlive;
 #ifdef sts_asserts
-        assert(spawnCount > 0);
+    assert(spawnCount > 0);
 #endif
-        const int spawnIdxs[2] {(bc.monsters.arr[1].isDying() ? 1 : 0), 0};
-
-        for (int i = 0; i < spawnCount; ++i) {
-            const auto idx = spawnIdxs[i];
-            auto &torchHead = bc.monsters.arr[idx];
-            torchHead = Monster();
-            torchHead.construct(bc, MonsterId::TORCH_HEAD, idx);
-            torchHead.initHp(bc.monsterHpRng, bc.ascension); // bug somewhere in game
-            torchHead.setMove(MMID::TORCH_HEAD_TACKLE);
-            torchHead.buff<MS::MINION>();
-
-            if (bc.player.hasRelic<R::PHILOSOPHERS_STONE>()) {
-                torchHead.buff<MS::STRENGTH>(1);
-            }
-            ++bc.monsters.monstersAlive;
-        }
+    const int spawnIdxs[2] {(bc.monsters.arr[1].isDying() ? 1 : 0), 0};
 
-        for (int i = 0; i < spawnCount; ++i) {
-            bc.noOpRollMove();
+    for (int i = 0; i < spawnCount; ++i) {
+        const auto idx = spawnIdxs[i];
+        auto &torchHead = bc.monsters.arr[idx];
+        torchHead = Monster();
+        torchHead.construct(bc, MonsterId::TORCH_HEAD, idx);
+        torchHead.initHp(bc.monsterHpRng, bc.ascension); // bug somewhere in game
+        torchHead.setMove(MMID::TORCH_HEAD_TACKLE);
+        torchHead.buff<MS::MINION>();
+
+        if (bc.player.hasRelic<R::PHILOSOPHERS_STONE>()) {
+            torchHead.buff<MS::STRENGTH>(1);
         }
-    }};
+        ++bc.monsters.monstersAlive;
+    }
+
+    for (int i = 0; i < spawnCount; ++i) {
+        bc.noOpRollMove();
+    }
 }
 
 Action Actions::SpireShieldDebuff() {
-    return {[] (BattleContext &bc) {
-        if (bc.aiRng.randomBoolean()) {
-            bc.player.debuff<PS::FOCUS>(-1);
-        } else {
-            bc.player.debuff<PS::STRENGTH>(-1);
-        }
-    }};
+    return Action(ActionId::SPIRE_SHIELD_DEBUFF);
+}
+
+static void spireShieldDebuff(BattleContext &bc, const Action &a) {
+    if (bc.aiRng.randomBoolean()) {
+        bc.player.debuff<PS::FOCUS>(-1);
+    } else {
+        bc.player.debuff<PS::STRENGTH>(-1);
+    }
 }
 
 
 Action Actions::OnAfterCardUsed() {
-    return {[] (BattleContext &bc) {
-        bc.onAfterUseCard();
-    }, false};
+    return Action(ActionId::ON_AFTER_CARD_USED, false);
 }
 
 Action Actions::PutRandomCardsInDrawPile(CardType type, int count) {
-    return {[=] (BattleContext &bc) {
-        CardId ids[5];
-        for (int i = 0; i < count; ++i) {
-            ids[i] = getTrulyRandomCardInCombat(bc.cardRandomRng, bc.player.cc, type);
-        }
+    Action a(ActionId::PUT_RANDOM_CARDS_IN_DRAW_PILE);
+    a.enumValue = static_cast<std::uint8_t>(type);
+    a.amount = count;
+    return a;
+}
 
-        for (int i = 0; i < count; ++i) {
-            CardInstance card(ids[i], false);
-            card.cost = 0;
-            card.costForTurn = 0;
+static void putRandomCardsInDrawPile(BattleContext &bc, const Action &a) {
+    const auto type = static_cast<CardType>(a.enumValue);
+    const auto count = a.amount;
 
-            const int idx = bc.cards.drawPile.empty() ? 0 : bc.cardRandomRng.random(static_cast<int>(bc.cards.drawPile.size()-1));
-            bc.cards.createTempCardInDrawPile(idx, card);
-        }
-    }};
+    CardId ids[5];
+    for (int i = 0; i < count; ++i) {
+        ids[i] = getTrulyRandomCardInCombat(bc.cardRandomRng, bc.player.cc, type);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        CardInstance card(ids[i], false);
+        card.cost = 0;
+        card.costForTurn = 0;
+
+        const int idx = bc.cards.drawPile.empty() ? 0 : bc.cardRandomRng.random(static_cast<int>(bc.cards.drawPile.size()-1));
+        bc.cards.createTempCardInDrawPile(idx, card);
+    }
 }
 
 Action Actions::DiscoveryAction(CardType type, int amount) {
-    return {[=] (BattleContext &bc) {
-        bc.haveUsedDiscoveryAction = true;
-        bc.openDiscoveryScreen(sts::generateDiscoveryCards(bc.cardRandomRng, bc.player.cc, type), amount);
-    }};
+    Action a(ActionId::DISCOVERY);
+    a.enumValue = static_cast<std::uint8_t>(type);
+    a.amount = amount;
+    return a;
+}
+
+static void discoveryAction(BattleContext &bc, const Action &a) {
+    const auto type = static_cast<CardType>(a.enumValue);
+    bc.haveUsedDiscoveryAction = true;
+    bc.openDiscoveryScreen(sts::generateDiscoveryCards(bc.cardRandomRng, bc.player.cc, type), a.amount);
 }
 
 Action Actions::InfernalBladeAction() {
-    return {[=] (BattleContext &bc) {
-        const auto cid = getTrulyRandomCardInCombat(bc.cardRandomRng, bc.player.cc, CardType::ATTACK);
-        CardInstance c(cid);
-        c.setCostForTurn(0);
-        bc.addToTop( Actions::MakeTempCardInHand(c) );
-    }};
+    return Action(ActionId::INFERNAL_BLADE);
 }
 
-Action Actions::JackOfAllTradesAction(bool upgraded) {
-    return {[=] (BattleContext &bc) {
-        const auto c1 = sts::getTrulyRandomColorlessCardInCombat(bc.cardRandomRng);
-        bc.addToTop( Actions::MakeTempCardInHand(c1) );
-        if (upgraded) {
-            auto c2 = sts::getTrulyRandomColorlessCardInCombat(bc.cardRandomRng);
-            bc.addToTop( Actions::MakeTempCardInHand(c2) );
-        }
-    }};
+static void infernalBladeAction(BattleContext &bc, const Action &a) {
+    const auto cid = getTrulyRandomCardInCombat(bc.cardRandomRng, bc.player.cc, CardType::ATTACK);
+    CardInstance c(cid);
+    c.setCostForTurn(0);
+    bc.addToTop( Actions::MakeTempCardInHand(c) );
 }
 
-Action Actions::TransmutationAction(bool upgraded, int energy, bool useEnergy) {
-    return {[=] (BattleContext &bc) {
-        const auto effectAmount = energy + (bc.player.hasRelic<R::CHEMICAL_X>() ? 2 : 0);
+Action Actions::JackOfAllTradesAction(bool upgraded) {
+    Action a(ActionId::JACK_OF_ALL_TRADES);
+    a.flag = upgraded;
+    return a;
+}
 
-        if (effectAmount == 0) {
-            return;
-        }
+static void jackOfAllTradesAction(BattleContext &bc, const Action &a) {
+    const auto c1 = sts::getTrulyRandomColorlessCardInCombat(bc.cardRandomRng);
+    bc.addToTop( Actions::MakeTempCardInHand(c1) );
+    if (a.flag) {
+        auto c2 = sts::getTrulyRandomColorlessCardInCombat(bc.cardRandomRng);
+        bc.addToTop( Actions::MakeTempCardInHand(c2) );
+    }
+}
 
-        std::vector<CardInstance> cards;
-       for (int i = 0; i < effectAmount; ++i) {
-           const auto cid = sts::getTrulyRandomColorlessCardInCombat(bc.cardRandomRng);
-           CardInstance c(cid, upgraded);
-           c.setCostForTurn(0);
-           cards.push_back(c);
-       }
-       bc.addToBot( Actions::MakeTempCardsInHand(cards) );
+Action Actions::TransmutationAction(bool upgraded, int energy, bool useEnergy) {
+    Action a(ActionId::TRANSMUTATION);
+    a.flag = upgraded;
+    a.amount = energy;
+    a.flag2 = useEnergy;
+    return a;
+}
+
+static void transmutationAction(BattleContext &bc, const Action &a) {
+    const bool upgraded = a.flag;
+    const bool useEnergy = a.flag2;
+    const auto effectAmount = a.amount + (bc.player.hasRelic<R::CHEMICAL_X>() ? 2 : 0);
+
+    if (effectAmount == 0) {
+        return;
+    }
+
+    // the game queues one MakeTempCardInHandAction per card
+    for (int i = 0; i < effectAmount; ++i) {
+        const auto cid = sts::getTrulyRandomColorlessCardInCombat(bc.cardRandomRng);
+        CardInstance c(cid, upgraded);
+        c.setCostForTurn(0);
+        bc.addToBot( Actions::MakeTempCardInHand(c) );
+    }
 
-       if (useEnergy) {
-           bc.player.useEnergy(bc.player.energy);
-       }
-    }};
+    if (useEnergy) {
+        bc.player.useEnergy(bc.player.energy);
+    }
 }
 
 Action Actions::ViolenceAction(int count) { // todo a faster algorithm for inserting into the attack list
-    return {[=] (BattleContext &bc) {
-        fixed_list<int,CardManager::MAX_GROUP_SIZE> attackIdxList;
-        for (int i = 0; i < bc.cards.drawPile.size(); ++i) {
-            const auto &c = bc.cards.drawPile[i];
-            if (c.getType() == CardType::ATTACK) {
-
-                if (attackIdxList.empty()) {
-                    attackIdxList.push_back(i);
-                } else {
-                    const auto randomIdx = bc.cardRandomRng.random(attackIdxList.size() - 1);
-                    attackIdxList.insert(randomIdx, i);
-                }
+    Action a(ActionId::VIOLENCE);
+    a.amount = count;
+    return a;
+}
+
+static void violenceAction(BattleContext &bc, const Action &a) {
+    const auto count = a.amount;
+
+    fixed_list<int,CardManager::MAX_GROUP_SIZE> attackIdxList;
+    for (int i = 0; i < bc.cards.drawPile.size(); ++i) {
+        const auto &c = bc.cards.drawPile[i];
+        if (c.getType() == CardType::ATTACK) {
+
+            if (attackIdxList.empty()) {
+                attackIdxList.push_back(i);
+            } else {
+                const auto randomIdx = bc.cardRandomRng.random(attackIdxList.size() - 1);
+                attackIdxList.insert(randomIdx, i);
             }
         }
+    }
+
+    if (attackIdxList.empty()) {
+        return;
+    }
 
-        if (attackIdxList.empty()) {
+    int removeIdxs[4];
+    // hack to do this faster: the attackList is just pushed forward by i so we skip removing from bottom
+    int i = 0;
+    for (; i < count; ++i) {
+        if (attackIdxList.size()-i <= 0) {
             return;
         }
 
-        int removeIdxs[4];
-        // hack to do this faster: the attackList is just pushed forward by i so we skip removing from bottom
-        int i = 0;
-        for (; i < count; ++i) {
-            if (attackIdxList.size()-i <= 0) {
-                return;
-            }
-
-            java::Collections::shuffle(attackIdxList.begin()+i, attackIdxList.end(), java::Random(bc.shuffleRng.randomLong()));
-            const auto removeIdx = attackIdxList[i];
-            removeIdxs[i] = removeIdx;
+        java::Collections::shuffle(attackIdxList.begin()+i, attackIdxList.end(), java::Random(bc.shuffleRng.randomLong()));
+        const auto removeIdx = attackIdxList[i];
+        removeIdxs[i] = removeIdx;
 
-            const auto &c = bc.cards.drawPile[removeIdx];
-            if (bc.cards.cardsInHand == 10) {
-                bc.cards.moveToDiscardPile(c);
-            } else {
-                bc.cards.moveToHand(c);
-            }
+        const auto &c = bc.cards.drawPile[removeIdx];
+        if (bc.cards.cardsInHand == 10) {
+            bc.cards.moveToDiscardPile(c);
+        } else {
+            bc.cards.moveToHand(c);
         }
+    }
 
-        std::sort(removeIdxs, removeIdxs+i);
-        for (int x = i-1; x >= 0; --x) {
-            const auto drawPileRemoveIdx = removeIdxs[x];
-            bc.cards.removeFromDrawPileAtIdx(drawPileRemoveIdx);
-        }
+    std::sort(removeIdxs, removeIdxs+i);
+    for (int x = i-1; x >= 0; --x) {
+        const auto drawPileRemoveIdx = removeIdxs[x];
+        bc.cards.removeFromDrawPileAtIdx(drawPileRemoveIdx);
+    }
 
-    }};
 }
 
 // todo the amount should be the copies put into the hand 2 if have sacred bark and liquid memories
 Action Actions::BetterDiscardPileToHandAction(int amount, CardSelectTask task) {
-    return {[=] (BattleContext &bc) {
-        if (bc.cards.discardPile.empty()) {
-            return;
-        }
-        if (bc.cards.discardPile.size() == 1) {
-            const int idx = 0;
-            bc.chooseDiscardToHandCard(0, task==CardSelectTask::LIQUID_MEMORIES_POTION);
-        } else {
-            bc.openSimpleCardSelectScreen(task, 1);
-        }
-    }};
+    Action a(ActionId::BETTER_DISCARD_PILE_TO_HAND);
+    a.amount = amount;
+    a.enumValue = static_cast<std::uint8_t>(task);
+    return a;
+}
+
+static void betterDiscardPileToHandAction(BattleContext &bc, const Action &a) {
+    const auto task = static_cast<CardSelectTask>(a.enumValue);
+    if (bc.cards.discardPile.empty()) {
+        return;
+    }
+    if (bc.cards.discardPile.size() == 1) {
+        const int idx = 0;
+        bc.chooseDiscardToHandCard(0, task==CardSelectTask::LIQUID_MEMORIES_POTION);
+    } else {
+        bc.openSimpleCardSelectScreen(task, 1);
+    }
 }
 
 Action Actions::ArmamentsAction() {
-    return {[=] (BattleContext &bc) {
-        int canUpgradeCount = 0;
-        int lastUpgradeIdx = 0;
-        for (int i = 0; i < bc.cards.cardsInHand; ++i) {
-            if (bc.cards.hand[i].canUpgrade()) {
-                ++canUpgradeCount;
-                lastUpgradeIdx = i;
-            }
+    return Action(ActionId::ARMAMENTS);
+}
+
+static void armamentsAction(BattleContext &bc, const Action &a) {
+    int canUpgradeCount = 0;
+    int lastUpgradeIdx = 0;
+    for (int i = 0; i < bc.cards.cardsInHand; ++i) {
+        if (bc.cards.hand[i].canUpgrade()) {
+            ++canUpgradeCount;
+            lastUpgradeIdx = i;
         }
+    }
 
-        if (canUpgradeCount == 0) {
-            // do nothing
+    if (canUpgradeCount == 0) {
+        // do nothing
 
-        } else if (canUpgradeCount == 1) {
-            bc.cards.hand[lastUpgradeIdx].upgrade();
+    } else if (canUpgradeCount == 1) {
+        bc.cards.hand[lastUpgradeIdx].upgrade();
 
-        } else {
-            bc.openSimpleCardSelectScreen(CardSelectTask::ARMAMENTS, 1);
-        }
-    }};
+    } else {
+        bc.openSimpleCardSelectScreen(CardSelectTask::ARMAMENTS, 1);
+    }
 }
 
 Action Actions::DualWieldAction(int copyCount) {
-    return {[=] (BattleContext &bc) {
+    Action a(ActionId::DUAL_WIELD);
+    a.amount = copyCount;
+    return a;
+}
+
+static void dualWieldAction(BattleContext &bc, const Action &a) {
+    const auto copyCount = a.amount;
 
 //        fixed_list<CardInstance, 10> validCards;
 //        fixed_list<CardInstance, 10> invalidCards;
@@ -714,80 +850,86 @@ Action Actions::DualWieldAction(int copyCount) {
 //            }
 //        }
 
-        int validCount = 0;
-        int lastValidIdx = 0;
+    int validCount = 0;
+    int lastValidIdx = 0;
 
-        for (int i = 0; i < bc.cards.cardsInHand; ++i) {
-            const bool valid = bc.cards.hand[i].getType() == CardType::ATTACK || bc.cards.hand[i].getType() == CardType::POWER;
-            if (valid) {
-                ++validCount;
-                lastValidIdx = i;
-            }
+    for (int i = 0; i < bc.cards.cardsInHand; ++i) {
+        const bool valid = bc.cards.hand[i].getType() == CardType::ATTACK || bc.cards.hand[i].getType() == CardType::POWER;
+        if (valid) {
+            ++validCount;
+            lastValidIdx = i;
         }
+    }
 
-        if (validCount == 0) {
-            return;
-        }
+    if (validCount == 0) {
+        return;
+    }
 
-        if (validCount == 1) {
-            for (int i = 0; i < copyCount; ++i) {
-                auto c = bc.cards.hand[lastValidIdx];
-                if (bc.cards.cardsInHand + 1 <= CardManager::MAX_HAND_SIZE) {
-                    bc.cards.createTempCardInHand(c);
+    if (validCount == 1) {
+        for (int i = 0; i < copyCount; ++i) {
+            auto c = bc.cards.hand[lastValidIdx];
+            if (bc.cards.cardsInHand + 1 <= CardManager::MAX_HAND_SIZE) {
+                bc.cards.createTempCardInHand(c);
 
-                } else {
-                    bc.cards.createTempCardInDiscard(c);
+            } else {
+                bc.cards.createTempCardInDiscard(c);
 
-                }
             }
+        }
 
-        } else {
-            bc.inputState = InputState::CARD_SELECT;
-            bc.cardSelectInfo.cardSelectTask = CardSelectTask::DUAL_WIELD;
-            bc.cardSelectInfo.dualWield_CopyCount() = copyCount;
+    } else {
+        bc.inputState = InputState::CARD_SELECT;
+        bc.cardSelectInfo.cardSelectTask = CardSelectTask::DUAL_WIELD;
+        bc.cardSelectInfo.dualWield_CopyCount() = copyCount;
 
-        }
+    }
 
 
-    }};
 }
 
 Action Actions::ExhumeAction() { // todo this is bugged because the selected card cannot be exhume
-    return {[=] (BattleContext &bc) {
-        if (bc.cards.exhaustPile.empty() || bc.cards.cardsInHand == 10) {
-            return;
-        }
+    return Action(ActionId::EXHUME);
+}
 
-        int nonExhumeCards = 0;
-        int lastNonExhumeIdx = -1;
-        for (int i = 0; i < bc.cards.exhaustPile.size(); ++i) {
-            if (bc.cards.exhaustPile[i].id != CardId::EXHUME) {
-                ++nonExhumeCards;
-                lastNonExhumeIdx = i;
-            }
+static void exhumeAction(BattleContext &bc, const Action &a) {
+    if (bc.cards.exhaustPile.empty() || bc.cards.cardsInHand == 10) {
+        return;
+    }
+
+    int nonExhumeCards = 0;
+    int lastNonExhumeIdx = -1;
+    for (int i = 0; i < bc.cards.exhaustPile.size(); ++i) {
+        if (bc.cards.exhaustPile[i].id != CardId::EXHUME) {
+            ++nonExhumeCards;
+            lastNonExhumeIdx = i;
         }
+    }
 
-        if (nonExhumeCards == 0) {
-            return;
+    if (nonExhumeCards == 0) {
+        return;
 
-        } else if (nonExhumeCards == 1) {
-            bc.chooseExhumeCard(lastNonExhumeIdx);
+    } else if (nonExhumeCards == 1) {
+        bc.chooseExhumeCard(lastNonExhumeIdx);
 
-        } else {
-            bc.cardSelectInfo.cardSelectTask = CardSelectTask::EXHUME;
-            bc.inputState = InputState::CARD_SELECT;
-        }
+    } else {
+        bc.cardSelectInfo.cardSelectTask = CardSelectTask::EXHUME;
+        bc.inputState = InputState::CARD_SELECT;
+    }
 
-    }};
 }
 
 Action Actions::ForethoughtAction(bool upgraded) {
-    return {[=] (BattleContext &bc) {
-        if (bc.cards.cardsInHand == 0) {
-            return;
-        }
+    Action a(ActionId::FORETHOUGHT);
+    a.flag = upgraded;
+    return a;
+}
+
+static void forethoughtAction(BattleContext &bc, const Action &a) {
+    if (bc.cards.cardsInHand == 0) {
+        return;
+    }
 
-        // todo implement Upgraded version
+    // todo implement Upgraded version
 //        //
 //        if (upgraded) {
 //            bc.cardSelectInfo.cardSelectTask = CardSelectTask::FORETHOUGHT;
@@ -795,115 +937,133 @@ Action Actions::ForethoughtAction(bool upgraded) {
 //            bc.inputState = InputState::CARD_SELECT;
 //
 //        } else {
-        if (bc.cards.cardsInHand == 1) {
-            bc.chooseForethoughtCard(0);
-        } else {
-            bc.cardSelectInfo.cardSelectTask = CardSelectTask::FORETHOUGHT;
-            bc.cardSelectInfo.canPickAnyNumber = false;
-            bc.inputState = InputState::CARD_SELECT;
-        }
+    if (bc.cards.cardsInHand == 1) {
+        bc.chooseForethoughtCard(0);
+    } else {
+        bc.cardSelectInfo.cardSelectTask = CardSelectTask::FORETHOUGHT;
+        bc.cardSelectInfo.canPickAnyNumber = false;
+        bc.inputState = InputState::CARD_SELECT;
+    }
 //        }
 
 
-    }};
 }
 
 Action Actions::HeadbuttAction() {
-    return {[=] (BattleContext &bc) {
-        if (bc.cards.discardPile.empty()) {
-            return;
+    return Action(ActionId::HEADBUTT);
+}
 
-        } else if (bc.cards.discardPile.size() == 1) {
-            bc.chooseHeadbuttCard(0);
-        } else {
-            bc.openSimpleCardSelectScreen(CardSelectTask::HEADBUTT, 1);
-        }
-    }};
+static void headbuttAction(BattleContext &bc, const Action &a) {
+    if (bc.cards.discardPile.empty()) {
+        return;
+
+    } else if (bc.cards.discardPile.size() == 1) {
+        bc.chooseHeadbuttCard(0);
+    } else {
+        bc.openSimpleCardSelectScreen(CardSelectTask::HEADBUTT, 1);
+    }
 }
 
 Action Actions::ChooseExhaustOne() {
-    return {[=] (BattleContext &bc) {
-        if (bc.cards.cardsInHand == 0) {
-            return;
+    return Action(ActionId::CHOOSE_EXHAUST_ONE);
+}
 
-        } else if (bc.cards.cardsInHand == 1) {
-            bc.chooseExhaustOneCard(0);
+static void chooseExhaustOne(BattleContext &bc, const Action &a) {
+    if (bc.cards.cardsInHand == 0) {
+        return;
 
-        } else {
-            bc.openSimpleCardSelectScreen(CardSelectTask::EXHAUST_ONE, 1);
+    } else if (bc.cards.cardsInHand == 1) {
+        bc.chooseExhaustOneCard(0);
 
-        }
-    }};
+    } else {
+        bc.openSimpleCardSelectScreen(CardSelectTask::EXHAUST_ONE, 1);
+
+    }
 }
 
 Action Actions::DrawToHandAction(CardSelectTask task, CardType cardType) {
-    return {[=] (BattleContext &bc) {
-        int count = 0;
-        int idx = 0;
-
-        for (int i = 0; i < bc.cards.drawPile.size(); ++i) {
-            const auto &c = bc.cards.drawPile[i];
-            if (c.getType() == cardType) {
-                if (count > 0) {
-                    // for keeping rng consistent with game
-                    // the game creates a temporary list with the skills
-                    bc.cardRandomRng.random(count - 1);
-                }
-                idx = i;
-                ++count;
+    Action a(ActionId::DRAW_TO_HAND);
+    a.enumValue = static_cast<std::uint8_t>(cardType);
+    a.idx = static_cast<int>(task);
+    return a;
+}
+
+static void drawToHandAction(BattleContext &bc, const Action &a) {
+    const auto task = static_cast<CardSelectTask>(a.idx);
+    const auto cardType = static_cast<CardType>(a.enumValue);
+
+    int count = 0;
+    int idx = 0;
+
+    for (int i = 0; i < bc.cards.drawPile.size(); ++i) {
+        const auto &c = bc.cards.drawPile[i];
+        if (c.getType() == cardType) {
+            if (count > 0) {
+                // for keeping rng consistent with game
+                // the game creates a temporary list with the skills
+                bc.cardRandomRng.random(count - 1);
             }
+            idx = i;
+            ++count;
         }
+    }
 
-        if (count == 0) {
-            return;
-        }
+    if (count == 0) {
+        return;
+    }
 
-        if (count == 1) {
-            bc.chooseDrawToHandCards(&idx, 1);
+    if (count == 1) {
+        bc.chooseDrawToHandCards(&idx, 1);
 
-        } else {
-            bc.cardSelectInfo.cardSelectTask = task;
-            bc.inputState = InputState::CARD_SELECT;
-        }
+    } else {
+        bc.cardSelectInfo.cardSelectTask = task;
+        bc.inputState = InputState::CARD_SELECT;
+    }
 
-    }};
 }
 
 Action Actions::WarcryAction() {
-    return {[=] (BattleContext &bc) {
-        // todo if the handSize equals or less than the cardsToChoose just choose them here
-        if (bc.cards.cardsInHand == 0) {
-            return;
-        }
+    return Action(ActionId::WARCRY);
+}
 
-        if (bc.cards.cardsInHand == 1) {
-            bc.cardRandomRng.random(1);
-            bc.chooseWarcryCard(0);
+static void warcryAction(BattleContext &bc, const Action &a) {
+    // todo if the handSize equals or less than the cardsToChoose just choose them here
+    if (bc.cards.cardsInHand == 0) {
+        return;
+    }
 
-        } else {
-            bc.inputState = InputState::CARD_SELECT;
-            bc.cardSelectInfo.cardSelectTask = CardSelectTask::WARCRY;
-        }
-    }};
+    if (bc.cards.cardsInHand == 1) {
+        bc.cardRandomRng.random(1);
+        bc.chooseWarcryCard(0);
+
+    } else {
+        bc.inputState = InputState::CARD_SELECT;
+        bc.cardSelectInfo.cardSelectTask = CardSelectTask::WARCRY;
+    }
 }
 
 Action Actions::TimeEaterPlayCardQueueItem(const CardQueueItem &x) {
-    return {[=] (BattleContext &bc) {
-        auto item = x;
-        item.exhaustOnUse |= bc.curCardQueueItem.card.doesExhaust();
-        item.triggerOnUse = false;
-        bc.curCardQueueItem = item;
-        bc.onAfterUseCard();
+    Action a(ActionId::TIME_EATER_PLAY_CARD_QUEUE_ITEM, false);
+    a.item = x;
+    return a;
+}
 
-    }, false};
+static void timeEaterPlayCardQueueItem(BattleContext &bc, const Action &a) {
+    auto item = a.item;
+    item.exhaustOnUse |= bc.curCardQueueItem.card.doesExhaust();
+    item.triggerOnUse = false;
+    bc.curCardQueueItem = item;
+    bc.onAfterUseCard();
 }
 
 Action Actions::UpgradeAllCardsInHand() {
-    return {[=] (BattleContext &bc) {
-        for (int i = 0; i < bc.cards.cardsInHand; ++i) {
-            bc.cards.hand[i].upgrade();
-        }
-    }};
+    return Action(ActionId::UPGRADE_ALL_CARDS_IN_HAND);
+}
+
+static void upgradeAllCardsInHand(BattleContext &bc, const Action &a) {
+    for (int i = 0; i < bc.cards.cardsInHand; ++i) {
+        bc.cards.hand[i].upgrade();
+    }
 }
 
 Action Actions::EssenceOfDarkness(int darkOrbsPerSlot) {
@@ -911,20 +1071,27 @@ Action Actions::EssenceOfDarkness(int darkOrbsPerSlot) {
 }
 
 Action Actions::IncreaseOrbSlots(int count) {
-    return sts::Action();
+    Action a(ActionId::INCREASE_ORB_SLOTS);
+    a.amount = count;
+    return a;
 }
 
 Action Actions::SuicideAction(int monsterIdx, bool triggerRelics) {
-    return {[=] (BattleContext &bc) {
-        auto &m = bc.monsters.arr[monsterIdx];
-        if (triggerRelics) {
-            if (m.isAlive()) {
-                m.damage(bc, m.curHp);
-            }
-        } else {
-            bc.monsters.arr[monsterIdx].suicideAction(bc);
+    Action a(ActionId::SUICIDE);
+    a.idx = monsterIdx;
+    a.flag = triggerRelics;
+    return a;
+}
+
+static void suicideAction(BattleContext &bc, const Action &a) {
+    auto &m = bc.monsters.arr[a.idx];
+    if (a.flag) {
+        if (m.isAlive()) {
+            m.damage(bc, m.curHp);
         }
-    }};
+    } else {
+        bc.monsters.arr[a.idx].suicideAction(bc);
+    }
 }
 
 Action Actions::PoisonLoseHpAction() {
@@ -932,343 +1099,809 @@ Action Actions::PoisonLoseHpAction() {
 }
 
 Action Actions::RemovePlayerDebuffs() {
-    return {[] (BattleContext &bc) {
-        bc.player.removeDebuffs();
-    }};
+    return Action(ActionId::REMOVE_PLAYER_DEBUFFS);
 }
 
 Action Actions::UpgradeRandomCardAction() {
-    return {[] (BattleContext &bc) {
-        fixed_list<int,10> upgradeableHandIdxs;
-        for (int i = 0; i < bc.cards.cardsInHand; ++i) {
-            if (bc.cards.hand[i].canUpgrade()) {
-                upgradeableHandIdxs.push_back(i);
-            }
-        }
+    return Action(ActionId::UPGRADE_RANDOM_CARD);
+}
 
-        if (upgradeableHandIdxs.empty()) {
-            return;
+static void upgradeRandomCardAction(BattleContext &bc, const Action &a) {
+    fixed_list<int,10> upgradeableHandIdxs;
+    for (int i = 0; i < bc.cards.cardsInHand; ++i) {
+        if (bc.cards.hand[i].canUpgrade()) {
+            upgradeableHandIdxs.push_back(i);
         }
+    }
+
+    if (upgradeableHandIdxs.empty()) {
+        return;
+    }
 
-        java::Collections::shuffle(
-                upgradeableHandIdxs.begin(),
-                upgradeableHandIdxs.end(),
-                java::Random(bc.shuffleRng.randomLong())
-        );
+    java::Collections::shuffle(
+            upgradeableHandIdxs.begin(),
+            upgradeableHandIdxs.end(),
+            java::Random(bc.shuffleRng.randomLong())
+    );
 
-        const auto upgradeIdx = upgradeableHandIdxs[0];
-        bc.cards.hand[upgradeIdx].upgrade();
-    }};
+    const auto upgradeIdx = upgradeableHandIdxs[0];
+    bc.cards.hand[upgradeIdx].upgrade();
 }
 
 Action Actions::CodexAction() {
-    return {[] (BattleContext &bc) {
-        bc.inputState = InputState::CARD_SELECT;
-        bc.cardSelectInfo.cardSelectTask = CardSelectTask::CODEX;
-        bc.cardSelectInfo.codexCards() =
-                generateDiscoveryCards(bc.cardRandomRng, CharacterClass::IRONCLAD, CardType::INVALID);
-    }};
+    return Action(ActionId::CODEX);
+}
+
+static void codexAction(BattleContext &bc, const Action &a) {
+    bc.inputState = InputState::CARD_SELECT;
+    bc.cardSelectInfo.cardSelectTask = CardSelectTask::CODEX;
+    bc.cardSelectInfo.codexCards() =
+            generateDiscoveryCards(bc.cardRandomRng, CharacterClass::IRONCLAD, CardType::INVALID);
 }
 
 Action Actions::ExhaustMany(int limit) {
-    return {[=] (BattleContext &bc) {
-        bc.inputState = InputState::CARD_SELECT;
-        bc.cardSelectInfo.cardSelectTask = CardSelectTask::EXHAUST_MANY;
-        bc.cardSelectInfo.pickCount = limit;
-    }};
+    Action a(ActionId::EXHAUST_MANY);
+    a.amount = limit;
+    return a;
+}
+
+static void exhaustMany(BattleContext &bc, const Action &a) {
+    bc.inputState = InputState::CARD_SELECT;
+    bc.cardSelectInfo.cardSelectTask = CardSelectTask::EXHAUST_MANY;
+    bc.cardSelectInfo.pickCount = a.amount;
 }
 
 Action Actions::GambleAction() {
-    return {[] (BattleContext &bc) {
-        bc.inputState = InputState::CARD_SELECT;
-        bc.cardSelectInfo.cardSelectTask = CardSelectTask::GAMBLE;
-    }};
+    return Action(ActionId::GAMBLE);
+}
+
+static void gambleAction(BattleContext &bc, const Action &a) {
+    bc.inputState = InputState::CARD_SELECT;
+    bc.cardSelectInfo.cardSelectTask = CardSelectTask::GAMBLE;
 }
 
 Action Actions::ToolboxAction() {
-    return {[] (BattleContext &bc) {
-        bc.inputState = InputState::CARD_SELECT;
-        bc.cardSelectInfo.cardSelectTask = CardSelectTask::DISCOVERY;
-        bc.cardSelectInfo.discovery_CopyCount() = 1;
-        bc.cardSelectInfo.discovery_Cards() =
-                generateDiscoveryCards(bc.cardRandomRng, bc.player.cc, CardType::STATUS); // status is mapped to colorless
-    }};
+    return Action(ActionId::TOOLBOX);
+}
+
+static void toolboxAction(BattleContext &bc, const Action &a) {
+    bc.inputState = InputState::CARD_SELECT;
+    bc.cardSelectInfo.cardSelectTask = CardSelectTask::DISCOVERY;
+    bc.cardSelectInfo.discovery_CopyCount() = 1;
+    bc.cardSelectInfo.discovery_Cards() =
+            generateDiscoveryCards(bc.cardRandomRng, bc.player.cc, CardType::STATUS); // status is mapped to colorless
 }
 
 Action Actions::DualityAction() {
-    return {[](BattleContext &bc) {
-        bc.player.buff<PS::DEXTERITY>(1);
-        bc.player.debuff<PS::LOSE_DEXTERITY>(1);
-    }};
+    return Action(ActionId::DUALITY);
+}
+
+static void dualityAction(BattleContext &bc, const Action &a) {
+    bc.player.buff<PS::DEXTERITY>(1);
+    bc.player.debuff<PS::LOSE_DEXTERITY>(1);
 }
 
 Action Actions::ApotheosisAction() {
-    return {[](BattleContext &bc) {
+    return Action(ActionId::APOTHEOSIS);
+}
 
-        for (int i = 0; i < bc.cards.cardsInHand; ++i) {
-            auto &c = bc.cards.hand[i];
-            if (c.canUpgrade()) {
-                c.upgrade();
-            }
+static void apotheosisAction(BattleContext &bc, const Action &a) {
+
+    for (int i = 0; i < bc.cards.cardsInHand; ++i) {
+        auto &c = bc.cards.hand[i];
+        if (c.canUpgrade()) {
+            c.upgrade();
         }
+    }
 
-        for (auto &c : bc.cards.drawPile) {
-            if (c.canUpgrade()) {
-                c.upgrade();
-            }
+    for (auto &c : bc.cards.drawPile) {
+        if (c.canUpgrade()) {
+            c.upgrade();
         }
+    }
 
-        for (auto &c : bc.cards.discardPile) {
-            if (c.canUpgrade()) {
-                c.upgrade();
-            }
+    for (auto &c : bc.cards.discardPile) {
+        if (c.canUpgrade()) {
+            c.upgrade();
         }
+    }
 
-        for (auto &c : bc.cards.exhaustPile) {
-            if (c.canUpgrade()) {
-                c.upgrade();
-            }
+    for (auto &c : bc.cards.exhaustPile) {
+        if (c.canUpgrade()) {
+            c.upgrade();
         }
-    }};
+    }
 }
 
 Action Actions::DropkickAction(int targetIdx) {
     // assume bc.curCard is the card being used
-    return {[=](BattleContext &bc) {
-        if (bc.monsters.arr[targetIdx].isTargetable() && bc.monsters.arr[targetIdx].hasStatus<MS::VULNERABLE>()) {
-            bc.addToTop(Actions::DrawCards(1));
-            bc.addToTop(Actions::GainEnergy(1));
-        }
+    Action a(ActionId::DROPKICK);
+    a.idx = targetIdx;
+    return a;
+}
 
-        const auto &c = bc.curCardQueueItem.card;
-        const int damage = bc.calculateCardDamage(c, targetIdx, c.isUpgraded() ? 8 : 5);
-        bc.addToTop(Actions::AttackEnemy(targetIdx, damage));
-    }};
+static void dropkickAction(BattleContext &bc, const Action &a) {
+    const auto targetIdx = a.idx;
+    if (bc.monsters.arr[targetIdx].isTargetable() && bc.monsters.arr[targetIdx].hasStatus<MS::VULNERABLE>()) {
+        bc.addToTop(Actions::DrawCards(1));
+        bc.addToTop(Actions::GainEnergy(1));
+    }
+
+    const auto &c = bc.curCardQueueItem.card;
+    const int damage = bc.calculateCardDamage(c, targetIdx, c.isUpgraded() ? 8 : 5);
+    bc.addToTop(Actions::AttackEnemy(targetIdx, damage));
 }
 
 Action Actions::EnlightenmentAction(bool upgraded) {
-    return {[=] (BattleContext &bc) {
-        for (int i = 0; i < bc.cards.cardsInHand; ++i) {
-            auto &c = bc.cards.hand[i];
-            if (c.costForTurn > 1) {
-                c.costForTurn = 1;
-            }
-            if (upgraded && c.cost > 1) {
-                c.costForTurn = 1;
-                c.cost = 1;
-            }
+    Action a(ActionId::ENLIGHTENMENT);
+    a.flag = upgraded;
+    return a;
+}
+
+static void enlightenmentAction(BattleContext &bc, const Action &a) {
+    for (int i = 0; i < bc.cards.cardsInHand; ++i) {
+        auto &c = bc.cards.hand[i];
+        if (c.costForTurn > 1) {
+            c.costForTurn = 1;
+        }
+        if (a.flag && c.cost > 1) {
+            c.costForTurn = 1;
+            c.cost = 1;
         }
-    }};
+    }
 }
 
 Action Actions::EntrenchAction() {
-    return {[=] (BattleContext &bc) {
-        bc.player.gainBlock(bc, bc.player.block);
-    }};
+    return Action(ActionId::ENTRENCH);
 }
 
 Action Actions::FeedAction(int idx, int damage, bool upgraded) {
-    return {[=] (BattleContext &bc) {
-        auto &m = bc.monsters.arr[idx];
-        if (m.isDeadOrEscaped()) {
-            return;
-        }
-        bc.monsters.arr[idx].attacked(bc, damage);
+    Action a(ActionId::FEED);
+    a.idx = idx;
+    a.amount = damage;
+    a.flag = upgraded;
+    return a;
+}
 
-        const bool effectTriggered = !m.hasStatus<MS::MINION>()
-                && !m.isAlive()
-                && !m.isHalfDead()
-                && !(m.hasStatus<MS::REGROW>() && bc.monsters.monstersAlive > 0);
+static void feedAction(BattleContext &bc, const Action &a) {
+    auto &m = bc.monsters.arr[a.idx];
+    if (m.isDeadOrEscaped()) {
+        return;
+    }
+    bc.monsters.arr[a.idx].attacked(bc, a.amount);
 
-        if (effectTriggered) {
-            bc.player.increaseMaxHp(upgraded ? 4 : 3);
-        }
+    const bool effectTriggered = !m.hasStatus<MS::MINION>()
+            && !m.isAlive()
+            && !m.isHalfDead()
+            && !(m.hasStatus<MS::REGROW>() && bc.monsters.monstersAlive > 0);
 
-        bc.checkCombat();
-    }};
+    if (effectTriggered) {
+        bc.player.increaseMaxHp(a.flag ? 4 : 3);
+    }
+
+    bc.checkCombat();
 }
 
 Action Actions::FiendFireAction(int targetIdx, int calculatedDamage) {
-    return {[=] (BattleContext &bc) {
-        for (int i = 0; i < bc.cards.cardsInHand; ++i) {
-            bc.addToTop(Actions::AttackEnemy(targetIdx, calculatedDamage));
-        }
+    Action a(ActionId::FIEND_FIRE);
+    a.idx = targetIdx;
+    a.amount = calculatedDamage;
+    return a;
+}
 
-        for (int i = 0; i < bc.cards.cardsInHand; ++i) {
-            bc.addToTop( Actions::ExhaustRandomCardInHand(1) );
-        }
-    }};
+static void fiendFireAction(BattleContext &bc, const Action &a) {
+    for (int i = 0; i < bc.cards.cardsInHand; ++i) {
+        bc.addToTop(Actions::AttackEnemy(a.idx, a.amount));
+    }
+
+    for (int i = 0; i < bc.cards.cardsInHand; ++i) {
+        bc.addToTop( Actions::ExhaustRandomCardInHand(1) );
+    }
 }
 
 Action Actions::HandOfGreedAction(int idx, int damage, bool upgraded) {
-    return {[=] (BattleContext &bc) {
-        auto &m = bc.monsters.arr[idx];
-        if (m.isDeadOrEscaped()) {
-            return;
-        }
-        bc.monsters.arr[idx].damage(bc, damage);
+    Action a(ActionId::HAND_OF_GREED);
+    a.idx = idx;
+    a.amount = damage;
+    a.flag = upgraded;
+    return a;
+}
 
-        const bool effectTriggered = !m.hasStatus<MS::MINION>()
-                && !m.isAlive()
-                && !m.isHalfDead()
-                && !(m.hasStatus<MS::REGROW>() && bc.monsters.monstersAlive > 0);
+static void handOfGreedAction(BattleContext &bc, const Action &a) {
+    auto &m = bc.monsters.arr[a.idx];
+    if (m.isDeadOrEscaped()) {
+        return;
+    }
+    bc.monsters.arr[a.idx].damage(bc, a.amount);
 
-        if (effectTriggered) {
-            bc.player.gainGold(bc, upgraded ? 25 : 20);
-        }
+    const bool effectTriggered = !m.hasStatus<MS::MINION>()
+            && !m.isAlive()
+            && !m.isHalfDead()
+            && !(m.hasStatus<MS::REGROW>() && bc.monsters.monstersAlive > 0);
 
-        bc.checkCombat();
-    }};
+    if (effectTriggered) {
+        bc.player.gainGold(bc, a.flag ? 25 : 20);
+    }
+
+    bc.checkCombat();
 }
 
 Action Actions::LimitBreakAction() {
-    return {[] (BattleContext &bc) {
-        bc.player.buff<PS::STRENGTH>(bc.player.getStatus<PS::STRENGTH>());
-    }};
+    return Action(ActionId::LIMIT_BREAK);
 }
 
 Action Actions::ReaperAction(int baseDamage) {
-    return {[=] (BattleContext &bc) {
+    Action a(ActionId::REAPER);
+    a.amount = baseDamage;
+    return a;
+}
 
-        int healAmount = 0;
-        for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-            auto &m = bc.monsters.arr[i];
-            if (m.isDeadOrEscaped()) {
-                continue;
-            }
-            int preDamageHp = m.curHp;
-            m.attacked(bc, bc.calculateCardDamage(bc.curCardQueueItem.card, i, baseDamage));
-            healAmount += preDamageHp-m.curHp;
-        }
+static void reaperAction(BattleContext &bc, const Action &a) {
 
-        if (healAmount > 0) {
-            bc.addToBot( Actions::HealPlayer(healAmount) );
+    int healAmount = 0;
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        auto &m = bc.monsters.arr[i];
+        if (m.isDeadOrEscaped()) {
+            continue;
         }
+        int preDamageHp = m.curHp;
+        m.attacked(bc, bc.calculateCardDamage(bc.curCardQueueItem.card, i, a.amount));
+        healAmount += preDamageHp-m.curHp;
+    }
+
+    if (healAmount > 0) {
+        bc.addToBot( Actions::HealPlayer(healAmount) );
+    }
 
-        //if (AbstractDungeon.getCurrRoom().monsters.areMonstersBasicallyDead()) {
-        //                AbstractDungeon.actionManager.clearPostCombatActions();
-        //            }
-    }};
+    //if (AbstractDungeon.getCurrRoom().monsters.areMonstersBasicallyDead()) {
+    //                AbstractDungeon.actionManager.clearPostCombatActions();
+    //            }
 }
 
 Action Actions::RitualDaggerAction(int idx, int damage) {
-    return {[=] (BattleContext &bc) {
-        auto &m = bc.monsters.arr[idx];
-        if (m.isDeadOrEscaped()) {
-            return;
-        }
-        bc.monsters.arr[idx].attacked(bc, damage);
+    Action a(ActionId::RITUAL_DAGGER);
+    a.idx = idx;
+    a.amount = damage;
+    return a;
+}
 
-        const bool shouldUpgrade = !m.hasStatus<MS::MINION>()
-                                   && !m.isAlive()
-                                   && !(m.hasStatus<MS::REGROW>() && bc.monsters.monstersAlive > 0);
-        if (shouldUpgrade) {
-            auto &c = bc.curCardQueueItem.card;
-            const auto upgradeAmt = c.isUpgraded() ? 5 : 3;
+static void ritualDaggerAction(BattleContext &bc, const Action &a) {
+    auto &m = bc.monsters.arr[a.idx];
+    if (m.isDeadOrEscaped()) {
+        return;
+    }
+    bc.monsters.arr[a.idx].attacked(bc, a.amount);
 
-            if (bc.curCardQueueItem.purgeOnUse) {
-                bc.cards.findAndUpgradeSpecialData(c.uniqueId, upgradeAmt);
-            }
-            c.specialData += upgradeAmt;
+    const bool shouldUpgrade = !m.hasStatus<MS::MINION>()
+                               && !m.isAlive()
+                               && !(m.hasStatus<MS::REGROW>() && bc.monsters.monstersAlive > 0);
+    if (shouldUpgrade) {
+        auto &c = bc.curCardQueueItem.card;
+        const auto upgradeAmt = c.isUpgraded() ? 5 : 3;
+
+        if (bc.curCardQueueItem.purgeOnUse) {
+            bc.cards.findAndUpgradeSpecialData(c.uniqueId, upgradeAmt);
         }
+        c.specialData += upgradeAmt;
+    }
 
-        bc.checkCombat();
-    }};
+    bc.checkCombat();
 }
 
 Action Actions::SecondWindAction(int blockPerCard) {
-    return {[=] (BattleContext &bc) {
-        int cardIdxsToExhaust[10];
-        int toExhaustCount = 0;
-
-        for (int i = 0; i < bc.cards.cardsInHand; ++i) {
-            const auto &c = bc.cards.hand[i];
-            if (c.getType() != CardType::ATTACK) {
-                cardIdxsToExhaust[toExhaustCount++] = i;
-                bc.addToTop( Actions::GainBlock(blockPerCard) );
-            }
-        }
+    Action a(ActionId::SECOND_WIND);
+    a.amount = blockPerCard;
+    return a;
+}
 
-        for (int i = 0; i < toExhaustCount; ++i) {
-            const auto handIdx = cardIdxsToExhaust[i];
-            const auto &c = bc.cards.hand[handIdx];
+static void secondWindAction(BattleContext &bc, const Action &a) {
+    int cardIdxsToExhaust[10];
+    int toExhaustCount = 0;
 
-            bc.addToTop( Actions::ExhaustSpecificCardInHand(handIdx, c.uniqueId) );
+    for (int i = 0; i < bc.cards.cardsInHand; ++i) {
+        const auto &c = bc.cards.hand[i];
+        if (c.getType() != CardType::ATTACK) {
+            cardIdxsToExhaust[toExhaustCount++] = i;
+            bc.addToTop( Actions::GainBlock(a.amount) );
         }
-    }};
+    }
+
+    for (int i = 0; i < toExhaustCount; ++i) {
+        const auto handIdx = cardIdxsToExhaust[i];
+        const auto &c = bc.cards.hand[handIdx];
+
+        bc.addToTop( Actions::ExhaustSpecificCardInHand(handIdx, c.uniqueId) );
+    }
 }
 
 Action Actions::SeverSoulExhaustAction() {
-    return {[=] (BattleContext &bc) {
-        for (int i = bc.cards.cardsInHand-1; i >= 0; --i) {
-            const auto &c = bc.cards.hand[i];
-            if (c.getType() != CardType::ATTACK) {
-                bc.addToBot( Actions::ExhaustSpecificCardInHand(i, c.getUniqueId()) );
-            }
+    return Action(ActionId::SEVER_SOUL_EXHAUST);
+}
+
+static void severSoulExhaustAction(BattleContext &bc, const Action &a) {
+    for (int i = bc.cards.cardsInHand-1; i >= 0; --i) {
+        const auto &c = bc.cards.hand[i];
+        if (c.getType() != CardType::ATTACK) {
+            bc.addToBot( Actions::ExhaustSpecificCardInHand(i, c.getUniqueId()) );
         }
-    }};
+    }
 }
 
 Action Actions::SwordBoomerangAction(int baseDamage) { // pretty hacky until I can figure out a better solution
-    return {[=](BattleContext &bc) {
-        const static CardInstance swordBoomerang {CardId::SWORD_BOOMERANG};
-        const auto idx = bc.monsters.getRandomMonsterIdx(bc.cardRandomRng, true);
-        if (idx == -1) {
-            return;
-        }
+    Action a(ActionId::SWORD_BOOMERANG);
+    a.amount = baseDamage;
+    return a;
+}
+
+static void swordBoomerangAction(BattleContext &bc, const Action &a) {
+    const static CardInstance swordBoomerang {CardId::SWORD_BOOMERANG};
+    const auto idx = bc.monsters.getRandomMonsterIdx(bc.cardRandomRng, true);
+    if (idx == -1) {
+        return;
+    }
 
-        int damage = bc.calculateCardDamage(swordBoomerang, idx, baseDamage);
-        bc.addToTop(Actions::AttackEnemy(idx, damage));
-    }};
+    int damage = bc.calculateCardDamage(swordBoomerang, idx, a.amount);
+    bc.addToTop(Actions::AttackEnemy(idx, damage));
 }
 
 Action Actions::SpotWeaknessAction(int target, int strength) {
-    return {[=](BattleContext &bc) {
-        if (bc.monsters.arr[target].isAttacking()) {
-            bc.player.buff<PS::STRENGTH>(strength);
-        }
-    }};
+    Action a(ActionId::SPOT_WEAKNESS);
+    a.idx = target;
+    a.amount = strength;
+    return a;
+}
+
+static void spotWeaknessAction(BattleContext &bc, const Action &a) {
+    if (bc.monsters.arr[a.idx].isAttacking()) {
+        bc.player.buff<PS::STRENGTH>(a.amount);
+    }
 }
 
 Action Actions::WhirlwindAction(int baseDamage, int energy, bool useEnergy) {
-    return {[=] (BattleContext &bc) {
-        // assume bc.curCard is the card being used
+    Action a(ActionId::WHIRLWIND);
+    a.amount = baseDamage;
+    a.idx = energy;
+    a.flag = useEnergy;
+    return a;
+}
 
-        if (useEnergy) {
-            bc.player.useEnergy(bc.player.energy);
-        }
+static void whirlwindAction(BattleContext &bc, const Action &a) {
+    // assume bc.curCard is the card being used
+    const auto baseDamage = a.amount;
+    const auto energy = a.idx;
 
-        DamageMatrix damageMatrix {0};
-        for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-            if (!bc.monsters.arr[i].isDeadOrEscaped()) {
-                const auto calcDamage = bc.calculateCardDamage(bc.curCardQueueItem.card, i, baseDamage);
-
-                damageMatrix[i] = static_cast<std::uint16_t>( // fit damage into uint16
-                    std::min(
-                        static_cast<int>(std::numeric_limits<std::uint16_t>::max()),
-                        calcDamage
-                    )
-                );
-            }
-        }
+    if (a.flag) {
+        bc.player.useEnergy(bc.player.energy);
+    }
+
+    DamageMatrix damageMatrix {0};
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        if (!bc.monsters.arr[i].isDeadOrEscaped()) {
+            const auto calcDamage = bc.calculateCardDamage(bc.curCardQueueItem.card, i, baseDamage);
 
-        const auto effectAmount = energy + (bc.player.hasRelic<R::CHEMICAL_X>() ? 2 : 0);
-        if (effectAmount > 0) {
-            Actions::AttackAllMonsterRecursive(damageMatrix, effectAmount).actFunc(bc);
+            damageMatrix[i] = static_cast<std::uint16_t>( // fit damage into uint16
+                std::min(
+                    static_cast<int>(std::numeric_limits<std::uint16_t>::max()),
+                    calcDamage
+                )
+            );
         }
-    }};
+    }
+
+    const auto effectAmount = energy + (bc.player.hasRelic<R::CHEMICAL_X>() ? 2 : 0);
+    if (effectAmount > 0) {
+        Actions::AttackAllMonsterRecursive(damageMatrix, effectAmount).execute(bc);
+    }
 }
 
 Action Actions::AttackAllMonsterRecursive(DamageMatrix matrix, int timesRemaining) {
-    return {[=] (BattleContext &bc) {
-        if (timesRemaining <= 0) {
-            return;
-        }
+    Action a(ActionId::ATTACK_ALL_MONSTER_RECURSIVE);
+    a.damageMatrix = matrix;
+    a.amount = timesRemaining;
+    return a;
+}
+
+static void attackAllMonsterRecursive(BattleContext &bc, const Action &a) {
+    const auto timesRemaining = a.amount;
+    if (timesRemaining <= 0) {
+        return;
+    }
+
+    Actions::AttackAllEnemy(a.damageMatrix).execute(bc);
+
+    if (timesRemaining > 1) {
+        bc.addToTop(Actions::AttackAllMonsterRecursive(a.damageMatrix, timesRemaining-1)); // todo should this be to the top? test with
+    }
+}
 
-        Actions::AttackAllEnemy(matrix).actFunc(bc);
+// ************ status actions ************
 
-        if (timesRemaining > 1) {
-            bc.addToTop(AttackAllMonsterRecursive(matrix, timesRemaining-1)); // todo should this be to the top? test with
+// the status actions store their status as a runtime value, these tables map it back to the template instantiations
+
+typedef void (*StatusActionFunction)(BattleContext &bc, const Action &a);
+
+template <PlayerStatus s>
+static void buffPlayer(BattleContext &bc, const Action &a) {
+    if (s == PlayerStatus::CORRUPTION && !bc.player.hasStatus<PS::CORRUPTION>()) {
+        bc.cards.onBuffCorruption();
+    }
+    bc.player.buff<s>(a.amount);
+}
+
+template <PlayerStatus s>
+static void debuffPlayer(BattleContext &bc, const Action &a) {
+    bc.player.debuff<s>(a.amount, a.flag);
+}
+
+template <PlayerStatus s>
+static void decrementStatus(BattleContext &bc, const Action &a) {
+    bc.player.decrementStatus<s>(a.amount);
+}
+
+template <PlayerStatus s>
+static void removeStatus(BattleContext &bc, const Action &a) {
+    bc.player.setHasStatus<s>(false);
+}
+
+template <MonsterStatus s>
+static void buffEnemy(BattleContext &bc, const Action &a) {
+    // todo check if alive?
+    bc.monsters.arr[a.idx].buff<s>(a.amount);
+}
+
+template <MonsterStatus s>
+static void debuffEnemy(BattleContext &bc, const Action &a) {
+    bc.debuffEnemy<s>(a.idx, a.amount, a.flag);
+}
+
+template <template <PlayerStatus> class Fn, std::size_t... Is>
+static constexpr std::array<StatusActionFunction, sizeof...(Is)> makePlayerStatusTable(std::index_sequence<Is...>) {
+    return {{ Fn<static_cast<PlayerStatus>(Is)>::value... }};
+}
+
+template <template <MonsterStatus> class Fn, std::size_t... Is>
+static constexpr std::array<StatusActionFunction, sizeof...(Is)> makeMonsterStatusTable(std::index_sequence<Is...>) {
+    return {{ Fn<static_cast<MonsterStatus>(Is)>::value... }};
+}
+
+template <PlayerStatus s> struct BuffPlayerFn { static constexpr StatusActionFunction value = &buffPlayer<s>; };
+template <PlayerStatus s> struct DebuffPlayerFn { static constexpr StatusActionFunction value = &debuffPlayer<s>; };
+template <PlayerStatus s> struct DecrementStatusFn { static constexpr StatusActionFunction value = &decrementStatus<s>; };
+template <PlayerStatus s> struct RemoveStatusFn { static constexpr StatusActionFunction value = &removeStatus<s>; };
+template <MonsterStatus s> struct BuffEnemyFn { static constexpr StatusActionFunction value = &buffEnemy<s>; };
+template <MonsterStatus s> struct DebuffEnemyFn { static constexpr StatusActionFunction value = &debuffEnemy<s>; };
+
+static constexpr auto playerStatusIdxs = std::make_index_sequence<static_cast<int>(PlayerStatus::THE_BOMB)+1>();
+static constexpr auto monsterStatusIdxs = std::make_index_sequence<static_cast<int>(MonsterStatus::INVALID)>();
+
+static constexpr auto buffPlayerTable = makePlayerStatusTable<BuffPlayerFn>(playerStatusIdxs);
+static constexpr auto debuffPlayerTable = makePlayerStatusTable<DebuffPlayerFn>(playerStatusIdxs);
+static constexpr auto decrementStatusTable = makePlayerStatusTable<DecrementStatusFn>(playerStatusIdxs);
+static constexpr auto removeStatusTable = makePlayerStatusTable<RemoveStatusFn>(playerStatusIdxs);
+static constexpr auto buffEnemyTable = makeMonsterStatusTable<BuffEnemyFn>(monsterStatusIdxs);
+static constexpr auto debuffEnemyTable = makeMonsterStatusTable<DebuffEnemyFn>(monsterStatusIdxs);
+
+static void debuffAllEnemy(BattleContext &bc, const Action &a) {
+    Action debuff(ActionId::DEBUFF_ENEMY);
+    debuff.enumValue = a.enumValue;
+    debuff.amount = a.amount;
+    debuff.flag = a.flag;
+
+    for (int i = bc.monsters.monsterCount-1; i >= 0; --i) {
+        if (bc.monsters.arr[i].isTargetable()) {
+            debuff.idx = i;
+            bc.addToTop(debuff);
         }
-    }};
+    }
+}
+
+// ************
+
+void Action::execute(BattleContext &bc) const {
+    const Action &a = *this;
+
+    switch (id) {
+        case ActionId::NO_OP:
+            return;
+
+        case ActionId::SET_STATE:
+            return setState(bc, a);
+
+        case ActionId::BUFF_PLAYER:
+            return buffPlayerTable[enumValue](bc, a);
+
+        case ActionId::DEBUFF_PLAYER:
+            return debuffPlayerTable[enumValue](bc, a);
+
+        case ActionId::DECREMENT_STATUS:
+            return decrementStatusTable[enumValue](bc, a);
+
+        case ActionId::REMOVE_STATUS:
+            return removeStatusTable[enumValue](bc, a);
+
+        case ActionId::BUFF_ENEMY:
+            return buffEnemyTable[enumValue](bc, a);
+
+        case ActionId::DEBUFF_ENEMY:
+            return debuffEnemyTable[enumValue](bc, a);
+
+        case ActionId::DEBUFF_ALL_ENEMY:
+            return debuffAllEnemy(bc, a);
+
+        case ActionId::ATTACK_ENEMY:
+            return attackEnemy(bc, a);
+
+        case ActionId::ATTACK_ALL_ENEMY:
+            return attackAllEnemy(bc, a);
+
+        case ActionId::ATTACK_ALL_ENEMY_MATRIX:
+            return attackAllEnemyMatrix(bc, a);
+
+        case ActionId::DAMAGE_ENEMY:
+            return damageEnemy(bc, a);
+
+        case ActionId::DAMAGE_ALL_ENEMY:
+            return damageAllEnemy(bc, a);
+
+        case ActionId::ATTACK_PLAYER:
+            return attackPlayer(bc, a);
+
+        case ActionId::DAMAGE_PLAYER:
+            return damagePlayer(bc, a);
+
+        case ActionId::VAMPIRE_ATTACK:
+            return vampireAttack(bc, a);
+
+        case ActionId::PLAYER_LOSE_HP:
+            return playerLoseHp(bc, a);
+
+        case ActionId::HEAL_PLAYER:
+            return healPlayer(bc, a);
+
+        case ActionId::MONSTER_GAIN_BLOCK:
+            return monsterGainBlock(bc, a);
+
+        case ActionId::ROLL_MOVE:
+            return rollMove(bc, a);
+
+        case ActionId::REACTIVE_ROLL_MOVE:
+            return reactiveRollMove(bc, a);
+
+        case ActionId::NO_OP_ROLL_MOVE:
+            bc.noOpRollMove();
+            return;
+
+        case ActionId::GAIN_ENERGY:
+            bc.player.gainEnergy(amount);
+            return;
+
+        case ActionId::GAIN_BLOCK:
+            bc.player.gainBlock(bc, amount);
+            return;
+
+        case ActionId::DRAW_CARDS:
+            bc.drawCards(amount);
+            return;
+
+        case ActionId::EMPTY_DECK_SHUFFLE:
+            return emptyDeckShuffle(bc, a);
+
+        case ActionId::SHUFFLE_DRAW_PILE:
+            return shuffleDrawPile(bc, a);
+
+        case ActionId::SHUFFLE_TEMP_CARD_INTO_DRAW_PILE:
+            return shuffleTempCardIntoDrawPile(bc, a);
+
+        case ActionId::PLAY_TOP_CARD:
+            bc.playTopCardInDrawPile(idx, flag);
+            return;
+
+        case ActionId::MAKE_TEMP_CARD_IN_HAND:
+            return makeTempCardInHand(bc, a);
+
+        case ActionId::MAKE_TEMP_CARD_IN_DRAW_PILE:
+            return makeTempCardInDrawPile(bc, a);
+
+        case ActionId::MAKE_TEMP_CARD_IN_DISCARD:
+            return makeTempCardInDiscard(bc, a);
+
+        case ActionId::DISCARD_NO_TRIGGER_CARD:
+            return discardNoTriggerCard(bc, a);
+
+        case ActionId::CLEAR_CARD_QUEUE:
+            bc.cardQueue.clear();
+            return;
+
+        case ActionId::DISCARD_AT_END_OF_TURN:
+            bc.discardAtEndOfTurn();
+            return;
+
+        case ActionId::DISCARD_AT_END_OF_TURN_HELPER:
+            bc.discardAtEndOfTurnHelper();
+            return;
+
+        case ActionId::RESTORE_RETAINED_CARDS:
+            bc.restoreRetainedCards(amount);
+            return;
+
+        case ActionId::UNNAMED_END_OF_TURN:
+            return unnamedEndOfTurnAction(bc, a);
+
+        case ActionId::MONSTER_START_TURN:
+            bc.monsters.applyPreTurnLogic(bc);
+            return;
+
+        case ActionId::EXHAUST_TOP_CARD_IN_HAND:
+            bc.exhaustTopCardInHand();
+            return;
+
+        case ActionId::EXHAUST_SPECIFIC_CARD_IN_HAND:
+            bc.exhaustSpecificCardInHand(idx, static_cast<std::int16_t>(amount));
+            return;
+
+        case ActionId::DAMAGE_RANDOM_ENEMY:
+            return damageRandomEnemy(bc, a);
+
+        case ActionId::GAIN_BLOCK_RANDOM_ENEMY:
+            return gainBlockRandomEnemy(bc, a);
+
+        case ActionId::SUMMON_GREMLINS:
+            return summonGremlins(bc, a);
+
+        case ActionId::SPAWN_TORCH_HEADS:
+            return spawnTorchHeads(bc, a);
+
+        case ActionId::SPIRE_SHIELD_DEBUFF:
+            return spireShieldDebuff(bc, a);
+
+        case ActionId::EXHAUST_RANDOM_CARD_IN_HAND:
+            return exhaustRandomCardInHand(bc, a);
+
+        case ActionId::MADNESS:
+            return madnessAction(bc, a);
+
+        case ActionId::RANDOMIZE_HAND_COST:
+            return randomizeHandCost(bc, a);
+
+        case ActionId::UPGRADE_RANDOM_CARD:
+            return upgradeRandomCardAction(bc, a);
+
+        case ActionId::CODEX:
+            return codexAction(bc, a);
+
+        case ActionId::EXHAUST_MANY:
+            return exhaustMany(bc, a);
+
+        case ActionId::GAMBLE:
+            return gambleAction(bc, a);
+
+        case ActionId::TOOLBOX:
+            return toolboxAction(bc, a);
+
+        case ActionId::FIEND_FIRE:
+            return fiendFireAction(bc, a);
+
+        case ActionId::SWORD_BOOMERANG:
+            return swordBoomerangAction(bc, a);
+
+        case ActionId::PUT_RANDOM_CARDS_IN_DRAW_PILE:
+            return putRandomCardsInDrawPile(bc, a);
+
+        case ActionId::DISCOVERY:
+            return discoveryAction(bc, a);
+
+        case ActionId::INFERNAL_BLADE:
+            return infernalBladeAction(bc, a);
+
+        case ActionId::JACK_OF_ALL_TRADES:
+            return jackOfAllTradesAction(bc, a);
+
+        case ActionId::TRANSMUTATION:
+            return transmutationAction(bc, a);
+
+        case ActionId::VIOLENCE:
+            return violenceAction(bc, a);
+
+        case ActionId::BETTER_DISCARD_PILE_TO_HAND:
+            return betterDiscardPileToHandAction(bc, a);
+
+        case ActionId::ARMAMENTS:
+            return armamentsAction(bc, a);
+
+        case ActionId::DUAL_WIELD:
+            return dualWieldAction(bc, a);
+
+        case ActionId::EXHUME:
+            return exhumeAction(bc, a);
+
+        case ActionId::FORETHOUGHT:
+            return forethoughtAction(bc, a);
+
+        case ActionId::HEADBUTT:
+            return headbuttAction(bc, a);
+
+        case ActionId::CHOOSE_EXHAUST_ONE:
+            return chooseExhaustOne(bc, a);
+
+        case ActionId::DRAW_TO_HAND:
+            return drawToHandAction(bc, a);
+
+        case ActionId::WARCRY:
+            return warcryAction(bc, a);
+
+        case ActionId::TIME_EATER_PLAY_CARD_QUEUE_ITEM:
+            return timeEaterPlayCardQueueItem(bc, a);
+
+        case ActionId::UPGRADE_ALL_CARDS_IN_HAND:
+            return upgradeAllCardsInHand(bc, a);
+
+        case ActionId::ON_AFTER_CARD_USED:
+            bc.onAfterUseCard();
+            return;
+
+        case ActionId::INCREASE_ORB_SLOTS:
+            bc.player.increaseOrbSlots(amount);
+            return;
+
+        case ActionId::SUICIDE:
+            return suicideAction(bc, a);
+
+        case ActionId::REMOVE_PLAYER_DEBUFFS:
+            bc.player.removeDebuffs();
+            return;
+
+        case ActionId::DUALITY:
+            return dualityAction(bc, a);
+
+        case ActionId::APOTHEOSIS:
+            return apotheosisAction(bc, a);
+
+        case ActionId::DROPKICK:
+            return dropkickAction(bc, a);
+
+        case ActionId::ENLIGHTENMENT:
+            return enlightenmentAction(bc, a);
+
+        case ActionId::ENTRENCH:
+            bc.player.gainBlock(bc, bc.player.block);
+            return;
+
+        case ActionId::FEED:
+            return feedAction(bc, a);
+
+        case ActionId::HAND_OF_GREED:
+            return handOfGreedAction(bc, a);
+
+        case ActionId::LIMIT_BREAK:
+            bc.player.buff<PS::STRENGTH>(bc.player.getStatus<PS::STRENGTH>());
+            return;
+
+        case ActionId::REAPER:
+            return reaperAction(bc, a);
+
+        case ActionId::RITUAL_DAGGER:
+            return ritualDaggerAction(bc, a);
+
+        case ActionId::SECOND_WIND:
+            return secondWindAction(bc, a);
+
+        case ActionId::SEVER_SOUL_EXHAUST:
+            return severSoulExhaustAction(bc, a);
+
+        case ActionId::SPOT_WEAKNESS:
+            return spotWeaknessAction(bc, a);
+
+        case ActionId::WHIRLWIND:
+            return whirlwindAction(bc, a);
+
+        case ActionId::ATTACK_ALL_MONSTER_RECURSIVE:
+            return attackAllMonsterRecursive(bc, a);
+
+        default:
+#ifdef sts_asserts
+            std::cerr << "Action::execute: invalid action id: " << static_cast<int>(id) << std::endl;
+            assert(false);
+#endif
+            return;
+    }
 }
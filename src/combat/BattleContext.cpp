@@ -51,11 +51,11 @@ void BattleContext::init(const GameContext &gc, MonsterEncounter encounterToInit
     potionCapacity = gc.potionCapacity;
     potions = gc.potions;
 
+    player.cc = gc.cc;
     player.curHp = gc.curHp;
     player.maxHp = gc.maxHp;
     player.gold = gc.gold;
 
-    std::cerr << "encounter: " << encounterToInit << std::endl;
     monsters.init(*this, encounterToInit);
     if (gc.map->burningEliteX == gc.curMapNodeX && gc.map->burningEliteY == gc.curMapNodeY) {
         monsters.applyEmeraldEliteBuff(*this, gc.map->burningEliteBuff, gc.act);
@@ -749,8 +749,8 @@ void BattleContext::executeActions() {
 
         if (!actionQueue.isEmpty()) {
             // do a action
-            auto a = std::move(actionQueue.popFront());
-            a(*this);
+            const auto a = actionQueue.popFront();
+            a.execute(*this);
             continue;
         }
 
@@ -0,0 +1,273 @@
+#include "combat/BattleSerialization.h"
+
+#include "combat/BattleContext.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+using namespace sts;
+
+static constexpr char MAGIC[4] {'S', 'T', 'S', 'B'};
+
+// zero runs shorter than this stay in the literal bytes, a run costs at least two varints
+static constexpr std::size_t MIN_ZERO_RUN = 8;
+static_assert(sizeof(BattleContext) % 8 == 0);
+
+std::uint32_t sts::getBattleContextLayoutHash() {
+    // fnv-1a of the sizes of the parts of a BattleContext and where they are, and of the enum counts an
+    // encoded id is a value of. renumbering an enum without changing its count needs a version bump
+    const std::size_t layout[] {
+        sizeof(BattleContext), alignof(BattleContext),
+        sizeof(Random), sizeof(Player), sizeof(Monster), sizeof(MonsterGroup), sizeof(CardInstance),
+        sizeof(CardManager), sizeof(Action), sizeof(CardQueueItem), sizeof(CardSelectInfo),
+        offsetof(BattleContext, aiRng),
+        offsetof(BattleContext, shuffleRng),
+        offsetof(BattleContext, cardSelectInfo),
+        offsetof(BattleContext, actionQueue),
+        offsetof(BattleContext, cardQueue),
+        offsetof(BattleContext, potions),
+        offsetof(BattleContext, player),
+        offsetof(BattleContext, monsters),
+        offsetof(BattleContext, cards),
+        offsetof(BattleContext, curCardQueueItem),
+        offsetof(BattleContext, miscBits),
+        static_cast<std::size_t>(CardId::ZAP) + 1,
+        static_cast<std::size_t>(Potion::WEAK_POTION) + 1,
+        static_cast<std::size_t>(RelicId::INVALID) + 1,
+        static_cast<std::size_t>(MonsterId::WRITHING_MASS) + 1,
+        static_cast<std::size_t>(MonsterMoveId::WRITHING_MASS_STRONG_STRIKE) + 1,
+        static_cast<std::size_t>(MonsterEncounter::MYSTERIOUS_SPHERE_EVENT) + 1,
+        static_cast<std::size_t>(Player::PLAYER_STATUS_COUNT),
+    };
+
+    std::uint32_t hash = 2166136261U;
+    for (auto x : layout) {
+        hash = (hash ^ static_cast<std::uint32_t>(x)) * 16777619U;
+    }
+    return hash;
+}
+
+template <typename T>
+static void clearSlots(T *arr, int begin, int end) {
+    std::memset(static_cast<void*>(arr + begin), 0, (end - begin) * sizeof(T));
+}
+
+// the slots of a ring buffer from front to front+size are in use
+template <typename T, std::size_t N>
+static void clearUnusedRingSlots(std::array<T,N> &arr, int front, int size) {
+    const int capacity = static_cast<int>(N);
+    const int back = (front + size) % capacity;
+    if (size == capacity) {
+        return;
+    }
+    if (size == 0) {
+        clearSlots(arr.data(), 0, capacity);
+    } else if (front < back) {
+        clearSlots(arr.data(), 0, front);
+        clearSlots(arr.data(), back, capacity);
+    } else {
+        clearSlots(arr.data(), back, front);
+    }
+}
+
+// what a pop or clear leaves behind is never read again, so zeroing it doesn't change the battle
+static void clearUnusedSlots(BattleContext &bc) {
+    for (auto *pile : {&bc.cards.drawPile, &bc.cards.discardPile, &bc.cards.exhaustPile}) {
+        const int size = std::clamp(pile->size(), 0, CardManager::MAX_GROUP_SIZE);
+        clearSlots(&*pile->begin(), size, CardManager::MAX_GROUP_SIZE);
+    }
+    clearUnusedRingSlots(bc.actionQueue.arr, bc.actionQueue.front, bc.actionQueue.size);
+    clearUnusedRingSlots(bc.cardQueue.arr, bc.cardQueue.frontIdx, bc.cardQueue.size);
+}
+
+static void writeVarint(std::vector<std::uint8_t> &out, std::size_t x) {
+    while (x >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(x | 0x80));
+        x >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(x));
+}
+
+static bool readVarint(const std::uint8_t *&it, const std::uint8_t *end, std::size_t &x) {
+    x = 0;
+    for (int shift = 0; it != end && shift < 64; shift += 7) {
+        const auto byte = *it++;
+        x |= static_cast<std::size_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static std::uint64_t loadWord(const std::uint8_t *data, std::size_t pos) {
+    std::uint64_t word;
+    std::memcpy(&word, data + pos, sizeof(word));
+    return word;
+}
+
+// pairs of (literal length, literal bytes, zero run length) until the end of the data.
+// the data is scanned a word at a time, so runs start and end on 8 byte boundaries
+static void encodeZeroRuns(const std::uint8_t *data, std::size_t size, std::vector<std::uint8_t> &out) {
+    std::size_t pos = 0;
+    while (pos < size) {
+        auto literalEnd = pos;
+        auto zeroEnd = pos;
+        while (literalEnd < size) {
+            while (literalEnd < size && loadWord(data, literalEnd) != 0) {
+                literalEnd += 8;
+            }
+            zeroEnd = literalEnd;
+            while (zeroEnd < size && loadWord(data, zeroEnd) == 0) {
+                zeroEnd += 8;
+            }
+            if (zeroEnd - literalEnd >= MIN_ZERO_RUN || zeroEnd == size) {
+                break;
+            }
+            literalEnd = zeroEnd;
+        }
+
+        writeVarint(out, literalEnd - pos);
+        out.insert(out.end(), data + pos, data + literalEnd);
+        writeVarint(out, zeroEnd - literalEnd);
+        pos = zeroEnd;
+    }
+}
+
+static bool decodeZeroRuns(const std::uint8_t *it, const std::uint8_t *end, std::uint8_t *data, std::size_t size) {
+    std::size_t pos = 0;
+    while (pos < size) {
+        std::size_t literalLength;
+        std::size_t zeroRun;
+        if (!readVarint(it, end, literalLength) || literalLength > size - pos || literalLength > static_cast<std::size_t>(end - it)) {
+            return false;
+        }
+        std::memcpy(data + pos, it, literalLength);
+        it += literalLength;
+        pos += literalLength;
+
+        if (!readVarint(it, end, zeroRun) || zeroRun > size - pos) {
+            return false;
+        }
+        std::memset(data + pos, 0, zeroRun);
+        pos += zeroRun;
+    }
+    return it == end;
+}
+
+static BattleStateHeader getHeader(const BattleContext &bc, std::size_t payloadSize) {
+    BattleStateHeader h {};
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = BATTLE_STATE_FORMAT_VERSION;
+    h.headerSize = sizeof(BattleStateHeader);
+    h.layoutHash = getBattleContextLayoutHash();
+    h.payloadSize = static_cast<std::uint32_t>(payloadSize);
+
+    h.seed = bc.seed;
+    h.floorNum = bc.floorNum;
+    h.turn = bc.turn;
+    h.encounter = static_cast<std::uint16_t>(bc.encounter);
+    h.outcome = static_cast<std::uint8_t>(bc.outcome);
+    h.inputState = static_cast<std::uint8_t>(bc.inputState);
+    h.playerCurHp = static_cast<std::int16_t>(bc.player.curHp);
+    h.playerMaxHp = static_cast<std::int16_t>(bc.player.maxHp);
+    h.playerBlock = static_cast<std::int16_t>(bc.player.block);
+    h.playerEnergy = static_cast<std::int16_t>(bc.player.energy);
+    h.monsterCount = static_cast<std::uint8_t>(bc.monsters.monsterCount);
+    h.monstersAlive = static_cast<std::uint8_t>(bc.monsters.monstersAlive);
+    h.potionCount = static_cast<std::uint8_t>(bc.potionCount);
+    h.cardsInHand = static_cast<std::uint8_t>(bc.cards.cardsInHand);
+    h.drawPileSize = static_cast<std::uint16_t>(bc.cards.drawPile.size());
+    h.discardPileSize = static_cast<std::uint16_t>(bc.cards.discardPile.size());
+    h.exhaustPileSize = static_cast<std::uint16_t>(bc.cards.exhaustPile.size());
+    for (int i = 0; i < 5; ++i) {
+        h.monsterCurHp[i] = static_cast<std::int16_t>(i < bc.monsters.monsterCount ? bc.monsters.arr[i].curHp : 0);
+    }
+    return h;
+}
+
+void sts::encodeBattleContext(const BattleContext &bc, std::vector<std::uint8_t> &out) {
+    BattleContext canonical;
+    bc.clone_into(canonical);
+    clearUnusedSlots(canonical);
+
+    const auto headerIdx = out.size();
+    out.reserve(headerIdx + sizeof(BattleStateHeader) + sizeof(BattleContext) / 4);
+    out.resize(headerIdx + sizeof(BattleStateHeader));
+    encodeZeroRuns(reinterpret_cast<const std::uint8_t*>(&canonical), sizeof(BattleContext), out);
+
+    const auto header = getHeader(bc, out.size() - headerIdx - sizeof(BattleStateHeader));
+    std::memcpy(out.data() + headerIdx, &header, sizeof(header));
+}
+
+std::vector<std::uint8_t> sts::encodeBattleContext(const BattleContext &bc) {
+    std::vector<std::uint8_t> out;
+    encodeBattleContext(bc, out);
+    return out;
+}
+
+static bool isInRange(int x, int max) {
+    return x >= 0 && x <= max;
+}
+
+// the sizes and indexes a payload sets that the battle trusts to be within their arrays
+static bool hasValidSizes(const BattleContext &bc) {
+    const auto &c = bc.cards;
+    const int actionCapacity = bc.actionQueue.getCapacity();
+    const int cardCapacity = CardQueue::capacity;
+    return isInRange(c.cardsInHand, CardManager::MAX_HAND_SIZE)
+        && isInRange(c.drawPile.size(), CardManager::MAX_GROUP_SIZE)
+        && isInRange(c.discardPile.size(), CardManager::MAX_GROUP_SIZE)
+        && isInRange(c.exhaustPile.size(), CardManager::MAX_GROUP_SIZE)
+        && isInRange(bc.monsters.monsterCount, static_cast<int>(bc.monsters.arr.size()))
+        && isInRange(bc.monsters.monstersAlive, bc.monsters.monsterCount)
+        && isInRange(bc.potionCapacity, static_cast<int>(bc.potions.size()))
+        && isInRange(bc.potionCount, bc.potionCapacity)
+        && isInRange(bc.actionQueue.size, actionCapacity)
+        && isInRange(bc.actionQueue.front, actionCapacity-1)
+        && isInRange(bc.actionQueue.back, actionCapacity) // wraps on the next push
+        && isInRange(bc.cardQueue.size, cardCapacity)
+        && isInRange(bc.cardQueue.frontIdx, cardCapacity-1)
+        && isInRange(bc.cardQueue.backIdx, cardCapacity-1);
+}
+
+bool sts::decodeBattleContext(const std::uint8_t *data, std::size_t size, BattleContext &bc) {
+    BattleStateHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+        || header.version != BATTLE_STATE_FORMAT_VERSION
+        || header.headerSize != sizeof(BattleStateHeader)
+        || header.layoutHash != getBattleContextLayoutHash()
+        || header.payloadSize > size - sizeof(header)) {
+        return false;
+    }
+
+    // decoded into a copy so a malformed payload leaves bc as it was
+    BattleContext decoded;
+    const auto payload = data + header.headerSize;
+    if (!decodeZeroRuns(payload, payload + header.payloadSize, reinterpret_cast<std::uint8_t*>(&decoded), sizeof(BattleContext))
+        || !hasValidSizes(decoded)) {
+        return false;
+    }
+    decoded.clone_into(bc);
+    return true;
+}
+
+const BattleStateHeader *sts::getBattleStateHeader(const std::uint8_t *data, std::size_t size) {
+    if (size < sizeof(BattleStateHeader) || reinterpret_cast<std::uintptr_t>(data) % alignof(BattleStateHeader) != 0) {
+        return nullptr;
+    }
+    const auto *header = reinterpret_cast<const BattleStateHeader*>(data);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+        || header->version != BATTLE_STATE_FORMAT_VERSION
+        || header->headerSize != sizeof(BattleStateHeader)
+        || header->payloadSize > size - sizeof(BattleStateHeader)) {
+        return nullptr;
+    }
+    return header;
+}
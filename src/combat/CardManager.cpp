@@ -238,7 +238,7 @@ void CardManager::moveToDiscardPile(const CardInstance &c) {
 void CardManager::moveDiscardPileIntoToDrawPile() {
     if (drawPile.empty()) {
         drawPileBloodCardCount = discardPileBloodCardCount;
-        drawPile = discardPile;
+        discardPile.copy_into(drawPile);
 
     } else {
         for (const auto &c : discardPile) {
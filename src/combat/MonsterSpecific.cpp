@@ -879,8 +879,8 @@ void Monster::takeTurn(BattleContext &bc) {     // todo, maybe for monsters that
             break;
 
         case MMID::LAGAVULIN_SIPHON_SOUL:
-            Actions::DebuffPlayer<PS::DEXTERITY>(asc18 ? -2 : -1).actFunc(bc);
-            Actions::DebuffPlayer<PS::STRENGTH>(asc18 ? -2 : -1).actFunc(bc);
+            Actions::DebuffPlayer<PS::DEXTERITY>(asc18 ? -2 : -1).execute(bc);
+            Actions::DebuffPlayer<PS::STRENGTH>(asc18 ? -2 : -1).execute(bc);
             setMove(MMID::LAGAVULIN_ATTACK);
             bc.noOpRollMove();
             break;
@@ -1087,7 +1087,7 @@ void Monster::takeTurn(BattleContext &bc) {     // todo, maybe for monsters that
         // ************ SLIME BOSS ************
 
         case MMID::SLIME_BOSS_GOOP_SPRAY:
-            Actions::MakeTempCardInDiscard( {CardId::SLIMED}, asc19 ? 5 : 3).actFunc(bc);
+            Actions::MakeTempCardInDiscard( {CardId::SLIMED}, asc19 ? 5 : 3).execute(bc);
             setMove(MMID::SLIME_BOSS_PREPARING);
             break;
 
@@ -1391,7 +1391,7 @@ void Monster::takeTurn(BattleContext &bc) {     // todo, maybe for monsters that
             break;
 
         case MMID::REPULSOR_REPULSE: // 1
-            Actions::ShuffleTempCardIntoDrawPile(CardId::DAZED, 2).actFunc(bc);
+            Actions::ShuffleTempCardIntoDrawPile(CardId::DAZED, 2).execute(bc);
             rollMove(bc);
             break;
 
@@ -1569,7 +1569,7 @@ void Monster::takeTurn(BattleContext &bc) {     // todo, maybe for monsters that
             break;
 
         case MMID::NEMESIS_DEBUFF:
-            Actions::MakeTempCardInDiscard({CardId::BURN}, asc3 ? 5 : 3).actFunc(bc);
+            Actions::MakeTempCardInDiscard({CardId::BURN}, asc3 ? 5 : 3).execute(bc);
             rollMove(bc);
             if (!hasStatus<MS::INTANGIBLE>()) {
                 buff<MS::INTANGIBLE>(2);
@@ -1843,11 +1843,11 @@ void Monster::takeTurn(BattleContext &bc) {     // todo, maybe for monsters that
             bc.player.debuff<PS::VULNERABLE>(2, true);
             bc.player.debuff<PS::WEAK>(2, true);
             bc.player.debuff<PS::FRAIL>(2, true);
-            Actions::ShuffleTempCardIntoDrawPile(CardId::DAZED).actFunc(bc);
-            Actions::ShuffleTempCardIntoDrawPile(CardId::SLIMED).actFunc(bc);
-            Actions::ShuffleTempCardIntoDrawPile(CardId::WOUND).actFunc(bc);
-            Actions::ShuffleTempCardIntoDrawPile(CardId::BURN).actFunc(bc);
-            Actions::ShuffleTempCardIntoDrawPile(CardId::VOID).actFunc(bc);
+            Actions::ShuffleTempCardIntoDrawPile(CardId::DAZED).execute(bc);
+            Actions::ShuffleTempCardIntoDrawPile(CardId::SLIMED).execute(bc);
+            Actions::ShuffleTempCardIntoDrawPile(CardId::WOUND).execute(bc);
+            Actions::ShuffleTempCardIntoDrawPile(CardId::BURN).execute(bc);
+            Actions::ShuffleTempCardIntoDrawPile(CardId::VOID).execute(bc);
             rollMove(bc);
             break;
 
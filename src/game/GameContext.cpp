@@ -28,6 +28,30 @@ bool isCampfireRelic(RelicId r) {
     return r == RelicId::PEACE_PIPE || r == RelicId::SHOVEL || r == RelicId::GIRYA;
 }
 
+template <typename List, typename Container>
+static void appendAll(List &list, const Container &c) {
+    for (auto x : c) {
+#ifdef sts_asserts
+        assert(list.size() < list.max_size());
+#endif
+        list.push_back(x);
+    }
+}
+
+// a list of a save is clamped to the capacity of the fixed list it is loaded into, a longer one is from a modded or
+// corrupt save
+template <typename List, typename Container>
+static void appendFromSave(List &list, const Container &c, const char *name) {
+    for (auto x : c) {
+        if (list.size() >= list.max_size()) {
+            std::cerr << "save file " << name << " has " << c.size() << " entries, only the first "
+                << list.max_size() << " are loaded\n";
+            return;
+        }
+        list.push_back(x);
+    }
+}
+
 SelectScreenCard::SelectScreenCard(const Card &card) : card(card) {}
 
 SelectScreenCard::SelectScreenCard(const Card &card, int deckIdx) : card(card), deckIdx(deckIdx) {}
@@ -47,16 +71,14 @@ GameContext::GameContext(CharacterClass cc, std::uint64_t seed, int ascension)
     miscRng(seed),
     mathUtilRng(seed-897897), // uses a time based seed -_-
     cc(cc),
-    map(new Map(Map::fromSeed(seed, ascension, 1, true))),
+    map(std::make_shared<const Map>(Map::fromSeed(seed, ascension, 1, true))),
     ascension(ascension) {
-    eventList.insert(eventList.end(), EventPools::Act1::events.begin(), EventPools::Act1::events.end());
-    shrineList.insert(shrineList.end(), EventPools::Act1::shrines.begin(), EventPools::Act1::shrines.end());
+    appendAll(eventList, EventPools::Act1::events);
+    appendAll(shrineList, EventPools::Act1::shrines);
     if (ascension < 15) {
-        specialOneTimeEventList.insert(specialOneTimeEventList.end(), EventPools::oneTimeEventsAsc0.begin(),
-                                       EventPools::oneTimeEventsAsc0.end());
+        appendAll(specialOneTimeEventList, EventPools::oneTimeEventsAsc0);
     } else {
-        specialOneTimeEventList.insert(specialOneTimeEventList.end(), EventPools::oneTimeEventsAsc15.begin(),
-                                       EventPools::oneTimeEventsAsc15.end());
+        appendAll(specialOneTimeEventList, EventPools::oneTimeEventsAsc15);
     }
 
     generateMonsters();
@@ -119,12 +141,12 @@ void GameContext::initFromSave(const SaveFile &s) {
     shrineList.clear();
     switch (act) {
         case 1:
-            shrineList.insert(shrineList.begin(), EventPools::Act1::shrines.begin(), EventPools::Act1::shrines.end());
+            appendAll(shrineList, EventPools::Act1::shrines);
             break;
 
         case 2:
         case 3:
-            shrineList.insert(shrineList.begin(), EventPools::Act2::shrines.begin(), EventPools::Act2::shrines.end());
+            appendAll(shrineList, EventPools::Act2::shrines);
             break;
 
         case 4:
@@ -132,18 +154,21 @@ void GameContext::initFromSave(const SaveFile &s) {
             break;
     }
 
-    eventList.insert(eventList.begin(), s.event_list.begin(), s.event_list.end());
-    specialOneTimeEventList.insert(
-            specialOneTimeEventList.begin(),
-            s.one_time_event_list.begin(),
-            s.one_time_event_list.end()
-    );
-
-    commonRelicPool.insert(commonRelicPool.begin(), s.common_relics.begin(), s.common_relics.end());
-    uncommonRelicPool.insert(uncommonRelicPool.begin(), s.uncommon_relics.begin(), s.uncommon_relics.end());
-    rareRelicPool.insert(rareRelicPool.begin(), s.rare_relics.begin(), s.rare_relics.end());
-    shopRelicPool.insert(shopRelicPool.begin(), s.shop_relics.begin(), s.shop_relics.end());
-    bossRelicPool.insert(bossRelicPool.begin(), s.boss_relics.begin(), s.boss_relics.end());
+    eventList.clear();
+    appendFromSave(eventList, s.event_list, "event list");
+    specialOneTimeEventList.clear();
+    appendFromSave(specialOneTimeEventList, s.one_time_event_list, "one time event list");
+
+    commonRelicPool.clear();
+    appendFromSave(commonRelicPool, s.common_relics, "common relics");
+    uncommonRelicPool.clear();
+    appendFromSave(uncommonRelicPool, s.uncommon_relics, "uncommon relics");
+    rareRelicPool.clear();
+    appendFromSave(rareRelicPool, s.rare_relics, "rare relics");
+    shopRelicPool.clear();
+    appendFromSave(shopRelicPool, s.shop_relics, "shop relics");
+    bossRelicPool.clear();
+    appendFromSave(bossRelicPool, s.boss_relics, "boss relics");
 
     boss = s.boss_list[0];
     if (s.boss_list.size() > 1) {
@@ -152,21 +177,11 @@ void GameContext::initFromSave(const SaveFile &s) {
 
     monsterListOffset = 0;
     monsterList = {};
-    for (auto m : s.monster_list) {
-        if (monsterList.size() == 16) {
-            assert(false);
-        }
-        monsterList.push_back(m);
-    }
+    appendFromSave(monsterList, s.monster_list, "monster list");
 
     eliteMonsterListOffset = 0;
     eliteMonsterList = {};
-    for (auto m : s.elite_monster_list) {
-        if (eliteMonsterList.size() == 10) {
-            assert(false);
-        }
-        eliteMonsterList.push_back(m);
-    }
+    appendFromSave(eliteMonsterList, s.elite_monster_list, "elite monster list");
 
     MonsterEncounter encounter;
     switch (s.current_room) {
@@ -210,7 +225,7 @@ void GameContext::initFromSave(const SaveFile &s) {
         potions[i] = p;
     }
 
-    map = std::make_shared<Map>(Map::fromSeed(seed, ascension, act, true));
+    map = std::make_shared<const Map>(Map::fromSeed(seed, ascension, act, true));
 
     regainControlAction = [](GameContext &gc) {
         gc.afterBattle();
@@ -425,35 +440,35 @@ void GameContext::initRelics() {
     switch (cc) {
 
         case CharacterClass::IRONCLAD:
-            commonRelicPool.insert(commonRelicPool.end(), Ironclad::commonRelicPool.begin(), Ironclad::commonRelicPool.end());
-            uncommonRelicPool.insert(uncommonRelicPool.end(), Ironclad::uncommonRelicPool.begin(), Ironclad::uncommonRelicPool.end());
-            rareRelicPool.insert(rareRelicPool.end(), Ironclad::rareRelicPool.begin(), Ironclad::rareRelicPool.end());
-            shopRelicPool.insert(shopRelicPool.end(), Ironclad::shopRelicPool.begin(), Ironclad::shopRelicPool.end());
-            bossRelicPool.insert(bossRelicPool.end(), Ironclad::bossRelicPool.begin(), Ironclad::bossRelicPool.end());
+            appendAll(commonRelicPool, Ironclad::commonRelicPool);
+            appendAll(uncommonRelicPool, Ironclad::uncommonRelicPool);
+            appendAll(rareRelicPool, Ironclad::rareRelicPool);
+            appendAll(shopRelicPool, Ironclad::shopRelicPool);
+            appendAll(bossRelicPool, Ironclad::bossRelicPool);
             break;
 
         case CharacterClass::SILENT:
-            commonRelicPool.insert(commonRelicPool.end(), Silent::commonRelicPool.begin(), Silent::commonRelicPool.end());
-            uncommonRelicPool.insert(uncommonRelicPool.end(), Silent::uncommonRelicPool.begin(), Silent::uncommonRelicPool.end());
-            rareRelicPool.insert(rareRelicPool.end(), Silent::rareRelicPool.begin(), Silent::rareRelicPool.end());
-            shopRelicPool.insert(shopRelicPool.end(), Silent::shopRelicPool.begin(), Silent::shopRelicPool.end());
-            bossRelicPool.insert(bossRelicPool.end(), Silent::bossRelicPool.begin(), Silent::bossRelicPool.end());
+            appendAll(commonRelicPool, Silent::commonRelicPool);
+            appendAll(uncommonRelicPool, Silent::uncommonRelicPool);
+            appendAll(rareRelicPool, Silent::rareRelicPool);
+            appendAll(shopRelicPool, Silent::shopRelicPool);
+            appendAll(bossRelicPool, Silent::bossRelicPool);
             break;
 
         case CharacterClass::DEFECT:
-            commonRelicPool.insert(commonRelicPool.end(), Defect::commonRelicPool.begin(), Defect::commonRelicPool.end());
-            uncommonRelicPool.insert(uncommonRelicPool.end(), Defect::uncommonRelicPool.begin(), Defect::uncommonRelicPool.end());
-            rareRelicPool.insert(rareRelicPool.end(), Defect::rareRelicPool.begin(), Defect::rareRelicPool.end());
-            shopRelicPool.insert(shopRelicPool.end(), Defect::shopRelicPool.begin(), Defect::shopRelicPool.end());
-            bossRelicPool.insert(bossRelicPool.end(), Defect::bossRelicPool.begin(), Defect::bossRelicPool.end());
+            appendAll(commonRelicPool, Defect::commonRelicPool);
+            appendAll(uncommonRelicPool, Defect::uncommonRelicPool);
+            appendAll(rareRelicPool, Defect::rareRelicPool);
+            appendAll(shopRelicPool, Defect::shopRelicPool);
+            appendAll(bossRelicPool, Defect::bossRelicPool);
             break;
 
         case CharacterClass::WATCHER:
-            commonRelicPool.insert(commonRelicPool.end(), Watcher::commonRelicPool.begin(), Watcher::commonRelicPool.end());
-            uncommonRelicPool.insert(uncommonRelicPool.end(), Watcher::uncommonRelicPool.begin(), Watcher::uncommonRelicPool.end());
-            rareRelicPool.insert(rareRelicPool.end(), Watcher::rareRelicPool.begin(), Watcher::rareRelicPool.end());
-            shopRelicPool.insert(shopRelicPool.end(), Watcher::shopRelicPool.begin(), Watcher::shopRelicPool.end());
-            bossRelicPool.insert(bossRelicPool.end(), Watcher::bossRelicPool.begin(), Watcher::bossRelicPool.end());
+            appendAll(commonRelicPool, Watcher::commonRelicPool);
+            appendAll(uncommonRelicPool, Watcher::uncommonRelicPool);
+            appendAll(rareRelicPool, Watcher::rareRelicPool);
+            appendAll(shopRelicPool, Watcher::shopRelicPool);
+            appendAll(bossRelicPool, Watcher::bossRelicPool);
             break;
 
         default:
@@ -701,9 +716,9 @@ void GameContext::transitionToAct(int targetAct) {
     curMapNodeX = -1;
     curMapNodeY = -1;
     if (targetAct == 2 || targetAct == 3) {
-        *map = Map::fromSeed(seed, ascension, targetAct, !hasKey(Key::EMERALD_KEY));
+        map = std::make_shared<const Map>(Map::fromSeed(seed, ascension, targetAct, !hasKey(Key::EMERALD_KEY)));
     } else if (targetAct == 4) {
-        *map = Map::act4Map();
+        map = std::make_shared<const Map>(Map::act4Map());
     }
 
     colorlessCardPool = baseColorlessPool;
@@ -734,12 +749,12 @@ void GameContext::transitionToAct(int targetAct) {
     eventList.clear();
     shrineList.clear();
     if (targetAct == 2) {
-        eventList.insert(eventList.end(), EventPools::Act2::events.begin(), EventPools::Act2::events.end());
-        shrineList.insert(shrineList.end(), EventPools::Act2::shrines.begin(), EventPools::Act2::shrines.end());
+        appendAll(eventList, EventPools::Act2::events);
+        appendAll(shrineList, EventPools::Act2::shrines);
 
     } else if (targetAct == 3) {
-        eventList.insert(eventList.end(), EventPools::Act3::events.begin(), EventPools::Act3::events.end());
-        shrineList.insert(shrineList.end(), EventPools::Act3::shrines.begin(), EventPools::Act3::shrines.end());
+        appendAll(eventList, EventPools::Act3::events);
+        appendAll(shrineList, EventPools::Act3::shrines);
     }
 
     screenState = ScreenState::MAP_SCREEN;
@@ -1465,7 +1480,7 @@ bool GameContext::obtainRelic(RelicId r) {
 
 RelicId GameContext::returnRandomRelic(RelicTier tier, bool shopRoom, bool fromFront) {
     RelicId retVal = RelicId::INVALID;
-    std::vector<RelicId> *vec;
+    RelicPool *vec;
 
     switch(tier) {
 
@@ -0,0 +1,126 @@
+#include "game/Random.h"
+
+#include <array>
+#include <memory>
+
+using namespace sts;
+
+namespace {
+
+    struct RandomState {
+        std::uint64_t seed0 = 0;
+        std::uint64_t seed1 = 0;
+
+        RandomState &operator^=(const RandomState &rhs) {
+            seed0 ^= rhs.seed0;
+            seed1 ^= rhs.seed1;
+            return *this;
+        }
+    };
+
+    // where each bit of the state goes under some linear map
+    typedef std::array<RandomState, 128> Columns;
+
+    // nextLong is linear over GF(2), so stepping 2^k times is a 128x128 bit matrix. the matrices are stored
+    // as the xor of the columns for each value of each 4 bit group of the state, a multiply is 32 lookups
+    struct JumpTable {
+        static constexpr int MAX_POWER = 32;
+        std::array<std::array<std::array<RandomState, 16>, 32>, MAX_POWER> nibbles;
+    };
+
+}
+
+static RandomState step(RandomState s) {
+    Random r;
+    r.seed0 = s.seed0;
+    r.seed1 = s.seed1;
+    r.nextLong();
+    return {r.seed0, r.seed1};
+}
+
+static int getBit(const RandomState &s, int i) {
+    return static_cast<int>(((i < 64 ? s.seed0 : s.seed1) >> (i % 64)) & 1);
+}
+
+static RandomState multiply(const Columns &columns, const RandomState &s) {
+    RandomState ret;
+    for (int i = 0; i < 128; ++i) {
+        if (getBit(s, i)) {
+            ret ^= columns[i];
+        }
+    }
+    return ret;
+}
+
+static RandomState multiply(const std::array<std::array<RandomState, 16>, 32> &nibbles, const RandomState &s) {
+    RandomState ret;
+    for (int i = 0; i < 16; ++i) {
+        ret ^= nibbles[i][(s.seed0 >> (i*4)) & 0xF];
+        ret ^= nibbles[16+i][(s.seed1 >> (i*4)) & 0xF];
+    }
+    return ret;
+}
+
+static std::unique_ptr<JumpTable> createJumpTable() {
+    auto table = std::make_unique<JumpTable>();
+
+    Columns columns;
+    for (int i = 0; i < 128; ++i) {
+        RandomState bit;
+        (i < 64 ? bit.seed0 : bit.seed1) = 1ULL << (i % 64);
+        columns[i] = step(bit);
+    }
+
+    for (int k = 0; k < JumpTable::MAX_POWER; ++k) {
+        for (int n = 0; n < 32; ++n) {
+            for (int v = 0; v < 16; ++v) {
+                RandomState x;
+                for (int b = 0; b < 4; ++b) {
+                    if (v & (1 << b)) {
+                        x ^= columns[n*4 + b];
+                    }
+                }
+                table->nibbles[k][n][v] = x;
+            }
+        }
+
+        Columns squared;
+        for (int i = 0; i < 128; ++i) {
+            squared[i] = multiply(columns, columns[i]);
+        }
+        columns = squared;
+    }
+    return table;
+}
+
+static const JumpTable &getJumpTable() {
+    static const auto table = createJumpTable();
+    return *table;
+}
+
+void Random::jump(std::uint64_t steps) {
+    // stepping is a couple of nanoseconds, a matrix multiply is worth a few dozen steps
+    if (steps < 64) {
+        for (; steps > 0; --steps) {
+            nextLong();
+        }
+        return;
+    }
+
+    const auto &table = getJumpTable();
+    RandomState s {seed0, seed1};
+    for (int k = 0; steps != 0; ++k, steps >>= 1) {
+        if (k == JumpTable::MAX_POWER) {
+            // past 2^32 steps, the rest are done 2^31 at a time
+            for (; steps != 0; --steps) {
+                s = multiply(table.nibbles[JumpTable::MAX_POWER-1], multiply(table.nibbles[JumpTable::MAX_POWER-1], s));
+            }
+            break;
+        }
+        if (steps & 1) {
+            s = multiply(table.nibbles[k], s);
+        }
+    }
+    seed0 = s.seed0;
+    seed1 = s.seed1;
+}
@@ -0,0 +1,125 @@
+#include "sim/BatchRunner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+using namespace sts;
+
+void BatchResult::add(const BatchResult &rhs) {
+    gameCount += rhs.gameCount;
+    winCount += rhs.winCount;
+    lossCount += rhs.lossCount;
+    floorSum += rhs.floorSum;
+    simulationCount += rhs.simulationCount;
+}
+
+// each thread's results are on their own cache line, so updating them never invalidates another thread's line
+struct alignas(64) PaddedBatchResult {
+    BatchResult result;
+};
+
+void sts::pinCurrentThread(int coreIdx) {
+#ifdef __linux__
+    const auto coreCount = std::max(1U, std::thread::hardware_concurrency());
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(coreIdx % coreCount, &cpuSet);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#endif
+}
+
+const BatchResult& BatchRunner::run(std::uint64_t startSeed, std::uint64_t seedCount, const PlaySeedFnc &playSeed) {
+    const int threads = std::max(1, threadCount);
+    const auto seedEnd = startSeed + seedCount;
+    const auto blockSize = seedBlockSize > 0 ? seedBlockSize :
+            std::clamp<std::uint64_t>(seedCount / (threads * 16), 1, 1024);
+
+    std::vector<PaddedBatchResult> slots(threads);
+    std::atomic<std::uint64_t> nextSeed {startSeed};
+    std::atomic<int> readyCount {0};
+    std::atomic<bool> started {false};
+
+    const auto runThread = [&](int threadIdx) {
+        if (pinThreads) {
+            pinCurrentThread(threadIdx);
+        }
+
+        // wait for every thread so thread creation isn't part of the timing
+        readyCount.fetch_add(1, std::memory_order_release);
+        while (!started.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+
+        const auto isStopped = [&]() {
+            return stopFlag != nullptr && stopFlag->load(std::memory_order_relaxed);
+        };
+
+        auto &threadResult = slots[threadIdx].result;
+        while (!isStopped()) {
+            const auto blockBegin = nextSeed.fetch_add(blockSize, std::memory_order_relaxed);
+            if (blockBegin >= seedEnd) {
+                break;
+            }
+
+            const auto blockEnd = std::min(blockBegin + blockSize, seedEnd);
+            for (auto seed = blockBegin; seed < blockEnd && !isStopped(); ++seed) {
+                playSeed(seed, threadResult);
+                ++threadResult.gameCount;
+            }
+        }
+    };
+
+    std::chrono::high_resolution_clock::time_point startTime;
+    if (threads == 1) { // doing this for more consistency when benchmarking
+        started = true;
+        startTime = std::chrono::high_resolution_clock::now();
+        runThread(0);
+
+    } else {
+        std::vector<std::thread> workers;
+        for (int tid = 0; tid < threads; ++tid) {
+            workers.emplace_back(runThread, tid);
+        }
+
+        while (readyCount.load(std::memory_order_acquire) < threads) {
+            std::this_thread::yield();
+        }
+        startTime = std::chrono::high_resolution_clock::now();
+        started.store(true, std::memory_order_release);
+
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    const auto endTime = std::chrono::high_resolution_clock::now();
+    elapsed = std::chrono::duration<double>(endTime-startTime).count();
+
+    result = {};
+    threadResults.clear();
+    for (const auto &slot : slots) {
+        threadResults.push_back(slot.result);
+        result.add(slot.result);
+    }
+    return result;
+}
+
+void BatchRunner::printThroughput(std::ostream &os) const {
+    std::int64_t minGames = threadResults.empty() ? 0 : threadResults.front().gameCount;
+    std::int64_t maxGames = minGames;
+    for (const auto &r : threadResults) {
+        minGames = std::min(minGames, r.gameCount);
+        maxGames = std::max(maxGames, r.gameCount);
+    }
+
+    const double gamesPerSecond = result.gameCount / elapsed;
+    os << "games/s: " << gamesPerSecond
+        << " games/s/thread: " << gamesPerSecond / std::max(1, threadCount)
+        << " games per thread min/max: " << minGames << "/" << maxGames;
+}
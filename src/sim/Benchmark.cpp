@@ -0,0 +1,135 @@
+#include "sim/Benchmark.h"
+#include "sim/BatchRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <thread>
+
+using namespace sts;
+
+double BenchmarkResult::minNs() const {
+    return nsPerIteration.empty() ? 0 : *std::min_element(nsPerIteration.begin(), nsPerIteration.end());
+}
+
+double BenchmarkResult::medianNs() const {
+    if (nsPerIteration.empty()) {
+        return 0;
+    }
+    auto sorted = nsPerIteration;
+    std::sort(sorted.begin(), sorted.end());
+    return sorted[sorted.size() / 2];
+}
+
+double BenchmarkResult::maxNs() const {
+    return nsPerIteration.empty() ? 0 : *std::max_element(nsPerIteration.begin(), nsPerIteration.end());
+}
+
+void BenchmarkRunner::add(const std::string &name, const BenchmarkFnc &fnc) {
+    benchmarks.emplace_back(name, fnc);
+}
+
+static double timeRun(const BenchmarkRunner::BenchmarkFnc &fnc, std::int64_t iterations) {
+    const auto startTime = std::chrono::steady_clock::now();
+    fnc(iterations);
+    const auto endTime = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(endTime - startTime).count();
+}
+
+static std::int64_t findIterationCount(const BenchmarkRunner::BenchmarkFnc &fnc, double minTime) {
+    constexpr std::int64_t maxIterations = 1000000000;
+
+    std::int64_t iterations = 1;
+    while (true) {
+        const auto elapsed = timeRun(fnc, iterations);
+        if (elapsed >= minTime || iterations >= maxIterations) {
+            return iterations;
+        }
+
+        // aim past minTime so a noisy run doesn't need another round
+        const auto scale = elapsed > 0 ? std::min(10.0, 1.4 * minTime / elapsed) : 10.0;
+        iterations = std::min(maxIterations, std::max(iterations + 1, static_cast<std::int64_t>(iterations * scale)));
+    }
+}
+
+const std::vector<BenchmarkResult>& BenchmarkRunner::run() {
+    results.clear();
+
+    const auto runAll = [&]() {
+        if (pinCore >= 0) {
+            pinCurrentThread(pinCore);
+        }
+
+        for (const auto &[name, fnc] : benchmarks) {
+            if (!filter.empty() && name.find(filter) == std::string::npos) {
+                continue;
+            }
+
+            BenchmarkResult r;
+            r.name = name;
+            r.iterations = findIterationCount(fnc, minTime);
+            for (int i = 0; i < std::max(1, repetitions); ++i) {
+                r.nsPerIteration.push_back(timeRun(fnc, r.iterations) * 1e9 / r.iterations);
+            }
+            results.push_back(std::move(r));
+        }
+    };
+
+    // pinned on a thread of its own, so the calling thread's affinity is left alone
+    if (pinCore >= 0) {
+        std::thread thread(runAll);
+        thread.join();
+    } else {
+        runAll();
+    }
+    return results;
+}
+
+void BenchmarkRunner::printResults(std::ostream &os) const {
+    std::size_t nameWidth = 10;
+    for (const auto &r : results) {
+        nameWidth = std::max(nameWidth, r.name.size());
+    }
+
+    os << std::left << std::setw(static_cast<int>(nameWidth)) << "benchmark" << std::right
+        << std::setw(14) << "median ns" << std::setw(14) << "min ns" << std::setw(14) << "max ns"
+        << std::setw(14) << "iterations" << '\n';
+
+    for (const auto &r : results) {
+        os << std::left << std::setw(static_cast<int>(nameWidth)) << r.name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(14) << r.medianNs() << std::setw(14) << r.minNs() << std::setw(14) << r.maxNs()
+            << std::setw(14) << r.iterations << '\n';
+    }
+    os << std::defaultfloat << std::setprecision(6);
+    os.flush();
+}
+
+void BenchmarkRunner::printJson(std::ostream &os) const {
+    char date[32] {};
+    const auto now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    os << "{\n  \"context\": {"
+        << "\"date\": \"" << date << "\""
+        << ", \"num_cpus\": " << std::thread::hardware_concurrency()
+        << ", \"seed\": " << seed
+        << ", \"pinned_core\": " << pinCore
+        << ", \"min_time\": " << minTime
+        << ", \"repetitions\": " << repetitions
+        << "},\n  \"benchmarks\": [";
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto &r = results[i];
+        os << (i == 0 ? "\n" : ",\n")
+            << "    {\"name\": \"" << r.name << "\""
+            << ", \"run_type\": \"aggregate\", \"aggregate_name\": \"median\""
+            << ", \"iterations\": " << r.iterations
+            << ", \"real_time\": " << r.medianNs()
+            << ", \"min_time\": " << r.minNs()
+            << ", \"max_time\": " << r.maxNs()
+            << ", \"time_unit\": \"ns\"}";
+    }
+    os << "\n  ]\n}\n";
+    os.flush();
+}
@@ -0,0 +1,124 @@
+#include "sim/MacroBenchmark.h"
+
+#include <fstream>
+
+#include <nlohmann/json.hpp>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+using namespace sts;
+
+std::int64_t sts::getPeakRssKb() {
+#ifdef __linux__
+    // VmHWM follows resetPeakRss, ru_maxrss doesn't
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stoll(line.substr(6)); // kilobytes
+        }
+    }
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // kilobytes on linux
+#else
+    return 0;
+#endif
+}
+
+void sts::resetPeakRss() {
+#ifdef __linux__
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5"; // resets VmHWM, since linux 4.0
+#endif
+}
+
+double MacroBenchmarkResult::gamesPerSecond() const {
+    return elapsed > 0 ? gameCount / elapsed : 0;
+}
+
+double MacroBenchmarkResult::simulationsPerSecond() const {
+    return elapsed > 0 ? simulationCount / elapsed : 0;
+}
+
+void MacroBenchmarkSuite::add(const MacroBenchmarkResult &r) {
+    results.push_back(r);
+}
+
+void MacroBenchmarkSuite::printResults(std::ostream &os) const {
+    for (const auto &r : results) {
+        os << r.name
+            << " threads: " << r.threadCount
+            << " games: " << r.gameCount
+            << " elapsed: " << r.elapsed
+            << " games/s: " << r.gamesPerSecond();
+        if (r.simulationCount > 0) {
+            os << " simulations/s: " << r.simulationsPerSecond();
+        }
+        os << " peak rss MB: " << r.peakRssKb / 1024.0 << '\n';
+    }
+    os.flush();
+}
+
+static nlohmann::json readBaseline(const std::string &path) {
+    std::ifstream in(path);
+    if (!in) {
+        return nlohmann::json::object();
+    }
+    return nlohmann::json::parse(in);
+}
+
+// a rate of 0 in the baseline isn't checked
+static bool checkRate(std::ostream &os, const char *label, double rate, const nlohmann::json &entry, const char *key, double threshold) {
+    const auto baselineRate = entry.value(key, 0.0);
+    if (baselineRate <= 0) {
+        return true;
+    }
+    const auto change = rate / baselineRate - 1;
+    const bool passed = change >= -threshold;
+    os << " " << label << ": " << rate << " baseline: " << baselineRate
+        << " change: " << change * 100 << "%" << (passed ? "" : " REGRESSED");
+    return passed;
+}
+
+bool MacroBenchmarkSuite::checkBaseline(const std::string &path, std::ostream &os) const {
+    const auto baseline = readBaseline(path);
+
+    bool passed = true;
+    for (const auto &r : results) {
+        if (!baseline.contains(r.name)) {
+            os << r.name << " not in baseline " << path << '\n';
+            continue;
+        }
+
+        // rates scaled to the baseline's thread count, so a gate on more cores checks the per thread throughput
+        const auto &entry = baseline[r.name];
+        const auto baselineThreads = entry.value("threads", r.threadCount);
+        const auto scale = static_cast<double>(baselineThreads) / r.threadCount;
+        os << r.name << ":";
+        if (baselineThreads != r.threadCount) {
+            os << " threads: " << r.threadCount << " scaled to baseline threads: " << baselineThreads;
+        }
+        passed &= checkRate(os, "games/s", r.gamesPerSecond() * scale, entry, "games_per_second", threshold);
+        passed &= checkRate(os, "simulations/s", r.simulationsPerSecond() * scale, entry, "simulations_per_second", threshold);
+        os << '\n';
+    }
+    os << (passed ? "baseline check passed" : "baseline check FAILED") << std::endl;
+    return passed;
+}
+
+void MacroBenchmarkSuite::writeBaseline(const std::string &path) const {
+    auto baseline = readBaseline(path);
+    for (const auto &r : results) {
+        auto &entry = baseline[r.name];
+        entry["threads"] = r.threadCount;
+        entry["games"] = r.gameCount;
+        entry["games_per_second"] = r.gamesPerSecond();
+        entry["simulations_per_second"] = r.simulationsPerSecond();
+        entry["peak_rss_kb"] = r.peakRssKb;
+    }
+    std::ofstream out(path);
+    out << baseline.dump(4) << '\n';
+}
@@ -0,0 +1,145 @@
+#include "sim/SeedScanner.h"
+#include "sim/BatchRunner.h"
+
+#include <atomic>
+#include <mutex>
+
+using namespace sts;
+
+SeedView::SeedView() : scratch(std::make_unique<GameContext>()) {}
+
+void SeedView::reset(CharacterClass cc, std::uint64_t seed, int ascension) {
+    this->cc = cc;
+    this->seed = seed;
+    this->ascension = ascension;
+    generated = 0;
+}
+
+const NeowOptions &SeedView::getNeowOptions() {
+    if (!(generated & NEOW)) {
+        Random neowRng(seed);
+        neowOptions = Neow::getOptions(neowRng);
+        generated |= NEOW;
+    }
+    return neowOptions;
+}
+
+const Map &SeedView::getMap() {
+    if (!(generated & MAP)) {
+        map = Map::fromSeed(seed, ascension, 1, true);
+        generated |= MAP;
+    }
+    return map;
+}
+
+void SeedView::generateMonsters() {
+    if (generated & MONSTERS) {
+        return;
+    }
+    auto &gc = *scratch;
+    gc.act = 1;
+    gc.ascension = ascension;
+    gc.monsterRng = Random(seed);
+    gc.monsterList.clear();
+    gc.eliteMonsterList.clear();
+    gc.secondBoss = MonsterEncounter::INVALID;
+    gc.generateMonsters();
+    generated |= MONSTERS;
+}
+
+const fixed_list<MonsterEncounter, 16> &SeedView::getMonsterList() {
+    generateMonsters();
+    return scratch->monsterList;
+}
+
+const fixed_list<MonsterEncounter, 10> &SeedView::getEliteList() {
+    generateMonsters();
+    return scratch->eliteMonsterList;
+}
+
+MonsterEncounter SeedView::getBoss() {
+    generateMonsters();
+    return scratch->boss;
+}
+
+void SeedView::generateRelics() {
+    if (generated & RELICS) {
+        return;
+    }
+    auto &gc = *scratch;
+    gc.cc = cc;
+    gc.relicRng = Random(seed);
+    gc.commonRelicPool.clear();
+    gc.uncommonRelicPool.clear();
+    gc.rareRelicPool.clear();
+    gc.shopRelicPool.clear();
+    gc.bossRelicPool.clear();
+    gc.initRelics();
+    generated |= RELICS;
+}
+
+const GameContext::RelicPool &SeedView::getCommonRelicPool() {
+    generateRelics();
+    return scratch->commonRelicPool;
+}
+
+const GameContext::RelicPool &SeedView::getUncommonRelicPool() {
+    generateRelics();
+    return scratch->uncommonRelicPool;
+}
+
+const GameContext::RelicPool &SeedView::getRareRelicPool() {
+    generateRelics();
+    return scratch->rareRelicPool;
+}
+
+const GameContext::RelicPool &SeedView::getShopRelicPool() {
+    generateRelics();
+    return scratch->shopRelicPool;
+}
+
+const GameContext::RelicPool &SeedView::getBossRelicPool() {
+    generateRelics();
+    return scratch->bossRelicPool;
+}
+
+const GameContext &SeedView::getGameContext() {
+    if (!(generated & GAME_CONTEXT)) {
+        gameContext = std::make_unique<GameContext>(cc, seed, ascension);
+        generated |= GAME_CONTEXT;
+    }
+    return *gameContext;
+}
+
+double SeedScanResult::seedsPerSecond() const {
+    return elapsed > 0 ? seedCount / elapsed : 0;
+}
+
+SeedScanResult SeedScanner::scan(std::uint64_t startSeed, std::uint64_t seedCount, const SeedPredicate &predicate, const MatchFnc &onMatch) const {
+    std::mutex matchMutex;
+    std::atomic<std::int64_t> matchCount {0};
+    std::atomic<bool> stop {false}; // set at the last match, so the rest of the range isn't walked or counted
+
+    BatchRunner runner(threadCount, pinThreads);
+    runner.stopFlag = &stop;
+    runner.run(startSeed, seedCount, [&](std::uint64_t seed, BatchResult &) {
+        // a view per thread, the threads live for one scan
+        static thread_local SeedView view;
+        view.reset(cc, seed, ascension);
+        if (!predicate(view)) {
+            return;
+        }
+
+        std::lock_guard lock(matchMutex);
+        if (maxMatchCount > 0 && matchCount.load(std::memory_order_relaxed) >= maxMatchCount) {
+            return; // another thread took the last match while this one evaluated
+        }
+        const auto count = matchCount.fetch_add(1, std::memory_order_relaxed) + 1;
+        onMatch(seed);
+        if (maxMatchCount > 0 && count >= maxMatchCount) {
+            stop.store(true, std::memory_order_relaxed);
+        }
+    });
+
+    return {runner.result.gameCount, matchCount.load(), runner.elapsed};
+}
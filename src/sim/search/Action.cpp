@@ -464,18 +464,18 @@ void search::Action::execute(BattleContext &bc) const {
     bc.executeActions();
 }
 
-template <typename ForwardIt>
-void setupCardOptionsHelper(std::vector<search::Action> &actions, const ForwardIt begin, const ForwardIt end, const std::function<bool(const CardInstance &)> &p= nullptr) {
+template <typename ActionContainer, typename ForwardIt>
+static void setupCardOptionsHelper(ActionContainer &actions, const ForwardIt begin, const ForwardIt end, const std::function<bool(const CardInstance &)> &p= nullptr) {
     for (int i = 0; begin+i != end; ++i) {
         const auto &c = begin[i];
         if (!p || (p(c))) {
-            actions.emplace_back(search::ActionType::SINGLE_CARD_SELECT, i);
+            actions.push_back(search::Action(search::ActionType::SINGLE_CARD_SELECT, i));
         }
     }
 }
 
-std::vector<search::Action> search::Action::enumerateCardSelectActions(const BattleContext &bc) {
-    std::vector<search::Action> actions;
+void search::Action::enumerateCardSelectActions(const BattleContext &bc, CardSelectActionList &actions) {
+    actions.clear();
 
     switch (bc.cardSelectInfo.cardSelectTask) {
         case CardSelectTask::ARMAMENTS:
@@ -485,13 +485,13 @@ std::vector<search::Action> search::Action::enumerateCardSelectActions(const Bat
 
         case CardSelectTask::CODEX:
             for (int i = 0; i < 4; ++i) { // i -> 3 action means skip
-                actions.push_back({Action(search::ActionType::SINGLE_CARD_SELECT, i)});
+                actions.push_back(Action(search::ActionType::SINGLE_CARD_SELECT, i));
             }
             break;
 
         case CardSelectTask::DISCOVERY:
             for (int i = 0; i < 3; ++i) {
-                actions.push_back({Action(search::ActionType::SINGLE_CARD_SELECT, i)});
+                actions.push_back(Action(search::ActionType::SINGLE_CARD_SELECT, i));
             }
             break;
 
@@ -538,7 +538,7 @@ std::vector<search::Action> search::Action::enumerateCardSelectActions(const Bat
         case CardSelectTask::EXHAUST_MANY:
         case CardSelectTask::GAMBLE:
             // just dont deal with this right now
-            actions.push_back({search::Action(search::ActionType::MULTI_CARD_SELECT, 0)});
+            actions.push_back(Action(search::ActionType::MULTI_CARD_SELECT, 0));
             break;
 
         default:
@@ -547,7 +547,12 @@ std::vector<search::Action> search::Action::enumerateCardSelectActions(const Bat
 #endif
             break;
     }
-    return actions;
+}
+
+std::vector<search::Action> search::Action::enumerateCardSelectActions(const BattleContext &bc) {
+    CardSelectActionList actions;
+    enumerateCardSelectActions(bc, actions);
+    return {actions.begin(), actions.end()};
 }
 
 
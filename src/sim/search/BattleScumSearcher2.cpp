@@ -4,26 +4,196 @@
 
 #include "sim/search/BattleScumSearcher2.h"
 #include "sim/search/ExpertKnowledge.h"
+#include "sim/search/SimpleAgent.h"
 
+#include <algorithm>
+#include <cmath>
 #include <utility>
 #include <string>
 #include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 using namespace sts;
 
-std::int64_t simulationIdx = 0; // for debugging
+thread_local std::int64_t simulationIdx = 0; // for debugging
 
 namespace sts::search {
     thread_local search::BattleScumSearcher2 *g_debug_scum_search;
 }
 
+// the tree parallel search updates the plain statistics arrays with atomic builtins, so the serial search and the
+// selection kernels read them as they are
+template <typename T>
+static T loadRelaxed(const T &x) {
+    T value;
+    __atomic_load(&x, &value, __ATOMIC_RELAXED);
+    return value;
+}
+
+template <typename T>
+static void storeRelaxed(T &x, T value) {
+    __atomic_store(&x, &value, __ATOMIC_RELAXED);
+}
+
+static void addRelaxed(double &x, double value) {
+    auto expected = loadRelaxed(x);
+    double desired;
+    do {
+        desired = expected + value;
+    } while (!__atomic_compare_exchange(&x, &expected, &desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+const char *search::getRolloutPolicyName(RolloutPolicy policy) {
+    switch (policy) {
+        case RolloutPolicy::RANDOM:
+            return "random";
+        case RolloutPolicy::EXPERT:
+            return "expert";
+        case RolloutPolicy::SIMPLE_AGENT:
+            return "simple_agent";
+        default:
+            return "unknown";
+    }
+}
+
+
+
+void search::BattleScumSearcher2::NodeStats::push_back(std::int64_t simulations, double evaluation) {
+    simulationCount.push_back(simulations);
+    evaluationSum.push_back(evaluation);
+    virtualLoss.push_back(0);
+}
+
+void search::BattleScumSearcher2::NodeStats::reserve(std::size_t size) {
+    simulationCount.reserve(size);
+    evaluationSum.reserve(size);
+    virtualLoss.reserve(size);
+}
+
+void search::BattleScumSearcher2::NodeStats::clear() {
+    simulationCount.clear();
+    evaluationSum.clear();
+    virtualLoss.clear();
+}
 
+void search::BattleScumSearcher2::NodeStats::swap(NodeStats &rhs) {
+    simulationCount.swap(rhs.simulationCount);
+    evaluationSum.swap(rhs.evaluationSum);
+    virtualLoss.swap(rhs.virtualLoss);
+}
 
 search::BattleScumSearcher2::BattleScumSearcher2(const BattleContext &bc, search::EvalFnc _evalFnc)
-    : rootState(new BattleContext(bc)), evalFnc(std::move(_evalFnc)), randGen(bc.seed+bc.floorNum) {
+    : rootState(new BattleContext(bc)), tree(1), evalFnc(std::move(_evalFnc)), rootCanRecover(canRecoverDuringBattle(bc)),
+      randGen(bc.seed+bc.floorNum), stepState(new BattleContext) {
+    stats.push_back(0, 0);
+}
+
+void search::BattleScumSearcher2::reset(const BattleContext &bc) {
+    rootState.reset(new BattleContext(bc));
+
+    // edges are trivially destructible so this doesn't touch the old tree
+    tree.clear();
+    tree.emplace_back();
+    stats.clear();
+    stats.push_back(0, 0);
+
+    bestActionValue = std::numeric_limits<double>::min();
+    minActionValue = std::numeric_limits<double>::max();
+    outcomePlayerHp = 0;
+    foundOptimalSolution = false;
+    simulationsSinceImprovement = 0;
+    rootCanRecover = canRecoverDuringBattle(bc);
+    bestActionSequence.clear();
+    randGen.seed(bc.seed+bc.floorNum);
+}
+
+// moves the root to the node reached by actionsTaken, bc is the state after taking them from the old root.
+// the subtree keeps its statistics and the rest of the tree is dropped.
+// returns false and changes nothing if the path isn't in the tree
+bool search::BattleScumSearcher2::reroot(const std::vector<Action> &actionsTaken, const BattleContext &bc) {
+    auto newRootIdx = ROOT_IDX;
+    for (auto a : actionsTaken) {
+        const auto &node = getNode(newRootIdx);
+        const auto edgesEnd = tree.begin() + node.edgeBegin + node.edgeCount;
+        const auto it = std::find_if(tree.begin() + node.edgeBegin, edgesEnd, [=](const Edge &e) { return e.action == a; });
+        if (it == edgesEnd) {
+            return false;
+        }
+        newRootIdx = static_cast<std::uint32_t>(it - tree.begin());
+    }
+
+    // copy the subtree breadth first into a new arena, so the children of each node stay contiguous
+    std::vector<Edge> newTree;
+    NodeStats newStats;
+    newTree.reserve(tree.capacity());
+    newStats.reserve(tree.capacity());
+    newTree.push_back({Action(), getNode(newRootIdx)});
+    newStats.push_back(stats.simulationCount[newRootIdx], stats.evaluationSum[newRootIdx]);
+    for (std::size_t i = 0; i < newTree.size(); ++i) {
+        const auto oldEdgeBegin = newTree[i].node.edgeBegin;
+        const auto edgeCount = newTree[i].node.edgeCount;
+        newTree[i].node.edgeBegin = static_cast<std::uint32_t>(newTree.size());
+        newTree.insert(newTree.end(), tree.begin() + oldEdgeBegin, tree.begin() + oldEdgeBegin + edgeCount);
+        for (auto idx = oldEdgeBegin; idx < oldEdgeBegin + edgeCount; ++idx) {
+            newStats.push_back(stats.simulationCount[idx], stats.evaluationSum[idx]);
+        }
+    }
+    tree.swap(newTree);
+    stats.swap(newStats);
+
+    rootState.reset(new BattleContext(bc));
+    rootCanRecover = canRecoverDuringBattle(bc);
+
+    const bool bestIsInSubtree = bestActionSequence.size() >= actionsTaken.size() &&
+            std::equal(actionsTaken.begin(), actionsTaken.end(), bestActionSequence.begin());
+    if (bestIsInSubtree) {
+        bestActionSequence.erase(bestActionSequence.begin(), bestActionSequence.begin() + actionsTaken.size());
+    } else {
+        bestActionSequence.clear();
+        bestActionValue = std::numeric_limits<double>::min();
+        outcomePlayerHp = 0;
+        foundOptimalSolution = false;
+        simulationsSinceImprovement = 0;
+    }
+
+    return true;
 }
 
 void search::BattleScumSearcher2::search(int64_t simulations) {
+    search(simulations, 1);
+}
+
+void search::BattleScumSearcher2::search(int64_t simulations, int threadCount, SearchParallelism parallelism) {
+    const auto startTime = SearchClock::now();
+    const auto startSimulationCount = getRootSimulationCount();
+    searchStats = {};
+
+    if (threadCount <= 1 || isTerminalState(*rootState)) {
+        searchSerial(simulations);
+
+    } else {
+        switch (parallelism) {
+            case SearchParallelism::ROOT:
+                searchRootParallel(simulations, threadCount);
+                break;
+
+            case SearchParallelism::TREE:
+                searchTreeParallel(simulations, threadCount);
+                break;
+        }
+    }
+
+    finishSearchStats(startTime, startSimulationCount);
+}
+
+void search::BattleScumSearcher2::searchSerial(int64_t simulations) {
     g_debug_scum_search = this;
 
     if (isTerminalState(*rootState)) {
@@ -31,67 +201,648 @@ void search::BattleScumSearcher2::search(int64_t simulations) {
         outcomePlayerHp = rootState->player.curHp;
         bestActionSequence = {};
 
-        root.evaluationSum = evaluation;
-        root.simulationCount = 1;
+        stats.evaluationSum[ROOT_IDX] = evaluation;
+        stats.simulationCount[ROOT_IDX] = 1;
     }
 
-    for (std::int64_t simCount = 0; simCount < simulations; ++simCount) {
+    assignTransposition(ROOT_IDX, *rootState);
+
+    for (std::int64_t simCount = 0; simCount < simulations && !canStopSearch(); ++simCount) {
         step();
     }
 }
 
+// the totals of the search that aren't counted per simulation
+void search::BattleScumSearcher2::finishSearchStats(SearchClock::time_point startTime, std::int64_t startSimulationCount) {
+    searchStats.simulationCount = getRootSimulationCount() - startSimulationCount;
+    searchStats.elapsed = std::chrono::duration<double>(SearchClock::now() - startTime).count();
+    searchStats.nodeCount = static_cast<std::int64_t>(tree.size());
+    searchStats.treeMemory = tree.capacity() * sizeof(Edge)
+            + stats.simulationCount.capacity() * sizeof(std::int64_t)
+            + stats.evaluationSum.capacity() * sizeof(double)
+            + stats.virtualLoss.capacity() * sizeof(std::int32_t);
+
+    if (statsLog != nullptr) {
+        searchStats.printJson(*statsLog);
+    }
+}
+
+// searches until the deadline or until early termination stops it, the search can be continued with another call
+search::AnytimeSearchResult search::BattleScumSearcher2::searchUntil(SearchClock::time_point _deadline, int threadCount, SearchParallelism parallelism) {
+    const auto startTime = SearchClock::now();
+    const auto rootSimulationCount = getRootSimulationCount();
+
+    deadline = _deadline;
+    deadlineCheckCount = 0;
+    search(std::numeric_limits<std::int64_t>::max(), threadCount, parallelism);
+    deadline = SearchClock::time_point::max();
+
+    AnytimeSearchResult result;
+    result.simulationCount = getRootSimulationCount() - rootSimulationCount;
+    result.elapsed = std::chrono::duration<double>(SearchClock::now() - startTime).count();
+    result.bestActionValue = bestActionValue;
+    result.outcomePlayerHp = outcomePlayerHp;
+    result.confidence = getBestActionConfidence();
+    result.bestActionSequence = bestActionSequence;
+    return result;
+}
+
+search::AnytimeSearchResult search::BattleScumSearcher2::searchFor(std::chrono::microseconds budget, int threadCount, SearchParallelism parallelism) {
+    return searchUntil(SearchClock::now() + budget, threadCount, parallelism);
+}
+
+double search::BattleScumSearcher2::getBestActionConfidence() const {
+    const auto &r = root();
+    const auto rootSimulationCount = getRootSimulationCount();
+    if (bestActionSequence.empty() || rootSimulationCount == 0) {
+        return 0;
+    }
+    for (auto i = r.edgeBegin; i < r.edgeBegin + r.edgeCount; ++i) {
+        if (tree[i].action == bestActionSequence.front()) {
+            return static_cast<double>(stats.simulationCount[i]) / rootSimulationCount;
+        }
+    }
+    return 0;
+}
+
+// the random engine for each extra thread is seeded from the root state and the thread index,
+// so a root parallel search is deterministic for a given seed and thread count
+static std::default_random_engine getThreadRandGen(const BattleContext &bc, int threadIdx) {
+    const std::uint64_t seed = bc.seed + bc.floorNum;
+    std::seed_seq seq {
+        static_cast<std::uint32_t>(seed),
+        static_cast<std::uint32_t>(seed >> 32),
+        static_cast<std::uint32_t>(threadIdx)
+    };
+    return std::default_random_engine(seq);
+}
+
+void search::BattleScumSearcher2::searchRootParallel(int64_t simulations, int threadCount) {
+    // every thread grows its own tree, so each gets an equal part of the memory limit. this searcher's tree keeps what
+    // it had from earlier searches but stops expanding past its part
+    const auto totalMemoryLimit = treeMemoryLimit;
+    treeMemoryLimit = totalMemoryLimit / threadCount;
+
+    std::vector<std::unique_ptr<BattleScumSearcher2>> searchers;
+    for (int t = 1; t < threadCount; ++t) {
+        searchers.emplace_back(new BattleScumSearcher2(*rootState, evalFnc));
+        searchers.back()->treeMemoryLimit = treeMemoryLimit;
+        searchers.back()->explorationParameter = explorationParameter;
+        searchers.back()->simdSelection = simdSelection;
+        searchers.back()->rolloutPolicy = rolloutPolicy;
+        searchers.back()->rolloutEpsilon = rolloutEpsilon;
+        searchers.back()->prunePlayouts = prunePlayouts;
+        searchers.back()->stopOnOptimalSolution = stopOnOptimalSolution;
+        searchers.back()->stableSimulationLimit = stableSimulationLimit;
+        searchers.back()->deadline = deadline;
+        searchers.back()->progressiveWidening = progressiveWidening;
+        searchers.back()->wideningConstant = wideningConstant;
+        searchers.back()->wideningExponent = wideningExponent;
+        // helpers search without a table, sharing one would make what each thread reads depend on timing
+        searchers.back()->transpositionTable = nullptr;
+        searchers.back()->randGen = getThreadRandGen(*rootState, t);
+    }
+
+    const auto simulationsForThread = [=](int t) {
+        return simulations / threadCount + (t < simulations % threadCount ? 1 : 0);
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() { searchers[t-1]->searchSerial(simulationsForThread(t)); });
+    }
+    searchSerial(simulationsForThread(0));
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    treeMemoryLimit = totalMemoryLimit;
+
+    // merging in thread order keeps ties in bestActionSequence deterministic
+    for (auto &searcher : searchers) {
+        mergeSearch(*searcher);
+    }
+}
+
+void search::BattleScumSearcher2::mergeNode(std::uint32_t dstIdx, const BattleScumSearcher2 &other, std::uint32_t srcIdx) {
+    const auto &src = other.getNode(srcIdx);
+    auto &dst = getNode(dstIdx);
+    stats.simulationCount[dstIdx] += other.stats.simulationCount[srcIdx];
+    stats.evaluationSum[dstIdx] += other.stats.evaluationSum[srcIdx];
+    if (dst.transpositionIdx == TranspositionTable::INVALID_IDX) {
+        dst.transpositionIdx = src.transpositionIdx;
+    }
+
+    if (src.edgeCount == 0) {
+        return;
+    }
+
+    // both trees enumerated the edges from the same state, so they are in the same order and
+    // with progressive widening the edges of one node are a prefix of the other's
+    if (dst.edgeCount < src.edgeCount) {
+        actionBuffer.clear();
+        for (int i = 0; i < src.edgeCount; ++i) {
+            actionBuffer.push_back(other.tree[src.edgeBegin+i].action);
+        }
+        if (!expandNode(dstIdx, actionBuffer, src.edgeCount)) {
+            return;
+        }
+    }
+    getNode(dstIdx).actionCount = std::max(getNode(dstIdx).actionCount, src.actionCount);
+
+#ifdef sts_asserts
+    assert(getNode(dstIdx).edgeCount >= src.edgeCount);
+#endif
+    for (int i = 0; i < src.edgeCount; ++i) {
+        mergeNode(getNode(dstIdx).edgeBegin+i, other, src.edgeBegin+i);
+    }
+}
+
+void search::BattleScumSearcher2::mergeSearch(BattleScumSearcher2 &other) {
+    mergeNode(ROOT_IDX, other, ROOT_IDX);
+    searchStats.add(other.searchStats);
+
+    if (other.bestActionValue > bestActionValue) {
+        bestActionSequence = std::move(other.bestActionSequence);
+        bestActionValue = other.bestActionValue;
+        outcomePlayerHp = other.outcomePlayerHp;
+        foundOptimalSolution = other.foundOptimalSolution;
+    }
+    simulationsSinceImprovement = std::min(simulationsSinceImprovement, other.simulationsSinceImprovement);
+
+    if (other.minActionValue < minActionValue) {
+        minActionValue = other.minActionValue;
+    }
+}
+
+// what the threads of a tree parallel search share besides the searcher
+struct TreeSearchShared {
+    std::shared_mutex arenaMutex; // held shared while a thread is in the tree, exclusive to reallocate the arena
+    std::mutex expandMutex; // one thread appends edges to the arena at a time
+    std::mutex resultMutex; // for bestActionSequence and the values written with it
+    std::atomic<std::int64_t> simulationsLeft {0};
+    std::atomic<bool> stop {false};
+    std::atomic<bool> hasResult {false}; // bestActionSequence isn't empty, selection reads this instead
+};
+
+struct TreeSearchThread {
+    std::default_random_engine randGen;
+    std::vector<std::uint32_t> searchStack;
+    std::vector<search::Action> actionStack;
+    std::vector<search::Action> actionBuffer;
+    BattleContext state;
+    search::SearchStats stats; // phase times of this thread
+    std::int64_t deadlineCheckCount = 0;
+};
+
+static std::int64_t getSharedSimulationCount(const search::BattleScumSearcher2 &s, std::uint32_t idx) {
+    const auto transpositionIdx = loadRelaxed(s.getNode(idx).transpositionIdx);
+    return transpositionIdx == search::TranspositionTable::INVALID_IDX ?
+        loadRelaxed(s.stats.simulationCount[idx]) : s.transpositionTable->getSimulationCount(transpositionIdx);
+}
+
+static double getSharedEvaluationSum(const search::BattleScumSearcher2 &s, std::uint32_t idx) {
+    const auto transpositionIdx = loadRelaxed(s.getNode(idx).transpositionIdx);
+    return transpositionIdx == search::TranspositionTable::INVALID_IDX ?
+        loadRelaxed(s.stats.evaluationSum[idx]) : s.transpositionTable->getEvaluationSum(transpositionIdx);
+}
+
+static void assignSharedTransposition(search::BattleScumSearcher2 &s, std::uint32_t nodeIdx, const BattleContext &bc) {
+    auto &transpositionIdx = s.getNode(nodeIdx).transpositionIdx;
+    if (s.transpositionTable && loadRelaxed(transpositionIdx) == search::TranspositionTable::INVALID_IDX) {
+        storeRelaxed(transpositionIdx, s.transpositionTable->findOrInsert(search::getBattleStateHash(bc)));
+    }
+}
+
+// gives the node edges for all of actions if it doesn't have them, moving the edges it has like expandNode.
+// the edges are written before edgeBegin and edgeBegin before edgeCount, so a thread that loads edgeCount and then
+// edgeBegin finds at least that many edges. a thread still on the old edges backs up into them, those simulations
+// are missing from the moved copies. returns false if the arena is at treeMemoryLimit
+static bool expandSharedNode(search::BattleScumSearcher2 &s, TreeSearchShared &shared, std::shared_lock<std::shared_mutex> &arenaLock,
+                             std::uint32_t nodeIdx, const std::vector<search::Action> &actions) {
+    const auto maxEdges = std::min<std::size_t>(s.treeMemoryLimit / search::BattleScumSearcher2::EDGE_MEMORY,
+                                                std::numeric_limits<std::uint32_t>::max());
+    const auto edgeCount = static_cast<int>(actions.size());
+
+    while (true) {
+        std::unique_lock expandLock(shared.expandMutex);
+
+        // the shape of a node is only written with expandMutex held
+        auto &node = s.getNode(nodeIdx);
+        const auto oldEdgeBegin = node.edgeBegin;
+        const auto oldEdgeCount = static_cast<int>(node.edgeCount);
+        if (oldEdgeCount >= edgeCount) {
+            return true;
+        }
+
+        const auto newSize = s.tree.size() + edgeCount;
+        if (newSize > maxEdges) {
+            return false;
+        }
+
+        if (newSize <= s.tree.capacity()) {
+            const auto edgeBegin = static_cast<std::uint32_t>(s.tree.size());
+            for (auto srcIdx = oldEdgeBegin; srcIdx < oldEdgeBegin + oldEdgeCount; ++srcIdx) {
+                auto edge = search::BattleScumSearcher2::Edge {s.tree[srcIdx].action};
+                edge.node.edgeBegin = s.tree[srcIdx].node.edgeBegin;
+                edge.node.edgeCount = s.tree[srcIdx].node.edgeCount;
+                edge.node.actionCount = s.tree[srcIdx].node.actionCount;
+                edge.node.transpositionIdx = loadRelaxed(s.tree[srcIdx].node.transpositionIdx);
+                s.tree.push_back(edge);
+                s.stats.push_back(loadRelaxed(s.stats.simulationCount[srcIdx]), loadRelaxed(s.stats.evaluationSum[srcIdx]));
+            }
+            for (int i = oldEdgeCount; i < edgeCount; ++i) {
+                s.tree.push_back({actions[i]});
+                s.stats.push_back(0, 0);
+            }
+
+            __atomic_store_n(&node.actionCount, std::max(node.actionCount, static_cast<std::uint16_t>(edgeCount)), __ATOMIC_RELAXED);
+            __atomic_store_n(&node.edgeBegin, edgeBegin, __ATOMIC_RELEASE);
+            __atomic_store_n(&node.edgeCount, static_cast<std::uint16_t>(edgeCount), __ATOMIC_RELEASE);
+            return true;
+        }
+
+        // reallocating moves the arena, so it waits for the other threads to leave the tree. indices stay valid
+        expandLock.unlock();
+        arenaLock.unlock();
+        {
+            std::unique_lock growLock(shared.arenaMutex);
+            const auto size = s.tree.size() + edgeCount;
+            if (size > s.tree.capacity() && size <= maxEdges) {
+                const auto capacity = std::min(std::max(size, s.tree.capacity()*2), maxEdges);
+                s.tree.reserve(capacity);
+                s.stats.reserve(capacity);
+            }
+        }
+        arenaLock.lock();
+    }
+}
+
+// scores the open edges like evaluateEdge from statistics other threads are updating. every playout in flight
+// through an edge counts as a visit that scored minActionValue, so the threads spread out over the tree
+static int selectSharedEdge(const search::BattleScumSearcher2 &s, const TreeSearchShared &shared,
+                            std::uint32_t nodeIdx, std::uint32_t edgeBegin, int edgeCount) {
+    const auto parentVisits = getSharedSimulationCount(s, nodeIdx);
+    const auto openEdgeCount = s.getOpenEdgeCount(parentVisits, edgeCount);
+    if (openEdgeCount == 1) {
+        return 0;
+    }
+
+    const bool useQuality = shared.hasResult.load(std::memory_order_acquire);
+    const auto minActionValue = loadRelaxed(s.minActionValue);
+    const auto evalRange = loadRelaxed(s.bestActionValue) - minActionValue;
+    const auto logParentVisits = std::log(parentVisits+1);
+
+    auto bestEdge = 0;
+    double bestEdgeValue = 0;
+    for (int i = 0; i < openEdgeCount; ++i) {
+        const auto idx = edgeBegin + i;
+        const auto loss = __atomic_load_n(&s.stats.virtualLoss[idx], __ATOMIC_RELAXED);
+        const auto visits = static_cast<double>(getSharedSimulationCount(s, idx) + loss + 1);
+
+        double qualityValue = 0;
+        if (useQuality) {
+            qualityValue = (getSharedEvaluationSum(s, idx) + loss * minActionValue) / visits / evalRange;
+        }
+        const auto value = qualityValue + s.explorationParameter * std::sqrt(logParentVisits / visits);
+
+        if (i == 0 || value > bestEdgeValue) {
+            bestEdge = i;
+            bestEdgeValue = value;
+        }
+    }
+    return bestEdge;
+}
+
+// the results are only locked when the playout beats one of them
+static void updateSharedResults(search::BattleScumSearcher2 &s, TreeSearchShared &shared,
+                                const std::vector<search::Action> &actionStack, const BattleContext &endState, double evaluation) {
+    __atomic_fetch_add(&s.simulationsSinceImprovement, 1, __ATOMIC_RELAXED);
+    if (evaluation <= loadRelaxed(s.bestActionValue) && evaluation >= loadRelaxed(s.minActionValue)) {
+        return;
+    }
+
+    std::scoped_lock lock(shared.resultMutex);
+    if (evaluation < s.minActionValue) {
+        storeRelaxed(s.minActionValue, evaluation);
+    }
+
+    if (evaluation > s.bestActionValue) {
+        s.bestActionSequence = actionStack;
+        storeRelaxed(s.bestActionValue, evaluation);
+        storeRelaxed(s.outcomePlayerHp, endState.player.curHp);
+        storeRelaxed(s.simulationsSinceImprovement, std::int64_t(0));
+
+        const bool isOptimal = !s.rootCanRecover &&
+                endState.outcome == Outcome::PLAYER_VICTORY &&
+                endState.player.curHp >= s.rootState->player.curHp &&
+                endState.potionCount >= s.rootState->potionCount;
+        storeRelaxed(s.foundOptimalSolution, isOptimal);
+        shared.hasResult.store(true, std::memory_order_release);
+    }
+}
+
+static bool canStopSharedSearch(const search::BattleScumSearcher2 &s, TreeSearchThread &t) {
+    if (s.deadline != search::SearchClock::time_point::max() &&
+        t.deadlineCheckCount++ % search::BattleScumSearcher2::DEADLINE_CHECK_INTERVAL == 0 &&
+        search::SearchClock::now() >= s.deadline) {
+        return true;
+    }
+    if (s.stopOnOptimalSolution && loadRelaxed(s.foundOptimalSolution)) {
+        return true;
+    }
+    const bool hasWin = loadRelaxed(s.outcomePlayerHp) > 0;
+    return s.stableSimulationLimit > 0 && hasWin && loadRelaxed(s.simulationsSinceImprovement) >= s.stableSimulationLimit;
+}
+
+// one simulation of the tree parallel search, step() with the tree shared. the arena lock is released for the playout
+static void stepShared(search::BattleScumSearcher2 &s, TreeSearchShared &shared, TreeSearchThread &t) {
+    search::SearchPhaseTimer timer;
+    t.searchStack.clear();
+    t.searchStack.push_back(search::BattleScumSearcher2::ROOT_IDX);
+    t.actionStack.clear();
+    auto &curState = t.state;
+    s.rootState->clone_into(curState);
+
+    [[maybe_unused]] std::int64_t treeDepth = 0;
+    [[maybe_unused]] std::int64_t treeActionCount = 0;
+
+    std::shared_lock arenaLock(shared.arenaMutex);
+    while (!s.isTerminalState(curState)) {
+        const auto curIdx = t.searchStack.back();
+        auto edgeCount = static_cast<int>(__atomic_load_n(&s.getNode(curIdx).edgeCount, __ATOMIC_ACQUIRE));
+
+        if (edgeCount == 0) {
+            timer.lap(t.stats.selectionTime);
+            treeDepth = static_cast<std::int64_t>(t.searchStack.size()-1);
+
+            ++simulationIdx;
+            t.actionBuffer.clear();
+            s.enumerateActionsForNode(t.actionBuffer, curState);
+            s.orderLeafActions(t.actionBuffer);
+            const auto openEdgeCount = s.getOpenEdgeCount(getSharedSimulationCount(s, curIdx), static_cast<int>(t.actionBuffer.size()));
+            const auto selectIdx = std::uniform_int_distribution<int>(0, openEdgeCount-1)(t.randGen);
+            const auto action = t.actionBuffer[selectIdx];
+            action.execute(curState);
+            t.actionStack.push_back(action);
+
+            // every edge is added at once, so the leaf's edges never move
+            if (expandSharedNode(s, shared, arenaLock, curIdx, t.actionBuffer)) {
+                const auto edgeIdx = __atomic_load_n(&s.getNode(curIdx).edgeBegin, __ATOMIC_ACQUIRE) + selectIdx;
+                __atomic_fetch_add(&s.stats.virtualLoss[edgeIdx], 1, __ATOMIC_RELAXED);
+                t.searchStack.push_back(edgeIdx);
+                assignSharedTransposition(s, edgeIdx, curState);
+            }
+            timer.lap(t.stats.expansionTime);
+
+            // the playout doesn't read the arena, so it doesn't hold up a thread growing it
+            treeActionCount = static_cast<std::int64_t>(t.actionStack.size());
+            arenaLock.unlock();
+            s.playout(curState, t.actionStack, t.randGen);
+            arenaLock.lock();
+            timer.lap(t.stats.rolloutTime);
+            break;
+        }
+
+        // a node widened by an earlier serial search gets the rest of its edges at once, so they move only once
+        const auto actionCount = static_cast<int>(__atomic_load_n(&s.getNode(curIdx).actionCount, __ATOMIC_RELAXED));
+        if (edgeCount < actionCount && s.getOpenEdgeCount(getSharedSimulationCount(s, curIdx), actionCount) > edgeCount) {
+            t.actionBuffer.clear();
+            s.enumerateActionsForNode(t.actionBuffer, curState);
+            s.orderLeafActions(t.actionBuffer);
+            expandSharedNode(s, shared, arenaLock, curIdx, t.actionBuffer);
+            edgeCount = static_cast<int>(__atomic_load_n(&s.getNode(curIdx).edgeCount, __ATOMIC_ACQUIRE));
+        }
+
+        const auto edgeBegin = __atomic_load_n(&s.getNode(curIdx).edgeBegin, __ATOMIC_ACQUIRE);
+        const auto edgeIdx = edgeBegin + selectSharedEdge(s, shared, curIdx, edgeBegin, edgeCount);
+        const auto action = s.tree[edgeIdx].action;
+        __atomic_fetch_add(&s.stats.virtualLoss[edgeIdx], 1, __ATOMIC_RELAXED);
+
+        action.execute(curState);
+        t.actionStack.push_back(action);
+        t.searchStack.push_back(edgeIdx);
+        assignSharedTransposition(s, edgeIdx, curState);
+    }
+
+    const auto evaluation = search::BattleScumSearcher2::evaluateEndState(curState);
+    for (auto it = t.searchStack.rbegin(); it != t.searchStack.rend(); ++it) {
+        __atomic_fetch_add(&s.stats.simulationCount[*it], 1, __ATOMIC_RELAXED);
+        addRelaxed(s.stats.evaluationSum[*it], evaluation);
+        if (*it != search::BattleScumSearcher2::ROOT_IDX) {
+            __atomic_fetch_sub(&s.stats.virtualLoss[*it], 1, __ATOMIC_RELAXED);
+        }
+        const auto transpositionIdx = loadRelaxed(s.getNode(*it).transpositionIdx);
+        if (transpositionIdx != search::TranspositionTable::INVALID_IDX) {
+            s.transpositionTable->update(transpositionIdx, evaluation);
+        }
+    }
+    arenaLock.unlock();
+
+    updateSharedResults(s, shared, t.actionStack, curState, evaluation);
+    timer.lap(t.stats.backpropTime);
+#ifdef sts_search_stats
+    t.stats.addSimulation(treeDepth, static_cast<std::int64_t>(t.actionStack.size()) - treeActionCount,
+                          curState.loopCount - s.rootState->loopCount);
+#endif
+}
+
+// every thread runs whole simulations on the one tree, with atomic statistics and a virtual loss on the path it's
+// searching. which thread gets to a node first depends on timing, so unlike the root parallel search this isn't
+// deterministic
+void search::BattleScumSearcher2::searchTreeParallel(int64_t simulations, int threadCount) {
+    assignTransposition(ROOT_IDX, *rootState);
+
+    TreeSearchShared shared;
+    shared.simulationsLeft = simulations;
+    shared.hasResult = !bestActionSequence.empty();
+
+    std::vector<std::unique_ptr<TreeSearchThread>> threadInfos;
+    for (int t = 0; t < threadCount; ++t) {
+        threadInfos.emplace_back(new TreeSearchThread);
+        threadInfos.back()->randGen = t == 0 ? randGen : getThreadRandGen(*rootState, t);
+    }
+
+    const auto work = [&](TreeSearchThread &info) {
+        g_debug_scum_search = this;
+        while (!shared.stop.load(std::memory_order_relaxed) && shared.simulationsLeft.fetch_sub(1, std::memory_order_relaxed) > 0) {
+            if (canStopSharedSearch(*this, info)) {
+                shared.stop = true;
+                break;
+            }
+            stepShared(*this, shared, info);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < threadCount; ++t) {
+        threads.emplace_back(work, std::ref(*threadInfos[t]));
+    }
+    work(*threadInfos[0]);
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    randGen = threadInfos[0]->randGen;
+    for (auto &info : threadInfos) {
+        searchStats.add(info->stats);
+    }
+}
+
 void search::BattleScumSearcher2::step() {
-    searchStack = {&root};
+    SearchPhaseTimer timer;
+    searchStack = {ROOT_IDX};
     actionStack.clear();
-    BattleContext curState;
-    curState = *rootState;
+    auto &curState = *stepState;
+    rootState->clone_into(curState);
 
     while (true) {
-        auto &curNode = *searchStack.back();
+        const auto curIdx = searchStack.back();
 
         if (isTerminalState(curState)) {
+            timer.lap(searchStats.selectionTime);
             updateFromPlayout(searchStack, actionStack, curState);
+            timer.lap(searchStats.backpropTime);
+#ifdef sts_search_stats
+            searchStats.addSimulation(static_cast<std::int64_t>(searchStack.size()-1), 0, curState.loopCount - rootState->loopCount);
+#endif
             return;
         }
 
-        const bool isLeaf = curNode.edges.empty();
+        const auto &curNode = getNode(curIdx);
+        const bool isLeaf = curNode.edgeCount == 0;
         if (isLeaf) {
+            timer.lap(searchStats.selectionTime);
+            [[maybe_unused]] const auto treeDepth = static_cast<std::int64_t>(searchStack.size()-1);
 
             ++simulationIdx;
-            enumerateActionsForNode(curNode, curState);
-            const auto selectIdx = selectFirstActionForLeafNode(curNode);
-            auto &edgeTaken = curNode.edges[selectIdx];
-
-//            edgeTaken.action.printDesc(std::cout, curState) << std::endl;
-            edgeTaken.action.execute(curState);
+            actionBuffer.clear();
+            enumerateActionsForNode(actionBuffer, curState);
+            orderLeafActions(actionBuffer);
+            const auto openEdgeCount = getOpenEdgeCount(getSimulationCount(curIdx), static_cast<int>(actionBuffer.size()));
+            const auto selectIdx = selectFirstActionForLeafNode(openEdgeCount);
+            const auto action = actionBuffer[selectIdx];
+
+//            action.printDesc(std::cout, curState) << std::endl;
+            action.execute(curState);
+
+            actionStack.push_back(action);
+            if (expandNode(curIdx, actionBuffer, openEdgeCount)) {
+                searchStack.push_back(getNode(curIdx).edgeBegin + selectIdx);
+                assignTransposition(searchStack.back(), curState);
+            }
+            timer.lap(searchStats.expansionTime);
 
-            actionStack.push_back(edgeTaken.action);
-            searchStack.push_back(&edgeTaken.node);
+            [[maybe_unused]] const auto treeActionCount = static_cast<std::int64_t>(actionStack.size());
+            playout(curState, actionStack, randGen);
+            timer.lap(searchStats.rolloutTime);
 
-            playoutRandom(curState, actionStack);
             updateFromPlayout(searchStack, actionStack, curState);
+            timer.lap(searchStats.backpropTime);
+#ifdef sts_search_stats
+            searchStats.addSimulation(treeDepth, static_cast<std::int64_t>(actionStack.size()) - treeActionCount,
+                                      curState.loopCount - rootState->loopCount);
+#endif
             return;
 
         } else {
-            const auto selectIdx = selectBestEdgeToSearch(curNode);
-            auto &edgeTaken = curNode.edges[selectIdx];
+            widenNode(curIdx, curState); // can move the edges of the node
+            const auto edgeIdx = getNode(curIdx).edgeBegin + selectBestEdgeToSearch(curIdx);
+            const auto action = tree[edgeIdx].action;
 
-//            edgeTaken.action.printDesc(std::cout, curState) << std::endl;
-            edgeTaken.action.execute(curState);
+//            action.printDesc(std::cout, curState) << std::endl;
+            action.execute(curState);
 
-            actionStack.push_back(edgeTaken.action);
-            searchStack.push_back(&edgeTaken.node);
+            actionStack.push_back(action);
+            searchStack.push_back(edgeIdx);
+            assignTransposition(edgeIdx, curState);
         }
     }
 }
 
-void search::BattleScumSearcher2::updateFromPlayout(const std::vector<Node *> &stack, const std::vector<Action> &actionStack, const BattleContext &endState) {
+void search::BattleScumSearcher2::assignTransposition(std::uint32_t nodeIdx, const BattleContext &bc) {
+    if (transpositionTable && getNode(nodeIdx).transpositionIdx == TranspositionTable::INVALID_IDX) {
+        getNode(nodeIdx).transpositionIdx = transpositionTable->findOrInsert(getBattleStateHash(bc));
+    }
+}
+
+// appends edges for the first edgeCount actions to the arena as the children of the node,
+// returns false if that would go over treeMemoryLimit.
+// if the node already has edges they must be for the first actions, they are moved with their subtrees
+bool search::BattleScumSearcher2::expandNode(std::uint32_t nodeIdx, const std::vector<Action> &actions, int edgeCount) {
+    const auto maxEdges = std::min<std::size_t>(treeMemoryLimit / EDGE_MEMORY, std::numeric_limits<std::uint32_t>::max());
+    const auto newSize = tree.size() + edgeCount;
+    if (newSize > maxEdges) {
+        return false;
+    }
+
+    if (newSize > tree.capacity()) {
+        const auto capacity = std::min(std::max(newSize, tree.capacity()*2), maxEdges);
+        tree.reserve(capacity);
+        stats.reserve(capacity);
+    }
+
+    auto &node = getNode(nodeIdx);
+    const auto oldEdgeBegin = node.edgeBegin;
+    const auto oldEdgeCount = static_cast<int>(node.edgeCount);
+    node.edgeBegin = static_cast<std::uint32_t>(tree.size());
+    node.edgeCount = static_cast<std::uint16_t>(edgeCount);
+    node.actionCount = std::max(node.actionCount, static_cast<std::uint16_t>(actions.size()));
+
+    for (int i = 0; i < oldEdgeCount; ++i) {
+        appendEdge(oldEdgeBegin + i);
+    }
+    for (int i = oldEdgeCount; i < edgeCount; ++i) {
+        tree.push_back({actions[i]});
+        stats.push_back(0, 0);
+    }
+    return true;
+}
+
+// the capacity must already be reserved, so the references into the arena stay valid
+void search::BattleScumSearcher2::appendEdge(std::uint32_t srcIdx) {
+    tree.push_back(tree[srcIdx]);
+    stats.push_back(stats.simulationCount[srcIdx], stats.evaluationSum[srcIdx]);
+}
+
+// adds edges to the node once its simulation count opens more than it has, bc is the node's state.
+// the old edges are left unused in the arena until the tree is reset or rerooted
+void search::BattleScumSearcher2::widenNode(std::uint32_t nodeIdx, const BattleContext &bc) {
+    const auto &node = getNode(nodeIdx);
+    if (node.edgeCount >= node.actionCount) {
+        return;
+    }
+
+    const auto openEdgeCount = getOpenEdgeCount(getSimulationCount(nodeIdx), node.actionCount);
+    if (openEdgeCount <= node.edgeCount) {
+        return;
+    }
+
+    // growing geometrically bounds how often a node's edges are moved, selection still only sees the open edges
+    const auto edgeCount = std::min<int>(node.actionCount, std::max<int>(openEdgeCount, node.edgeCount * 2));
+    actionBuffer.clear();
+    enumerateActionsForNode(actionBuffer, bc);
+    orderLeafActions(actionBuffer);
+    expandNode(nodeIdx, actionBuffer, edgeCount);
+}
+
+// endState is only undecided if the playout was pruned. it couldn't beat bestActionValue, and backing up its upper
+// bound would inflate the edges it passed, so it is scored as a loss from where it stopped
+void search::BattleScumSearcher2::updateFromPlayout(const std::vector<std::uint32_t> &stack, const std::vector<Action> &actionStack, const BattleContext &endState) {
     const auto evaluation = evaluateEndState(endState);
 
+    ++simulationsSinceImprovement;
     if (evaluation > bestActionValue) {
         bestActionSequence = actionStack;
         bestActionValue = evaluation;
         outcomePlayerHp = endState.player.curHp;
+        simulationsSinceImprovement = 0;
+
+        foundOptimalSolution = !rootCanRecover &&
+                endState.outcome == Outcome::PLAYER_VICTORY &&
+                endState.player.curHp >= rootState->player.curHp &&
+                endState.potionCount >= rootState->potionCount;
     }
 
     if (evaluation < minActionValue) {
@@ -99,90 +850,284 @@ void search::BattleScumSearcher2::updateFromPlayout(const std::vector<Node *> &s
     }
 
     for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
-        auto &node = *(*it);
-        ++node.simulationCount;
-        node.evaluationSum += evaluation;
+        ++stats.simulationCount[*it];
+        stats.evaluationSum[*it] += evaluation;
+        const auto transpositionIdx = getNode(*it).transpositionIdx;
+        if (transpositionIdx != TranspositionTable::INVALID_IDX) {
+            transpositionTable->update(transpositionIdx, evaluation);
+        }
     }
 }
 
-bool search::BattleScumSearcher2::isTerminalState(const BattleContext &bc) const { // maybe can optimize by making this evaluate directly if score cannot possibly be higher than best
+bool search::BattleScumSearcher2::isTerminalState(const BattleContext &bc) const {
     return bc.outcome != Outcome::UNDECIDED;
 }
 
-double search::BattleScumSearcher2::evaluateEdge(const search::BattleScumSearcher2::Node &parent, int edgeIdx) {
+bool search::BattleScumSearcher2::canStopSearch() {
+    if (isPastDeadline() || (stopOnOptimalSolution && foundOptimalSolution)) {
+        return true;
+    }
+    const bool hasWin = outcomePlayerHp > 0;
+    return stableSimulationLimit > 0 && hasWin && simulationsSinceImprovement >= stableSimulationLimit;
+}
+
+bool search::BattleScumSearcher2::isPastDeadline() {
+    if (deadline == SearchClock::time_point::max()) {
+        return false;
+    }
+    return deadlineCheckCount++ % DEADLINE_CHECK_INTERVAL == 0 && SearchClock::now() >= deadline;
+}
+
+// hp and potions only go down during a playout unless rootCanRecover, and the turn only goes up
+double search::BattleScumSearcher2::getPlayoutUpperBound(const BattleContext &bc) const {
+    if (rootCanRecover) {
+        return std::numeric_limits<double>::max();
+    }
+    return 100 * (35 + bc.player.curHp + bc.potionCount * 4 - (bc.turn * 0.01));
+}
+
+bool search::BattleScumSearcher2::canPrunePlayout(const BattleContext &bc) const {
+    return prunePlayouts && getPlayoutUpperBound(bc) <= loadRelaxed(bestActionValue); // written by other threads in a tree parallel search
+}
+
+double search::BattleScumSearcher2::evaluateEdge(std::uint32_t parentIdx, int edgeIdx) {
+
+    const auto nodeIdx = getNode(parentIdx).edgeBegin + edgeIdx;
 
-    const auto &edge = parent.edges[edgeIdx];
+    const auto edgeVisits = getSimulationCount(nodeIdx);
+    const auto parentVisits = getSimulationCount(parentIdx);
 
     double qualityValue = 0;
     if (!bestActionSequence.empty()) {
-        auto avgEvaluation = edge.node.evaluationSum / (edge.node.simulationCount+1);
+        auto avgEvaluation = getEvaluationSum(nodeIdx) / (edgeVisits+1);
         double evalRange = bestActionValue - minActionValue;
         qualityValue = avgEvaluation / evalRange;
     }
 
     double explorationValue = explorationParameter *
-            std::sqrt(std::log(parent.simulationCount+1) / (edge.node.simulationCount+1));
+            std::sqrt(std::log(parentVisits+1) / (edgeVisits+1));
 
     return qualityValue + explorationValue;
 }
 
-int search::BattleScumSearcher2::selectBestEdgeToSearch(const search::BattleScumSearcher2::Node &cur) {
-    if (cur.edges.size() == 1) {
+// the terms needed to score the edges of one node, the same for all of them
+struct UcbParams {
+    bool useQuality;
+    double evalRange;
+    double logParentVisits;
+    double explorationParameter;
+};
+
+// scores count edges from the statistics arrays the same way as evaluateEdge, with the log of the parent's visits
+// taken once. the operations are in the same order in both kernels so the scores are bit for bit equal
+static void scoreEdgesScalar(const std::int64_t *simulationCounts, const double *evaluationSums,
+                             int count, const UcbParams &p, double *scores) {
+    for (int i = 0; i < count; ++i) {
+        const auto visits = static_cast<double>(simulationCounts[i] + 1);
+        const double qualityValue = p.useQuality ? evaluationSums[i] / visits / p.evalRange : 0;
+        scores[i] = qualityValue + p.explorationParameter * std::sqrt(p.logParentVisits / visits);
+    }
+}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define STS_AVX2_SELECTION
+
+__attribute__((target("avx2")))
+static void scoreEdgesAvx2(const std::int64_t *simulationCounts, const double *evaluationSums,
+                           int count, const UcbParams &p, double *scores) {
+    // an integer below 2^52 or'ed into the mantissa of 2^52 is 2^52 plus the integer
+    const auto magicBits = _mm256_set1_epi64x(0x4330000000000000);
+    const auto magic = _mm256_set1_pd(4503599627370496.0);
+    const auto one = _mm256_set1_pd(1);
+    const auto evalRange = _mm256_set1_pd(p.evalRange);
+    const auto logParentVisits = _mm256_set1_pd(p.logParentVisits);
+    const auto explorationParameter = _mm256_set1_pd(p.explorationParameter);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const auto simulations = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(simulationCounts + i));
+        const auto visitBits = _mm256_or_si256(simulations, magicBits);
+        const auto visits = _mm256_add_pd(_mm256_sub_pd(_mm256_castsi256_pd(visitBits), magic), one);
+
+        auto qualityValue = _mm256_setzero_pd();
+        if (p.useQuality) {
+            qualityValue = _mm256_div_pd(_mm256_div_pd(_mm256_loadu_pd(evaluationSums + i), visits), evalRange);
+        }
+        const auto explorationValue = _mm256_mul_pd(explorationParameter, _mm256_sqrt_pd(_mm256_div_pd(logParentVisits, visits)));
+        _mm256_storeu_pd(scores + i, _mm256_add_pd(qualityValue, explorationValue));
+    }
+    scoreEdgesScalar(simulationCounts + i, evaluationSums + i, count - i, p, scores + i);
+}
+
+static bool cpuHasAvx2() {
+    static const bool hasAvx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return hasAvx2;
+}
+#endif
+
+int search::BattleScumSearcher2::selectBestEdgeToSearch(std::uint32_t nodeIdx) {
+    const auto &cur = getNode(nodeIdx);
+    const auto edgeCount = getOpenEdgeCount(getSimulationCount(nodeIdx), static_cast<int>(cur.edgeCount));
+    if (edgeCount == 1) {
         return 0;
     }
 
-    auto bestEdge = 0;
-    auto bestEdgeValue = evaluateEdge(cur, bestEdge);
+    // with a transposition table the statistics of a node can be in the table, so the edges are scored one by one
+    if (transpositionTable) {
+        auto bestEdge = 0;
+        auto bestEdgeValue = evaluateEdge(nodeIdx, bestEdge);
 
-    for (int i = 1; i < cur.edges.size(); ++i) {
-        const auto value = evaluateEdge(cur, i);
-        if (value > bestEdgeValue) {
-            bestEdge = i;
-            bestEdgeValue = value;
+        for (int i = 1; i < edgeCount; ++i) {
+            const auto value = evaluateEdge(nodeIdx, i);
+            if (value > bestEdgeValue) {
+                bestEdge = i;
+                bestEdgeValue = value;
+            }
+        }
+        return bestEdge;
+    }
+
+    const auto parentVisits = stats.simulationCount[nodeIdx];
+    const UcbParams params {
+        !bestActionSequence.empty(),
+        bestActionValue - minActionValue,
+        std::log(parentVisits+1),
+        explorationParameter
+    };
+
+#ifdef STS_AVX2_SELECTION
+    const auto scoreEdges = simdSelection && cpuHasAvx2() ? &scoreEdgesAvx2 : &scoreEdgesScalar;
+#else
+    const auto scoreEdges = &scoreEdgesScalar;
+#endif
+
+    // scored in chunks on the stack, the first edge with the highest score wins like in the one by one loop
+    constexpr int CHUNK_SIZE = 64;
+    double scores[CHUNK_SIZE];
+
+    auto bestEdge = 0;
+    double bestEdgeValue = 0;
+    for (int chunkBegin = 0; chunkBegin < edgeCount; chunkBegin += CHUNK_SIZE) {
+        const auto chunkSize = std::min(CHUNK_SIZE, edgeCount - chunkBegin);
+        const auto idx = cur.edgeBegin + chunkBegin;
+        scoreEdges(&stats.simulationCount[idx], &stats.evaluationSum[idx], chunkSize, params, scores);
+
+        int i = 0;
+        if (chunkBegin == 0) {
+            bestEdgeValue = scores[0];
+            i = 1;
+        }
+        for (; i < chunkSize; ++i) {
+            if (scores[i] > bestEdgeValue) {
+                bestEdge = chunkBegin + i;
+                bestEdgeValue = scores[i];
+            }
         }
     }
     return bestEdge;
 }
 
-int search::BattleScumSearcher2::selectFirstActionForLeafNode(const search::BattleScumSearcher2::Node &leafNode) {
-    auto dist = std::uniform_int_distribution<int>(0, static_cast<int>(leafNode.edges.size())-1);
+int search::BattleScumSearcher2::getOpenEdgeCount(std::int64_t simulationCount, int edgeCount) const {
+    if (!progressiveWidening) {
+        return edgeCount;
+    }
+    const auto openCount = static_cast<int>(std::ceil(wideningConstant * std::pow(simulationCount+1, wideningExponent)));
+    return std::clamp(openCount, 1, edgeCount);
+}
+
+void search::BattleScumSearcher2::orderLeafActions(std::vector<Action> &actions) const {
+    if (progressiveWidening && !actions.empty() && actions.back().getActionType() == ActionType::END_TURN) {
+        std::rotate(actions.begin(), actions.end()-1, actions.end());
+    }
+}
+
+int search::BattleScumSearcher2::selectFirstActionForLeafNode(int edgeCount) {
+    auto dist = std::uniform_int_distribution<int>(0, edgeCount-1);
     return dist(randGen);
 }
 
+void search::BattleScumSearcher2::playout(BattleContext &state, std::vector<Action> &actionStack, std::default_random_engine &rng) {
+    if (rolloutPolicy == RolloutPolicy::RANDOM) {
+        playoutRandom(state, actionStack, rng);
+    } else {
+        playoutGuided(state, actionStack, rng);
+    }
+}
+
 void search::BattleScumSearcher2::playoutRandom(BattleContext &state, std::vector<Action> &actionStack) {
-    Node tempNode; // temp
-    while (!isTerminalState(state)) {
+    playoutRandom(state, actionStack, randGen);
+}
+
+// the actions are enumerated into a list on the stack, so a playout doesn't allocate
+void search::BattleScumSearcher2::playoutRandom(BattleContext &state, std::vector<Action> &actionStack, std::default_random_engine &rng) {
+    ActionList actions;
+    while (!isTerminalState(state) && !canPrunePlayout(state)) {
         ++simulationIdx;
-        enumerateActionsForNode(tempNode, state);
-        if (tempNode.edges.empty()) {
+        enumerateActionsForNode(actions, state);
+        if (actions.empty()) {
             std::cerr << state.seed << " " << simulationIdx << std::endl;
             std::cerr << state.monsters.arr[0].getName() << " " << state.floorNum << " " << monsterEncounterStrings[static_cast<int>(state.encounter)] << std::endl;
             assert(false);
         }
 
-        auto dist = std::uniform_int_distribution<int>(0, static_cast<int>(tempNode.edges.size())-1);
-        const int selectedIdx = dist(randGen);
+        auto dist = std::uniform_int_distribution<int>(0, static_cast<int>(actions.size())-1);
+        const int selectedIdx = dist(rng);
 
-        const auto action = tempNode.edges[selectedIdx].action;
+        const auto action = actions[selectedIdx];
 //        action.printDesc(std::cout, state) << std::endl;
         actionStack.push_back(action);
         action.execute(state);
 
-        tempNode.edges.clear();
+        actions.clear();
+    }
+}
+
+// the card actions are enumerated in Expert::getPlayOrdering order, so the expert policy takes the first one
+void search::BattleScumSearcher2::playoutGuided(BattleContext &state, std::vector<Action> &actionStack, std::default_random_engine &rng) {
+    const SimpleAgent agent {};
+    std::uniform_real_distribution<double> exploreDist(0, 1);
+
+    ActionList actions;
+    while (!isTerminalState(state) && !canPrunePlayout(state)) {
+        ++simulationIdx;
+        const bool explore = rolloutEpsilon > 0 && exploreDist(rng) < rolloutEpsilon;
+        const bool guided = state.inputState == InputState::PLAYER_NORMAL && !explore;
+
+        Action action;
+        if (guided && rolloutPolicy == RolloutPolicy::SIMPLE_AGENT) {
+            action = agent.getBattleCardPlayAction(state);
+
+        } else {
+            actions.clear();
+            enumerateActionsForNode(actions, state);
+#ifdef sts_asserts
+            assert(!actions.empty());
+#endif
+            if (guided) {
+                action = actions.front().getActionType() == ActionType::CARD ? actions.front() : Action(ActionType::END_TURN);
+            } else {
+                auto dist = std::uniform_int_distribution<int>(0, static_cast<int>(actions.size())-1);
+                action = actions[dist(rng)];
+            }
+        }
+
+        actionStack.push_back(action);
+        action.execute(state);
     }
 }
 
-void search::BattleScumSearcher2::enumerateActionsForNode(search::BattleScumSearcher2::Node &node,
+template <typename ActionContainer>
+void search::BattleScumSearcher2::enumerateActionsForNode(ActionContainer &actions,
                                                                const BattleContext &bc) {
     switch (bc.inputState) {
         case InputState::PLAYER_NORMAL:
-            enumerateCardActions(node, bc);
-            enumeratePotionActions(node, bc);
-            node.edges.push_back({Action(ActionType::END_TURN)});
+            enumerateCardActions(actions, bc);
+            enumeratePotionActions(actions, bc);
+            actions.push_back(Action(ActionType::END_TURN));
             break;
 
         case InputState::CARD_SELECT:
-            enumerateCardSelectActions(node, bc);
+            enumerateCardSelectActions(actions, bc);
             break;
 
         default:
@@ -194,20 +1139,34 @@ void search::BattleScumSearcher2::enumerateActionsForNode(search::BattleScumSear
     }
 
 #ifdef sts_print_debug
-    std::cout << "{ (" << node.edges.size() << ") ";
-    for (int i = 0; i < node.edges.size(); ++i) {
-        node.edges[i].action.printDesc(std::cout, bc) << ", ";
+    std::cout << "{ (" << actions.size() << ") ";
+    for (int i = 0; i < actions.size(); ++i) {
+        actions[i].printDesc(std::cout, bc) << ", ";
     }
     std::cout << " }" << std::endl;
 #endif
 }
 
-void search::BattleScumSearcher2::enumerateCardActions(search::BattleScumSearcher2::Node &node,
+static bool isEquivalentCardPlay(const CardInstance &a, const CardInstance &b) {
+    return a.id == b.id &&
+        a.getUpgradeCount() == b.getUpgradeCount() &&
+        // both should be less than deck size c.uniqueId < bc.cards.deck
+        a.costForTurn == b.costForTurn &&
+        a.cost == b.cost &&
+        a.freeToPlayOnce == b.freeToPlayOnce &&
+        a.retain == b.retain &&
+        a.specialData == b.specialData;
+}
+
+template <typename ActionContainer>
+void search::BattleScumSearcher2::enumerateCardActions(ActionContainer &actions,
                                                             const BattleContext &bc) {
     if (!bc.isCardPlayAllowed()) {
         return;
     }
 
+    // playing either of two adjacent identical cards leaves the same hand, so the second is skipped. identical cards
+    // further apart aren't, the rest of the hand would be in a different order and random hand effects read it
     fixed_list<std::pair<int,int>, 10> playableHandIdxs;
     for (int handIdx = 0; handIdx < bc.cards.cardsInHand; ++handIdx) {
         const auto &c = bc.cards.hand[handIdx];
@@ -215,24 +1174,7 @@ void search::BattleScumSearcher2::enumerateCardActions(search::BattleScumSearche
             continue;
         }
 
-        bool isUniqueAction = true;
-
-        if (handIdx > 0) {
-            const auto &lastCard = bc.cards.hand[handIdx-1];
-
-            bool isEqualToLastCard = c.id == lastCard.id &&
-                    c.getUpgradeCount() == lastCard.getUpgradeCount() &&
-                    // both should be less than deck size c.uniqueId < bc.cards.deck
-                    c.costForTurn == lastCard.costForTurn &&
-                    c.cost == lastCard.cost &&
-                    c.freeToPlayOnce == lastCard.freeToPlayOnce &&
-                    c.specialData == lastCard.specialData;
-
-            if (isEqualToLastCard) {
-                isUniqueAction = false;
-            }
-        }
-
+        const bool isUniqueAction = handIdx == 0 || !isEquivalentCardPlay(c, bc.cards.hand[handIdx-1]);
         if (isUniqueAction) {
             playableHandIdxs.push_back( {handIdx, search::Expert::getPlayOrdering(c.getId())} );
         }
@@ -249,16 +1191,17 @@ void search::BattleScumSearcher2::enumerateCardActions(search::BattleScumSearche
                 if (!bc.monsters.arr[tIdx].isTargetable()) {
                     continue;
                 }
-                node.edges.push_back({Action(ActionType::CARD, handIdx, tIdx)});
+                actions.push_back(Action(ActionType::CARD, handIdx, tIdx));
             }
         } else {
-            node.edges.push_back({Action(ActionType::CARD, handIdx)});
+            actions.push_back(Action(ActionType::CARD, handIdx));
         }
     }
 
 }
 
-void search::BattleScumSearcher2::enumeratePotionActions(search::BattleScumSearcher2::Node &node,
+template <typename ActionContainer>
+void search::BattleScumSearcher2::enumeratePotionActions(ActionContainer &actions,
                                                               const BattleContext &bc) {
 
     const auto hasValidTarget = bc.monsters.getTargetableCount() > 0;
@@ -272,100 +1215,110 @@ void search::BattleScumSearcher2::enumeratePotionActions(search::BattleScumSearc
         }
         ++foundPotions;
 
+        // the same potion in another slot leads to the same state
+        if (std::find(bc.potions.begin(), bc.potions.begin() + pIdx, p) != bc.potions.begin() + pIdx) {
+            continue;
+        }
+
         // not enumerating the discard of a potion if it can be used
         if (p == Potion::FAIRY_POTION) {
-            node.edges.push_back({Action(ActionType::POTION, pIdx, -1)});
+            actions.push_back(Action(ActionType::POTION, pIdx, -1));
             continue;
         }
 
         if (!potionRequiresTarget(p)) {
-            node.edges.push_back({Action(ActionType::POTION, pIdx)});
+            actions.push_back(Action(ActionType::POTION, pIdx));
             continue;
         }
 
         // potion requires target
         if (!hasValidTarget) {
-            node.edges.push_back({Action(ActionType::POTION, pIdx, -1)});
+            actions.push_back(Action(ActionType::POTION, pIdx, -1));
             continue;
         }
 
         // there is a valid target
         for (int tIdx = 0; tIdx < bc.monsters.monsterCount; ++tIdx) {
             if (bc.monsters.arr[tIdx].isTargetable()) {
-                node.edges.push_back({Action(ActionType::POTION, pIdx, tIdx)});
+                actions.push_back(Action(ActionType::POTION, pIdx, tIdx));
             }
         }
     }
 }
 
-template <typename ForwardIt>
-void setupCardOptionsHelper(search::BattleScumSearcher2::Node &node, const ForwardIt begin, const ForwardIt end, const std::function<bool(const CardInstance &)> &p= nullptr) {
+template <typename ActionContainer, typename ForwardIt>
+void setupCardOptionsHelper(ActionContainer &actions, const ForwardIt begin, const ForwardIt end) {
+    for (int i = 0; begin+i != end; ++i) {
+        actions.push_back(search::Action(search::ActionType::SINGLE_CARD_SELECT, i));
+    }
+}
+
+template <typename ActionContainer, typename ForwardIt, typename Predicate>
+void setupCardOptionsHelper(ActionContainer &actions, const ForwardIt begin, const ForwardIt end, const Predicate &p) {
     for (int i = 0; begin+i != end; ++i) {
-        const auto &c = begin[i];
-        if (!p || (p(c))) {
-            node.edges.push_back(
-                    {search::Action(search::ActionType::SINGLE_CARD_SELECT, i)}
-                );
+        if (p(begin[i])) {
+            actions.push_back(search::Action(search::ActionType::SINGLE_CARD_SELECT, i));
         }
     }
 }
 
-void search::BattleScumSearcher2::enumerateCardSelectActions(search::BattleScumSearcher2::Node &node,
+template <typename ActionContainer>
+void search::BattleScumSearcher2::enumerateCardSelectActions(ActionContainer &actions,
                                                                   const BattleContext &bc) {
 
     switch (bc.cardSelectInfo.cardSelectTask) {
         case CardSelectTask::ARMAMENTS:
-            setupCardOptionsHelper( node, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand,
+            setupCardOptionsHelper( actions, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand,
                                     [] (const CardInstance &c) { return c.canUpgrade(); });
             break;
 
         case CardSelectTask::CODEX:
             for (int i = 0; i < 4; ++i) { // i -> 3 action means skip
-                node.edges.push_back({Action(search::ActionType::SINGLE_CARD_SELECT, i)});
+                actions.push_back(Action(search::ActionType::SINGLE_CARD_SELECT, i));
             }
             break;
 
         case CardSelectTask::DISCOVERY:
             for (int i = 0; i < 3; ++i) {
-                node.edges.push_back({Action(search::ActionType::SINGLE_CARD_SELECT, i)});
+                actions.push_back(Action(search::ActionType::SINGLE_CARD_SELECT, i));
             }
             break;
 
         case CardSelectTask::DUAL_WIELD:
-            setupCardOptionsHelper( node, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand,
+            setupCardOptionsHelper( actions, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand,
                                     [] (const CardInstance &c) {
                                         return c.getType() == CardType::POWER || c.getType() == CardType::ATTACK;
                                     });
             break;
 
         case CardSelectTask::EXHUME:
-            setupCardOptionsHelper(node, bc.cards.exhaustPile.begin(), bc.cards.exhaustPile.end(),
+            setupCardOptionsHelper(actions, bc.cards.exhaustPile.begin(), bc.cards.exhaustPile.end(),
                                    [](const auto &c) { return c.getId() != CardId::EXHUME; });
             break;
 
         case CardSelectTask::EXHAUST_ONE:
-            setupCardOptionsHelper(node, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand);
+            setupCardOptionsHelper(actions, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand);
             break;
 
         case CardSelectTask::FORETHOUGHT:
         case CardSelectTask::WARCRY:
-            setupCardOptionsHelper(node, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand);
+            setupCardOptionsHelper(actions, bc.cards.hand.begin(), bc.cards.hand.begin() + bc.cards.cardsInHand);
             break;
 
         case CardSelectTask::HEADBUTT:
         case CardSelectTask::LIQUID_MEMORIES_POTION:
-            setupCardOptionsHelper(node, bc.cards.discardPile.begin(), bc.cards.discardPile.end());
+            setupCardOptionsHelper(actions, bc.cards.discardPile.begin(), bc.cards.discardPile.end());
             break;
 
         case CardSelectTask::SECRET_TECHNIQUE:
-            setupCardOptionsHelper(node, bc.cards.drawPile.begin(), bc.cards.drawPile.end(),
+            setupCardOptionsHelper(actions, bc.cards.drawPile.begin(), bc.cards.drawPile.end(),
                                     [] (const CardInstance &c) {
                                         return c.getType() == CardType::SKILL;
                                     });
             break;
 
         case CardSelectTask::SECRET_WEAPON:
-            setupCardOptionsHelper(node, bc.cards.drawPile.begin(), bc.cards.drawPile.end(),
+            setupCardOptionsHelper(actions, bc.cards.drawPile.begin(), bc.cards.drawPile.end(),
                                     [] (const CardInstance &c) {
                                         return c.getType() == CardType::ATTACK;
                                     });
@@ -374,7 +1327,7 @@ void search::BattleScumSearcher2::enumerateCardSelectActions(search::BattleScumS
         case CardSelectTask::EXHAUST_MANY:
         case CardSelectTask::GAMBLE:
             // just dont deal with this right now
-            node.edges.push_back({search::Action(search::ActionType::MULTI_CARD_SELECT, 0)});
+            actions.push_back(search::Action(search::ActionType::MULTI_CARD_SELECT, 0));
             break;
 
         default:
@@ -385,6 +1338,9 @@ void search::BattleScumSearcher2::enumerateCardSelectActions(search::BattleScumS
     }
 }
 
+template void search::BattleScumSearcher2::enumerateActionsForNode(std::vector<search::Action> &actions, const BattleContext &bc);
+template void search::BattleScumSearcher2::enumerateActionsForNode(search::ActionList &actions, const BattleContext &bc);
+
 double getNonMinionMonsterCurHpRatio(const BattleContext &bc) {
     int curHpTotal = 0;
     int maxHpTotal = 0;
@@ -404,6 +1360,54 @@ double getNonMinionMonsterCurHpRatio(const BattleContext &bc) {
     return (double)curHpTotal / maxHpTotal;
 }
 
+// cards, potions and relics that can raise the player's hp or potion count in a battle, or make cards or potions that can.
+// these follow the calls to Player::heal, increaseMaxHp and gainGold (Bloody Idol heals on gold gained)
+static constexpr CardId recoveryCards[] {
+    CardId::REAPER, CardId::FEED, CardId::BITE, CardId::BANDAGE_UP, CardId::ALCHEMIZE,
+    CardId::INFERNAL_BLADE, CardId::METAMORPHOSIS, CardId::DISCOVERY, CardId::JACK_OF_ALL_TRADES,
+    CardId::TRANSMUTATION, CardId::MAGNETISM, CardId::HAND_OF_GREED,
+};
+static constexpr Potion recoveryPotions[] {
+    Potion::BLOOD_POTION, Potion::FRUIT_JUICE, Potion::REGEN_POTION, Potion::FAIRY_POTION,
+    Potion::ENTROPIC_BREW, Potion::ATTACK_POTION, Potion::COLORLESS_POTION,
+};
+static constexpr RelicId recoveryRelics[] {
+    RelicId::BIRD_FACED_URN, RelicId::LIZARD_TAIL, RelicId::TOY_ORNITHOPTER,
+    RelicId::DEAD_BRANCH, RelicId::NILRYS_CODEX, RelicId::TOOLBOX, RelicId::BLOODY_IDOL,
+    RelicId::DARKSTONE_PERIAPT, // a curse from writhing mass raises max hp
+};
+
+template <typename ForwardIt>
+static bool containsRecoveryCard(ForwardIt begin, ForwardIt end) {
+    return std::any_of(begin, end, [](const CardInstance &c) {
+        return std::find(std::begin(recoveryCards), std::end(recoveryCards), c.getId()) != std::end(recoveryCards);
+    });
+}
+
+bool search::BattleScumSearcher2::canRecoverDuringBattle(const BattleContext &bc) {
+    const auto &cards = bc.cards;
+    if (containsRecoveryCard(cards.hand.begin(), cards.hand.begin() + cards.cardsInHand) ||
+        containsRecoveryCard(cards.drawPile.begin(), cards.drawPile.end()) ||
+        containsRecoveryCard(cards.discardPile.begin(), cards.discardPile.end()) ||
+        containsRecoveryCard(cards.exhaustPile.begin(), cards.exhaustPile.end())) {
+        return true;
+    }
+
+    if (bc.player.hasStatus<PS::REGEN>()) {
+        return true;
+    }
+
+    for (int i = 0; i < bc.potionCapacity; ++i) {
+        if (std::find(std::begin(recoveryPotions), std::end(recoveryPotions), bc.potions[i]) != std::end(recoveryPotions)) {
+            return true;
+        }
+    }
+
+    return std::any_of(std::begin(recoveryRelics), std::end(recoveryRelics), [&](RelicId r) {
+        return bc.player.hasRelicRuntime(r);
+    });
+}
+
 double search::BattleScumSearcher2::evaluateEndState(const BattleContext &bc) {
     double potionScore = bc.potionCount * 4;
 
@@ -428,7 +1432,7 @@ struct LayerStruct {
     int edgeIdx;
 };
 
-typedef std::pair<search::BattleScumSearcher2::Edge, std::unique_ptr<const BattleContext>> EdgeInfo;
+typedef std::pair<std::uint32_t, std::unique_ptr<const BattleContext>> EdgeInfo; // index of the edge in the tree
 
 std::vector<EdgeInfo> getEdgesForLayer(const search::BattleScumSearcher2 &s, int layerNum) {
     if (layerNum <= 0) {
@@ -437,17 +1441,18 @@ std::vector<EdgeInfo> getEdgesForLayer(const search::BattleScumSearcher2 &s, int
 
     std::vector<EdgeInfo> layerEdges;
 
-    std::vector<LayerStruct> curStack { {&s.root, new BattleContext(*s.rootState), 0} };
+    std::vector<LayerStruct> curStack { {&s.root(), new BattleContext(*s.rootState), 0} };
 
     while (!curStack.empty()) {
         if (curStack.size() == layerNum) {
-            for (const auto &edge : curStack.back().node->edges) {
-                layerEdges.emplace_back(edge, new BattleContext(*curStack.back().bc));
+            const auto &node = *curStack.back().node;
+            for (int i = 0; i < node.edgeCount; ++i) {
+                layerEdges.emplace_back(node.edgeBegin+i, new BattleContext(*curStack.back().bc));
             }
         }
 
        // curStack size less than layerNum
-       const bool visitedAll = curStack.back().edgeIdx >= curStack.back().node->edges.size();
+       const bool visitedAll = curStack.back().edgeIdx >= curStack.back().node->edgeCount;
        if (visitedAll || curStack.size() == layerNum) {
            delete curStack.back().bc;
            curStack.pop_back();
@@ -456,12 +1461,13 @@ std::vector<EdgeInfo> getEdgesForLayer(const search::BattleScumSearcher2 &s, int
 
         // visit next edge
         auto &nextIdx = curStack.back().edgeIdx;
-        const auto action = curStack.back().node->edges[nextIdx].action;
+        const auto &nextEdge = s.tree[curStack.back().node->edgeBegin + nextIdx++];
+        const auto action = nextEdge.action;
 
         BattleContext bc(*curStack.back().bc);
         action.execute(bc);
 
-        curStack.push_back( {&curStack.back().node->edges[nextIdx++].node, new BattleContext(bc), 0} );
+        curStack.push_back( {&nextEdge.node, new BattleContext(bc), 0} );
     }
 
     return layerEdges;
@@ -483,8 +1489,8 @@ void search::BattleScumSearcher2::printSearchTree(std::ostream &os, int levels)
 
     for (int depth = 0; depth < levels; ++depth) {
         for (const auto &x : layerEdges[depth]) {
-            os << "(" << x.first.node.simulationCount << ")";
-            x.first.action.printDesc(os, *x.second) << "\t";
+            os << "(" << stats.simulationCount[x.first] << ")";
+            tree[x.first].action.printDesc(os, *x.second) << "\t";
         }
         std::cout << '\n';
     }
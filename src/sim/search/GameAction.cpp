@@ -12,6 +12,11 @@
 
 using namespace sts;
 
+// the card select screen has the most, one action per card in the deck. rewards have at most
+// 2 gold + 5 card rewards of 4 + 3 relics + a key + 5 potions + skip
+static_assert(search::GameAction::MAX_ACTIONS_IN_STATE >= Deck::MAX_SIZE);
+static_assert(search::GameAction::MAX_ACTIONS_IN_STATE >= 2 + 5 * 4 + 3 + 1 + 5 + 1);
+
 search::GameAction::GameAction(std::uint32_t bits) : bits(bits) {}
 search::GameAction::GameAction(int idx1, int idx2) : bits( (idx2 & 0xFF) << 8 | (idx1 & 0xFF) ) {}
 
@@ -477,192 +482,185 @@ void search::GameAction::execute(GameContext &gc) const {
     }
 }
 
-std::vector<search::GameAction> getAllActionsInEventState(const sts::GameContext &gc) {
+static void getAllActionsInEventState(const sts::GameContext &gc, search::GameActionList &actions) {
     // given that gc is in event screen state
-    std::vector<search::GameAction> actions;
-
     auto bits = search::GameAction::getValidEventSelectBits(gc);
     int curIdx = 0;
     while (bits) {
         if (bits & 0x1) {
-            actions.emplace_back(curIdx);
+            actions.push_back(search::GameAction(curIdx));
         }
 
         ++curIdx;
         bits >>= 1;
     }
-
-    return actions;
 }
 
-std::vector<search::GameAction> getAllShopActions(const sts::GameContext &gc) {
-    std::vector<search::GameAction> actions;
-
+static void getAllShopActions(const sts::GameContext &gc, search::GameActionList &actions) {
     const auto &s = gc.info.shop;
     for (int i = 0; i < 7; ++i) {
         auto price = s.cardPrice(i);
         if (price != -1 && gc.gold >= price) {
-            actions.emplace_back(search::GameAction::RewardsActionType::CARD, i);
+            actions.push_back(search::GameAction(search::GameAction::RewardsActionType::CARD, i));
         }
     }
 
     for (int i = 0; i < 3; ++i) {
         auto price = s.relicPrice(i);
         if (price != -1 && gc.gold >= price) {
-            actions.emplace_back(search::GameAction::RewardsActionType::RELIC, i);
+            actions.push_back(search::GameAction(search::GameAction::RewardsActionType::RELIC, i));
         }
     }
 
     for (int i = 0; i < 3; ++i) {
         auto price = s.potionPrice(i);
         if (price != -1 && gc.gold >= price) {
-            actions.emplace_back(search::GameAction::RewardsActionType::POTION, i);
+            actions.push_back(search::GameAction(search::GameAction::RewardsActionType::POTION, i));
         }
     }
 
     if (s.removeCost != -1 && gc.gold >= s.removeCost) {
-        actions.emplace_back(search::GameAction::RewardsActionType::CARD_REMOVE);
+        actions.push_back(search::GameAction(search::GameAction::RewardsActionType::CARD_REMOVE));
     }
 
-    actions.emplace_back(search::GameAction::RewardsActionType::SKIP);
-    return actions;
+    actions.push_back(search::GameAction(search::GameAction::RewardsActionType::SKIP));
 }
 
-std::vector<search::GameAction> getAllRestActions(const sts::GameContext &gc) {
-    std::vector<search::GameAction> actions;
-
+static void getAllRestActions(const sts::GameContext &gc, search::GameActionList &actions) {
     if (!gc.relics.has(RelicId::COFFEE_DRIPPER)) {
-        actions.emplace_back(0);
+        actions.push_back(search::GameAction(0));
     }
 
     if (!gc.relics.has(RelicId::FUSION_HAMMER) && gc.deck.getUpgradeableCount() > 0) {
-        actions.emplace_back(1);
+        actions.push_back(search::GameAction(1));
     }
 
     if (!gc.hasKey(Key::RUBY_KEY)) {
-        actions.emplace_back(2);
+        actions.push_back(search::GameAction(2));
     }
 
     if (gc.relics.has(RelicId::GIRYA) && gc.relics.getRelicValue(RelicId::GIRYA) != 3) {
-        actions.emplace_back(3);
+        actions.push_back(search::GameAction(3));
     }
 
     if (gc.relics.has(RelicId::PEACE_PIPE)) { // assume we have card to remove
-        actions.emplace_back(4);
+        actions.push_back(search::GameAction(4));
     }
 
     if (gc.relics.has(RelicId::SHOVEL)) { // assume we have card to remove
-        actions.emplace_back(5);
+        actions.push_back(search::GameAction(5));
     }
 
     if (actions.empty()) {
-        actions.emplace_back(6);
+        actions.push_back(search::GameAction(6));
     }
-
-    return actions;
 }
 
-std::vector<search::GameAction> getAllRewardActions(const sts::GameContext &gc) {
-    std::vector<search::GameAction> actions;
-
+static void getAllRewardActions(const sts::GameContext &gc, search::GameActionList &actions) {
     const auto &r = gc.info.rewardsContainer;
     for (int i = 0; i < r.goldRewardCount; ++i) {
-        actions.emplace_back(search::GameAction::RewardsActionType::GOLD);
+        actions.push_back(search::GameAction(search::GameAction::RewardsActionType::GOLD));
     }
 
     for (int i = 0; i < r.cardRewardCount; ++i) {
         for (int x = 0; x < r.cardRewards[i].size(); ++x) {
-            actions.emplace_back(search::GameAction::RewardsActionType::CARD, i, x);
+            actions.push_back(search::GameAction(search::GameAction::RewardsActionType::CARD, i, x));
         }
     }
 
     for (int i = 0; i < r.relicCount; ++i) {
-        actions.emplace_back(search::GameAction::RewardsActionType::RELIC, i);
+        actions.push_back(search::GameAction(search::GameAction::RewardsActionType::RELIC, i));
     }
 
     if (r.emeraldKey || r.sapphireKey) {
-        actions.emplace_back(search::GameAction::RewardsActionType::KEY);
+        actions.push_back(search::GameAction(search::GameAction::RewardsActionType::KEY));
     }
 
     for (int i = 0; i < r.potionCount; ++i) {
-        actions.emplace_back(search::GameAction::RewardsActionType::POTION, i);
+        actions.push_back(search::GameAction(search::GameAction::RewardsActionType::POTION, i));
     }
-    actions.emplace_back(search::GameAction::RewardsActionType::SKIP);
-
-    return actions;
+    actions.push_back(search::GameAction(search::GameAction::RewardsActionType::SKIP));
 }
 
-std::vector<search::GameAction> getAllMapActions(const sts::GameContext &gc) {
-    std::vector<search::GameAction> actions;
-
+static void getAllMapActions(const sts::GameContext &gc, search::GameActionList &actions) {
     if (gc.curMapNodeY == 14) {
-        actions.emplace_back(0);
+        actions.push_back(search::GameAction(0));
 
     } else if (gc.curMapNodeY == -1) {
         for (const auto &node : gc.map->nodes[0]) {
             if (node.edgeCount > 0) {
-                actions.emplace_back(node.x);
+                actions.push_back(search::GameAction(node.x));
             }
         }
 
     } else {
         auto node = gc.map->getNode(gc.curMapNodeX, gc.curMapNodeY);
         for (int i = 0; i < node.edgeCount; ++i) {
-            actions.emplace_back(node.edges[i]);
+            actions.push_back(search::GameAction(node.edges[i]));
         }
     }
-
-    return actions;
 }
 
-std::vector<search::GameAction> search::GameAction::getAllActionsInState(const sts::GameContext &gc) {
+void search::GameAction::getAllActionsInState(const sts::GameContext &gc, GameActionList &actions) {
+    actions.clear();
     if (gc.outcome != GameOutcome::UNDECIDED) {
-        return {};
+        return;
     }
 
     switch (gc.screenState) {
 
         case ScreenState::EVENT_SCREEN:
-            if (gc.curEvent == Event::MATCH_AND_KEEP) {
-                return {};
-            } else {
-                return getAllActionsInEventState(gc);
+            if (gc.curEvent != Event::MATCH_AND_KEEP) {
+                getAllActionsInEventState(gc, actions);
             }
+            break;
 
         case ScreenState::REWARDS:
-            return getAllRewardActions(gc);
+            getAllRewardActions(gc, actions);
+            break;
 
         case ScreenState::BOSS_RELIC_REWARDS:
-            return {0,1,2,3};
+            for (int i = 0; i < 4; ++i) {
+                actions.push_back(GameAction(i));
+            }
+            break;
 
-        case ScreenState::CARD_SELECT: {
-            std::vector<search::GameAction> actions;
-            actions.reserve(gc.info.toSelectCards.size());
+        case ScreenState::CARD_SELECT:
             for (int i = 0; i < gc.info.toSelectCards.size(); ++i) {
-                actions.emplace_back(i);
+                actions.push_back(GameAction(i));
             }
-            return actions;
-        }
+            break;
 
         case ScreenState::MAP_SCREEN:
-            return getAllMapActions(gc);
+            getAllMapActions(gc, actions);
+            break;
 
         case ScreenState::TREASURE_ROOM:
-            return {0,1};
+            actions.push_back(GameAction(0));
+            actions.push_back(GameAction(1));
+            break;
 
         case ScreenState::REST_ROOM:
-            return getAllRestActions(gc);
+            getAllRestActions(gc, actions);
+            break;
 
         case ScreenState::SHOP_ROOM:
-            return getAllShopActions(gc);
+            getAllShopActions(gc, actions);
+            break;
 
         case ScreenState::BATTLE:
         case ScreenState::INVALID:
         default:
-            return {};
+            break;
     }
 }
 
+std::vector<search::GameAction> search::GameAction::getAllActionsInState(const sts::GameContext &gc) {
+    GameActionList actions;
+    getAllActionsInState(gc, actions);
+    return {actions.begin(), actions.end()};
+}
+
 int search::GameAction::getValidEventSelectBits(const GameContext &gc) {
     // given that game outcome is not undecided and screen state is event
     switch (gc.curEvent) {
@@ -0,0 +1,297 @@
+#include "sim/search/GameScumSearcher.h"
+#include "sim/search/SimpleAgent.h"
+#include "combat/BattleContext.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace sts;
+
+// the random engine for each extra thread is seeded from the root state and the thread index,
+// so a parallel search is deterministic for a given seed and thread count
+static std::default_random_engine getThreadRandGen(const GameContext &gc, std::default_random_engine &rng, int threadIdx) {
+    const std::uint64_t seed = gc.seed + gc.floorNum;
+    std::seed_seq seq {
+            static_cast<std::uint32_t>(seed),
+            static_cast<std::uint32_t>(seed >> 32),
+            static_cast<std::uint32_t>(rng()),
+            static_cast<std::uint32_t>(threadIdx)
+    };
+    return std::default_random_engine(seq);
+}
+
+search::GameScumSearcher::GameScumSearcher(const GameContext &gc) {
+    rootFloor = gc.floorNum;
+    horizonAct = std::max(1, gc.act);
+    if (gc.curRoom == Room::BOSS || gc.curRoom == Room::BOSS_TREASURE) {
+        // the act is over once the boss is dead, look through the next one instead
+        ++horizonAct;
+    }
+
+    GameContext root;
+    gc.clone_into(root);
+    addNode(std::move(root));
+}
+
+void search::GameScumSearcher::search(std::int64_t simulations, int threadCount) {
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto startSimulationCount = nodes[0].simulationCount;
+    battleCount = 0;
+
+    if (threadCount <= 1) {
+        searchSerial(simulations);
+    } else {
+        searchRootParallel(simulations, threadCount);
+    }
+
+    simulationCount = nodes[0].simulationCount - startSimulationCount;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+int search::GameScumSearcher::getBestEdgeIdx() const {
+    const auto &root = nodes[0];
+    int bestIdx = -1;
+    std::int64_t bestCount = -1;
+    double bestValue = -1;
+    for (int i = 0; i < root.edges.size(); ++i) {
+        const auto &edge = root.edges[i];
+        const auto value = getEdgeValue(edge);
+        if (edge.simulationCount > bestCount || (edge.simulationCount == bestCount && value > bestValue)) {
+            bestIdx = i;
+            bestCount = edge.simulationCount;
+            bestValue = value;
+        }
+    }
+    return bestIdx;
+}
+
+search::GameAction search::GameScumSearcher::getBestAction() const {
+    const auto idx = getBestEdgeIdx();
+#ifdef sts_asserts
+    assert(idx >= 0);
+#endif
+    return nodes[0].edges[idx].action;
+}
+
+double search::GameScumSearcher::getEdgeValue(const Edge &edge) const {
+    return edge.simulationCount == 0 ? 0 : edge.evaluationSum / static_cast<double>(edge.simulationCount);
+}
+
+void search::GameScumSearcher::printRootEdges(std::ostream &os) const {
+    const auto &root = nodes[0];
+    os << "simulations: " << root.simulationCount << " nodes: " << nodes.size() << '\n';
+    for (const auto &edge : root.edges) {
+        os << "\t" << std::hex << edge.action.bits << std::dec << " " << edge.simulationCount << " " << getEdgeValue(edge) << " ";
+        edge.action.printDesc(os, root.state) << '\n';
+    }
+}
+
+double search::GameScumSearcher::evaluateEndState(const GameContext &gc) const {
+    const int horizonFloor = 17 * horizonAct;
+    const double floorProgress = std::clamp(
+            static_cast<double>(gc.floorNum - rootFloor) / std::max(1, horizonFloor - rootFloor), 0.0, 1.0);
+
+    if (gc.outcome == GameOutcome::PLAYER_LOSS) {
+        return 0.5 * floorProgress;
+    }
+    if (gc.outcome == GameOutcome::PLAYER_VICTORY || gc.act > horizonAct) {
+        return 0.5 + 0.5 * gc.curHp / std::max(1, gc.maxHp);
+    }
+    // the rollout was cut off before the end of the act
+    return 0.5 * floorProgress;
+}
+
+bool search::GameScumSearcher::isTerminalState(const GameContext &gc) const {
+    return gc.outcome != GameOutcome::UNDECIDED || gc.act > horizonAct;
+}
+
+void search::GameScumSearcher::searchSerial(std::int64_t simulations) {
+    SimpleAgent agent;
+    std::vector<std::pair<std::uint32_t, int>> path;
+    GameContext rolloutState;
+
+    for (std::int64_t simCount = 0; simCount < simulations; ++simCount) {
+        simulate(agent, path, rolloutState);
+    }
+}
+
+void search::GameScumSearcher::searchRootParallel(std::int64_t simulations, int threadCount) {
+    std::vector<std::unique_ptr<GameScumSearcher>> searchers;
+    for (int t = 1; t < threadCount; ++t) {
+        searchers.emplace_back(new GameScumSearcher(nodes[0].state));
+        searchers.back()->horizonAct = horizonAct;
+        searchers.back()->explorationParameter = explorationParameter;
+        searchers.back()->rolloutEpsilon = rolloutEpsilon;
+        searchers.back()->maxRolloutSteps = maxRolloutSteps;
+        searchers.back()->rng = getThreadRandGen(nodes[0].state, rng, t);
+    }
+
+    const auto simulationsForThread = [=](int t) {
+        return simulations / threadCount + (t < simulations % threadCount ? 1 : 0);
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 1; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() { searchers[t-1]->searchSerial(simulationsForThread(t)); });
+    }
+    searchSerial(simulationsForThread(0));
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // merging in thread order keeps ties in getBestEdgeIdx deterministic
+    for (auto &searcher : searchers) {
+        mergeRoot(*searcher);
+    }
+}
+
+void search::GameScumSearcher::mergeRoot(const GameScumSearcher &other) {
+    auto &root = nodes[0];
+    const auto &otherRoot = other.nodes[0];
+#ifdef sts_asserts
+    assert(root.edges.size() == otherRoot.edges.size());
+#endif
+    root.simulationCount += otherRoot.simulationCount;
+    for (int i = 0; i < root.edges.size(); ++i) {
+        root.edges[i].simulationCount += otherRoot.edges[i].simulationCount;
+        root.edges[i].evaluationSum += otherRoot.edges[i].evaluationSum;
+    }
+    battleCount += other.battleCount;
+}
+
+// one selection, expansion, rollout and backup. path holds the (node, edge) pairs taken from the root
+void search::GameScumSearcher::simulate(SimpleAgent &agent, std::vector<std::pair<std::uint32_t, int>> &path, GameContext &rolloutState) {
+    path.clear();
+    agent.actionHistory.clear();
+
+    std::uint32_t nodeIdx = 0;
+    double evaluation;
+    while (true) {
+        if (nodes[nodeIdx].edges.empty()) {
+            evaluation = evaluateEndState(nodes[nodeIdx].state);
+            break;
+        }
+
+        const auto edgeIdx = selectEdge(nodes[nodeIdx]);
+        path.emplace_back(nodeIdx, edgeIdx);
+
+        const auto childIdx = nodes[nodeIdx].edges[edgeIdx].childIdx;
+        if (childIdx != INVALID_IDX) {
+            nodeIdx = childIdx;
+            continue;
+        }
+
+        // expand, the battles up to the next decision are part of the edge
+        GameContext child;
+        nodes[nodeIdx].state.clone_into(child);
+        nodes[nodeIdx].edges[edgeIdx].action.execute(child);
+        playBattles(child, agent);
+
+        child.clone_into(rolloutState);
+        const auto newIdx = addNode(std::move(child));
+        nodes[nodeIdx].edges[edgeIdx].childIdx = newIdx;
+
+        rollout(rolloutState, agent);
+        evaluation = evaluateEndState(rolloutState);
+        nodeIdx = newIdx;
+        break;
+    }
+
+    nodes[nodeIdx].simulationCount += 1;
+    for (const auto &[n, e] : path) {
+        nodes[n].simulationCount += 1;
+        nodes[n].edges[e].simulationCount += 1;
+        nodes[n].edges[e].evaluationSum += evaluation;
+    }
+}
+
+std::uint32_t search::GameScumSearcher::addNode(GameContext &&gc) {
+    nodes.emplace_back();
+    auto &node = nodes.back();
+    node.state = std::move(gc);
+    if (!isTerminalState(node.state)) {
+        GameActionList actions;
+        GameAction::getAllActionsInState(node.state, actions);
+        for (auto a : actions) {
+            node.edges.push_back({a});
+        }
+    }
+    return static_cast<std::uint32_t>(nodes.size() - 1);
+}
+
+// ucb1, with edges that haven't been simulated taken first in order
+int search::GameScumSearcher::selectEdge(const Node &node) const {
+    const double logParentCount = std::log(static_cast<double>(std::max<std::int64_t>(1, node.simulationCount)));
+
+    int bestIdx = 0;
+    double bestValue = -1;
+    for (int i = 0; i < node.edges.size(); ++i) {
+        const auto &edge = node.edges[i];
+        if (edge.simulationCount == 0) {
+            return i;
+        }
+        const auto n = static_cast<double>(edge.simulationCount);
+        const auto value = edge.evaluationSum / n + explorationParameter * std::sqrt(logParentCount / n);
+        if (value > bestValue) {
+            bestValue = value;
+            bestIdx = i;
+        }
+    }
+    return bestIdx;
+}
+
+void search::GameScumSearcher::playBattles(GameContext &gc, SimpleAgent &agent) {
+    agent.curGameContext = &gc;
+    BattleContext bc;
+    while (gc.outcome == GameOutcome::UNDECIDED && gc.screenState == ScreenState::BATTLE) {
+        bc = BattleContext();
+        bc.init(gc);
+        agent.playoutBattle(bc);
+        bc.exitBattle(gc);
+        ++battleCount;
+    }
+}
+
+// SimpleAgent's action, or a random one with probability rolloutEpsilon and where SimpleAgent's map path
+// doesn't apply because the tree left it. returns false if there is no action to take
+bool search::GameScumSearcher::stepRollout(GameContext &gc, SimpleAgent &agent) {
+    bool random = std::uniform_real_distribution<double>(0, 1)(rng) < rolloutEpsilon;
+
+    if (!random && gc.screenState == ScreenState::MAP_SCREEN && (gc.act == 4 || gc.curMapNodeY >= 0)) {
+        const auto y = gc.curMapNodeY;
+        random = gc.act == 4
+                || agent.mapPath.size() <= y+1
+                || agent.mapPath[y] != gc.curMapNodeX
+                || !GameAction(agent.mapPath[y+1]).isValidAction(gc);
+    }
+
+    if (!random) {
+        agent.stepOutOfCombat(gc);
+        return true;
+    }
+
+    GameActionList actions;
+    GameAction::getAllActionsInState(gc, actions);
+    if (actions.empty()) {
+        return false;
+    }
+    const auto idx = std::uniform_int_distribution<int>(0, static_cast<int>(actions.size())-1)(rng);
+    agent.takeAction(gc, actions[idx]);
+    return true;
+}
+
+void search::GameScumSearcher::rollout(GameContext &gc, SimpleAgent &agent) {
+    agent.curGameContext = &gc;
+    for (int step = 0; step < maxRolloutSteps && !isTerminalState(gc); ++step) {
+        if (gc.screenState == ScreenState::BATTLE) {
+            playBattles(gc, agent);
+            continue;
+        }
+        if (!stepRollout(gc, agent)) {
+            break;
+        }
+    }
+}
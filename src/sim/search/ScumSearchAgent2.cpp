@@ -8,6 +8,7 @@
 #include <game/Game.h>
 #include "sim/PrintHelpers.h"
 #include "sim/search/BattleScumSearcher2.h"
+#include "sim/search/GameScumSearcher.h"
 
 using namespace sts;
 
@@ -65,12 +66,36 @@ void search::ScumSearchAgent2::playoutBattle(BattleContext &bc) {
     std::vector<search::Action> bestActions;
     int bestOutcomePlayerHp = -1;
 
+    search::BattleScumSearcher2 searcher(bc);
+    searcher.rolloutPolicy = rolloutPolicy;
+    searcher.rolloutEpsilon = rolloutEpsilon;
+    searcher.progressiveWidening = progressiveWidening;
+    searcher.prunePlayouts = earlyTermination;
+    searcher.stopOnOptimalSolution = earlyTermination;
+    searcher.statsLog = searchStatsLog;
+    std::vector<search::Action> actionsTaken;
     while (bc.outcome == Outcome::UNDECIDED) {
-        const std::int64_t simulationCount = isBossEncounter(bc.encounter) ?
+        const std::int64_t simulationTarget = isBossEncounter(bc.encounter) ?
                                               (bossSimulationMultiplier * simulationCountBase) : simulationCountBase;
 
-        search::BattleScumSearcher2 searcher(bc);
-        searcher.search(simulationCount);
+        // the subtree under the actions taken since the last search only needs to be topped up to the target
+        const bool rerooted = reuseSearchTree && !actionsTaken.empty() && searcher.reroot(actionsTaken, bc);
+        if (!rerooted) {
+            searcher.reset(bc); // keeps the tree memory from the last search
+        }
+        actionsTaken.clear();
+
+        if (earlyTermination) {
+            searcher.stableSimulationLimit = std::max<std::int64_t>(1, simulationTarget * stableSimulationFraction);
+        }
+
+        const auto rootSimulationCount = searcher.getRootSimulationCount();
+        if (searchTimeBudget.count() > 0) {
+            searcher.searchFor(searchTimeBudget, searchThreadCount, searchParallelism);
+        } else {
+            const auto simulationCount = std::max<std::int64_t>(0, simulationTarget - rootSimulationCount);
+            searcher.search(simulationCount, searchThreadCount, searchParallelism);
+        }
 
         if (searcher.outcomePlayerHp > bestOutcomePlayerHp)
         {
@@ -80,17 +105,17 @@ void search::ScumSearchAgent2::playoutBattle(BattleContext &bc) {
             bestOutcomePlayerHp = searcher.outcomePlayerHp;
         }
 
-        simulationCountTotal += searcher.root.simulationCount;
+        simulationCountTotal += searcher.getRootSimulationCount() - rootSimulationCount; // the search can stop early
 
         if (bestOutcomePlayerHp > 0) {
-            stepThroughSolution(bc, bestActions);
+            stepThroughSolution(bc, bestActions, actionsTaken);
         } else {
-            stepThroughSearchTree(bc, searcher);
+            stepThroughSearchTree(bc, searcher, actionsTaken);
         }
     }
 }
 
-void search::ScumSearchAgent2::stepThroughSolution(BattleContext &bc, std::vector<search::Action> &actions) {
+void search::ScumSearchAgent2::stepThroughSolution(BattleContext &bc, std::vector<search::Action> &actions, std::vector<search::Action> &actionsTaken) {
     for (int i = 0; i < stepsWithSolution; ++i) {
         if (actions.empty()) {
             break;
@@ -102,12 +127,13 @@ void search::ScumSearchAgent2::stepThroughSolution(BattleContext &bc, std::vecto
         }
 
         takeAction(bc, a);
+        actionsTaken.push_back(a);
         actions.pop_back();
     }
 }
 
-void search::ScumSearchAgent2::stepThroughSearchTree(BattleContext &bc, const search::BattleScumSearcher2 &s) {
-    const search::BattleScumSearcher2::Node *curNode = &s.root;
+void search::ScumSearchAgent2::stepThroughSearchTree(BattleContext &bc, const search::BattleScumSearcher2 &s, std::vector<search::Action> &actionsTaken) {
+    const search::BattleScumSearcher2::Node *curNode = &s.root();
     for (int actionCount = 0; actionCount < stepsNoSolution; ++actionCount) {
         if (bc.outcome != Outcome::UNDECIDED) {
             break;
@@ -116,9 +142,11 @@ void search::ScumSearchAgent2::stepThroughSearchTree(BattleContext &bc, const se
         std::int64_t maxSimulations = -1;
         const sts::search::BattleScumSearcher2::Edge *maxEdge = nullptr;
 
-        for (const auto &edge : curNode->edges) {
-            if (edge.node.simulationCount > maxSimulations) {
-                maxSimulations = edge.node.simulationCount;
+        for (int i = 0; i < curNode->edgeCount; ++i) {
+            const auto &edge = s.tree[curNode->edgeBegin+i];
+            const auto simulationCount = s.stats.simulationCount[curNode->edgeBegin+i];
+            if (simulationCount > maxSimulations) {
+                maxSimulations = simulationCount;
                 maxEdge = &edge;
             }
         }
@@ -132,21 +160,65 @@ void search::ScumSearchAgent2::stepThroughSearchTree(BattleContext &bc, const se
         }
 
         takeAction(bc, maxEdge->action);
+        actionsTaken.push_back(maxEdge->action);
         curNode = &maxEdge->node;
     }
 }
 
 void search::ScumSearchAgent2::stepRandom(GameContext &gc) {
-    std::vector<search::GameAction> possibleActions(search::GameAction::getAllActionsInState(gc));
+    GameActionList possibleActions;
+    GameAction::getAllActionsInState(gc, possibleActions);
     std::uniform_int_distribution<int> distr(0, static_cast<int>(possibleActions.size())-1);
     const int randomChoice = distr(rng);
     auto a = possibleActions[randomChoice];
     takeAction(gc, a);
 }
 
+// the decisions that shape the rest of the run the most, the rest are cheap enough to leave to the policy
+static bool isGameSearchDecision(const GameContext &gc) {
+    switch (gc.screenState) {
+        case ScreenState::EVENT_SCREEN:
+            return gc.curEvent == Event::NEOW;
+
+        case ScreenState::BOSS_RELIC_REWARDS:
+            return true;
+
+        case ScreenState::REWARDS: {
+            const auto &r = gc.info.rewardsContainer;
+            return r.cardRewardCount > 0 && r.relicCount == 0 && r.cardRewardCount == r.getTotalCount();
+        }
+
+        default:
+            return false;
+    }
+}
+
+bool search::ScumSearchAgent2::stepGameSearch(GameContext &gc) {
+    if (gameSimulationCount <= 0 || !isGameSearchDecision(gc)) {
+        return false;
+    }
+
+    GameScumSearcher searcher(gc);
+    searcher.rng = std::default_random_engine(rng());
+    searcher.search(gameSimulationCount, searchThreadCount);
+    if (searcher.nodes[0].edges.empty()) {
+        return false;
+    }
+
+    if (printLogs) {
+        searcher.printRootEdges(std::cout);
+    }
+    takeAction(gc, searcher.getBestAction());
+    return true;
+}
+
 void search::ScumSearchAgent2::stepOutOfCombatPolicy(GameContext &gc) {
     ++stepCount;
 
+    if (stepGameSearch(gc)) {
+        return;
+    }
+
     switch (gc.screenState) {
         case ScreenState::EVENT_SCREEN:
             stepEventPolicy(gc);
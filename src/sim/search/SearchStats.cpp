@@ -0,0 +1,60 @@
+#include "sim/search/SearchStats.h"
+
+#include <algorithm>
+
+using namespace sts;
+
+void search::SearchStats::addSimulation(std::int64_t treeDepth, std::int64_t rolloutLength, std::int64_t executeActionsLoops) {
+    rolloutLengthSum += rolloutLength;
+    maxRolloutLength = std::max(maxRolloutLength, rolloutLength);
+    treeDepthSum += treeDepth;
+    maxTreeDepth = std::max(maxTreeDepth, treeDepth);
+    executeActionsLoopCount += executeActionsLoops;
+}
+
+void search::SearchStats::add(const SearchStats &rhs) {
+    simulationCount += rhs.simulationCount;
+    rolloutLengthSum += rhs.rolloutLengthSum;
+    maxRolloutLength = std::max(maxRolloutLength, rhs.maxRolloutLength);
+    treeDepthSum += rhs.treeDepthSum;
+    maxTreeDepth = std::max(maxTreeDepth, rhs.maxTreeDepth);
+    executeActionsLoopCount += rhs.executeActionsLoopCount;
+
+    selectionTime += rhs.selectionTime;
+    expansionTime += rhs.expansionTime;
+    rolloutTime += rhs.rolloutTime;
+    backpropTime += rhs.backpropTime;
+}
+
+double search::SearchStats::simulationsPerSecond() const {
+    return elapsed > 0 ? simulationCount / elapsed : 0;
+}
+
+double search::SearchStats::meanRolloutLength() const {
+    return simulationCount > 0 ? static_cast<double>(rolloutLengthSum) / simulationCount : 0;
+}
+
+double search::SearchStats::meanTreeDepth() const {
+    return simulationCount > 0 ? static_cast<double>(treeDepthSum) / simulationCount : 0;
+}
+
+void search::SearchStats::printJson(std::ostream &os) const {
+    os << "{\"simulations\":" << simulationCount
+        << ",\"elapsed\":" << elapsed
+        << ",\"simulationsPerSecond\":" << simulationsPerSecond()
+        << ",\"nodeCount\":" << nodeCount
+        << ",\"treeMemory\":" << treeMemory;
+
+    if (SEARCH_STATS_ENABLED) {
+        os << ",\"meanRolloutLength\":" << meanRolloutLength()
+            << ",\"maxRolloutLength\":" << maxRolloutLength
+            << ",\"meanTreeDepth\":" << meanTreeDepth()
+            << ",\"maxTreeDepth\":" << maxTreeDepth
+            << ",\"executeActionsLoops\":" << executeActionsLoopCount
+            << ",\"selectionTime\":" << selectionTime
+            << ",\"expansionTime\":" << expansionTime
+            << ",\"rolloutTime\":" << rolloutTime
+            << ",\"backpropTime\":" << backpropTime;
+    }
+    os << "}\n";
+}
@@ -11,237 +11,633 @@
 #include "constants/MonsterEncounters.h"
 #include "game/Card.h"
 #include "game/GameContext.h"
+#include "sim/BatchRunner.h"
 #include "sim/BattleSimulator.h"
 #include "sim/PrintHelpers.h"
 #include "sim/search/Action.h"
 
 
-#include <map>
 #include <array>
-#include <bitset>
+#include <iterator>
+#include <limits>
 #include <thread>
-#include <mutex>
+#include <deque>
 #include <vector>
 
 using namespace sts;
 
-static bool haveInitMaps = false;
-static int cardPriorityMap[372] {};
-static int cardPlayMap[372] {};
-static int bossRelicPriorityMap[200] {};
-static std::bitset<372> isAoeCard;
-static std::bitset<372> isDefensiveCard;
-static std::map<CardId, int> *maxCopies;
-
 static constexpr int mapWeights[3][6] = {
         {100,1000,100,10,1,0},
         {10,1000,10,100,1,0},
         {100,1000,100,1,10,0},
 };
 
+constexpr std::array<CardId,133> cardsPriorities = {
+        CardId::APOTHEOSIS,
+        CardId::GHOSTLY_ARMOR,
+        CardId::PERFECTED_STRIKE,
+        CardId::WHIRLWIND,
+        CardId::BATTLE_TRANCE,
+        CardId::DEMON_FORM,
+        CardId::RAGE,
+        CardId::OFFERING,
+        CardId::IMPERVIOUS,
+        CardId::IMMOLATE,
+        CardId::LIMIT_BREAK,
+        CardId::FLAME_BARRIER,
+        CardId::MASTER_OF_STRATEGY,
+        CardId::INFLAME,
+        CardId::DISARM,
+        CardId::SHRUG_IT_OFF,
+        CardId::DOUBLE_TAP,
+        CardId::THUNDERCLAP,
+        CardId::METALLICIZE,
+        CardId::POMMEL_STRIKE,
+        CardId::SHOCKWAVE,
+        CardId::UPPERCUT,
+        CardId::JAX,
+        CardId::PANIC_BUTTON,
+        CardId::FLASH_OF_STEEL,
+        CardId::FLEX,
+        CardId::ANGER,
+        CardId::SECRET_WEAPON,
+        CardId::FINESSE,
+        CardId::MAYHEM,
+        CardId::PANACHE,
+        CardId::SECRET_TECHNIQUE,
+        CardId::METAMORPHOSIS,
+        CardId::THINKING_AHEAD,
+        CardId::MADNESS,
+        CardId::DISCOVERY,
+        CardId::CHRYSALIS,
+        CardId::DEEP_BREATH,
+        CardId::TRIP,
+        CardId::ENLIGHTENMENT,
+        CardId::HEAVY_BLADE,
+        CardId::FEED,
+        CardId::FIEND_FIRE,
+        CardId::TWIN_STRIKE,
+        CardId::HEADBUTT,
+        CardId::SEEING_RED,
+        CardId::COMBUST,
+        CardId::CLASH,
+        CardId::DARK_SHACKLES,
+        CardId::SWORD_BOOMERANG,
+        CardId::DRAMATIC_ENTRANCE,
+        CardId::BLUDGEON,
+        CardId::HAND_OF_GREED,
+        CardId::EVOLVE,
+        CardId::VIOLENCE,
+        CardId::BITE,
+        CardId::CARNAGE,
+        CardId::CLOTHESLINE,
+        CardId::BASH,
+        CardId::BANDAGE_UP,
+        CardId::PANACEA,
+        CardId::RECKLESS_CHARGE,
+        CardId::INFERNAL_BLADE,
+        CardId::SPOT_WEAKNESS,
+        CardId::STRIKE_RED,
+        CardId::SHIV,
+        CardId::HAVOC,
+        CardId::RITUAL_DAGGER,
+        CardId::DROPKICK,
+        CardId::FEEL_NO_PAIN,
+        CardId::SWIFT_STRIKE,
+        CardId::CORRUPTION,
+        CardId::MAGNETISM,
+        CardId::BLOODLETTING,
+        CardId::IRON_WAVE,
+        CardId::ARMAMENTS,
+        CardId::MIND_BLAST,
+        CardId::ASCENDERS_BANE,
+        CardId::DAZED,
+        CardId::VOID,
+        CardId::RAMPAGE,
+        CardId::GHOSTLY_ARMOR,
+        CardId::TRUE_GRIT,
+        CardId::BLIND,
+        CardId::GOOD_INSTINCTS,
+        CardId::PUMMEL,
+        CardId::HEMOKINESIS,
+        CardId::EXHUME,
+        CardId::REAPER,
+        CardId::CLEAVE,
+        CardId::WARCRY,
+        CardId::PURITY,
+        CardId::DUAL_WIELD,
+        CardId::WILD_STRIKE,
+        CardId::DEFEND_RED,
+        CardId::BODY_SLAM,
+        CardId::SEVER_SOUL,
+        CardId::BURNING_PACT,
+        CardId::BRUTALITY,
+        CardId::BARRICADE,
+        CardId::INTIMIDATE,
+        CardId::JUGGERNAUT,
+        CardId::SADISTIC_NATURE,
+        CardId::DARK_EMBRACE,
+        CardId::POWER_THROUGH,
+        CardId::TRANSMUTATION,
+        CardId::SENTINEL,
+        CardId::RUPTURE,
+        CardId::SLIMED,
+        CardId::FIRE_BREATHING,
+        CardId::SECOND_WIND,
+        CardId::IMPATIENCE,
+        CardId::THE_BOMB,
+        CardId::JACK_OF_ALL_TRADES,
+        CardId::SEARING_BLOW,
+        CardId::BLOOD_FOR_BLOOD,
+        CardId::BERSERK,
+        CardId::ENTRENCH,
+        CardId::FORETHOUGHT,
+        CardId::CLUMSY,
+        CardId::PARASITE,
+        CardId::SHAME,
+        CardId::INJURY,
+        CardId::WOUND,
+        CardId::WRITHE,
+        CardId::DOUBT,
+        CardId::BURN,
+        CardId::DECAY,
+        CardId::REGRET,
+        CardId::NECRONOMICURSE,
+        CardId::PAIN,
+        CardId::NORMALITY,
+        CardId::PRIDE,
+};
 
-void initMaps();
-
-bool shouldSkip(CardId id) {
-    return cardPriorityMap[static_cast<int>(id)] > cardPriorityMap[static_cast<int>(CardId::ANGER)];
-}
-
-int getHighHpMonster(const BattleContext &bc) {
-    int highHp = -1;
-    int highIdx = -1;
-    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-        if (bc.monsters.arr[i].isTargetable() && bc.monsters.arr[i].curHp > highHp) {
-            highHp = bc.monsters.arr[i].curHp;
-            highIdx = i;
-        }
-    }
-    return highIdx;
-}
-
-int getLowHpMonster(const BattleContext &bc) {
-    int lowHp = 10000;
-    int lowIdx = -1;
-    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-        if (bc.monsters.arr[i].isTargetable() && bc.monsters.arr[i].curHp < lowHp) {
-            lowHp = bc.monsters.arr[i].curHp;
-            lowIdx = i;
-        }
-    }
-    return lowIdx;
-}
-
-int getBestCardToPlay(const BattleContext &bc, fixed_list<int,10> handIdxs) {
-    int bestPriority = 10000;
-    int bestHandIdx;
-    for (int i = 0; i < handIdxs.size(); ++i) {
-        const auto c = bc.cards.hand[handIdxs[i]];
-        const int priority = 2 * cardPlayMap[static_cast<int>(c.getId())] + (c.isUpgraded() ? -1 : 0);
-        if (priority < bestPriority) {
-            bestPriority = priority;
-            bestHandIdx = handIdxs[i];
-        }
-    }
-    return bestHandIdx;
-}
-
-typedef struct {
-    BattleContext bc;
-    CardInstance card;
-
-} State;
-
-void search::myGetBestCardToPlay() {
-    GameContext gc = GameContext(CharacterClass::IRONCLAD, 0, 0);
-
-    BattleContext bc;
-    bc.init(gc, MonsterEncounter::JAW_WORM);
-
-    int seed_sample_count = 10;
-
-    // enumerate actions
-    std::deque<State> states;
-    for (int i = 0; i < std::size(bc.cards.hand); ++i) {
-        if (bc.cards.hand[i].id == CardId::INVALID) break;
-        auto new_bc = bc;
-        // auto action = search::Action(sts::search::ActionType::CARD, i);
-
-        State state = {new_bc, bc.cards.hand[i]};
-        states.push_front(state);
-    }
-    // sort actions by heuristic
-
-    for (int i = 0; i < seed_sample_count; ++i) {
-
-        // start dfs with first action
-        while (!states.empty()) {
-            auto state = states.front();
-            states.pop_front();
-
-            std::cout << "state: " << (state.card.getName()) << "\n";
-            std::cout << "hand: ";
-            bool first = true;
-            for (const auto& element : state.bc.cards.hand) {
-                if (!first) std::cout << ", ";
-                std::cout << element;
-                first = false;
-            }
-            std::cout << "\n";
-            // execute action
-            if (!state.card.requiresTarget()) {
-                auto *bestCard = std::find(std::begin(state.bc.cards.hand), std::end(state.bc.cards.hand), &state.card);
-                auto bestCardIdx = std::distance(std::begin(state.bc.cards.hand), bestCard);
-
-                auto action = search::Action(sts::search::ActionType::CARD, bestCardIdx);
-                action.execute(state.bc);
-            }
-
-            // push new states
-            for (int i = 0; i < std::size(state.bc.cards.hand); ++i) {
-                if (state.bc.cards.hand[i].id == CardId::INVALID) break;
-                auto new_bc = state.bc;
-                // auto action = search::Action(sts::search::ActionType::CARD, i);
-
-                State state = {new_bc, state.bc.cards.hand[i]};
-                states.push_front(state);
-            }
-
-            // eval action
-        }
-    }
-
-    // __dfs__ (with pruning)
-}
-
-void sortCardOptions(const GameContext &gc, fixed_list<int,96> &sortedCardIdxs) {
-    sortedCardIdxs.clear();
-    for (int i = 0; i < gc.info.toSelectCards.size(); ++i) {
-        sortedCardIdxs.push_back(i);
-    }
-
-    if (gc.info.selectScreenType == sts::CardSelectScreenType::UPGRADE ||
-        gc.info.selectScreenType == sts::CardSelectScreenType::DUPLICATE)
-    {
-        std::sort(sortedCardIdxs.begin(), sortedCardIdxs.end(), [&](int a, int b) {
-            auto ca = gc.info.toSelectCards[a].card;
-            auto cb = gc.info.toSelectCards[b].card;
-            auto pa = 2 * cardPriorityMap[static_cast<int>(ca.id)] + (ca.isUpgraded() ? -1 : 0);
-            auto pb = 2 * cardPriorityMap[static_cast<int>(cb.id)] + (cb.isUpgraded() ? -1 : 0);
-            return pa < pb;
-        });
-
-    } else {
-        std::sort(sortedCardIdxs.begin(), sortedCardIdxs.end(), [&](int a, int b) {
-            auto ca = gc.info.toSelectCards[a].card;
-            auto cb = gc.info.toSelectCards[b].card;
-            auto pa = 2 * cardPriorityMap[static_cast<int>(ca.id)] + (ca.isUpgraded() ? -1 : 0);
-            auto pb = 2 * cardPriorityMap[static_cast<int>(cb.id)] + (cb.isUpgraded() ? -1 : 0);
-            if (gc.info.selectScreenType == sts::CardSelectScreenType::TRANSFORM ||
-                gc.info.selectScreenType == sts::CardSelectScreenType::TRANSFORM_UPGRADE) {
-                if (ca.getType() == sts::CardType::CURSE) {
-                    pa -= 1000;
-                }
-                if (cb.getType() == sts::CardType::CURSE) {
-                    pb -= 1000;
-                }
-            }
-            return  pa > pb;
-        });
-    }
-}
+constexpr std::array<CardId,133> cardPlayPriorities = {
+        CardId::APOTHEOSIS,
+        CardId::OFFERING,
+        CardId::DEMON_FORM,
+        CardId::INFLAME,
+        CardId::METALLICIZE,
+        CardId::DISARM,
+        CardId::SHOCKWAVE,
+        CardId::GHOSTLY_ARMOR,
+        CardId::LIMIT_BREAK,
+        CardId::DOUBLE_TAP,
+        CardId::THUNDERCLAP,
+        CardId::IMMOLATE,
+        CardId::UPPERCUT,
+        CardId::FLAME_BARRIER,
+        CardId::SHRUG_IT_OFF,
+        CardId::IMPERVIOUS,
+        CardId::MADNESS,
+        CardId::PERFECTED_STRIKE,
+        CardId::BATTLE_TRANCE,
+        CardId::RAGE,
+        CardId::MASTER_OF_STRATEGY,
+        CardId::POMMEL_STRIKE,
+        CardId::JAX,
+        CardId::FLASH_OF_STEEL,
+        CardId::FLEX,
+        CardId::ANGER,
+        CardId::DEFEND_RED,
+        CardId::BASH,
+        CardId::WHIRLWIND,
+        CardId::PANIC_BUTTON,
+        CardId::SECRET_WEAPON,
+        CardId::FINESSE,
+        CardId::MAYHEM,
+        CardId::PANACHE,
+        CardId::SECRET_TECHNIQUE,
+        CardId::METAMORPHOSIS,
+        CardId::THINKING_AHEAD,
+        CardId::DISCOVERY,
+        CardId::CHRYSALIS,
+        CardId::DEEP_BREATH,
+        CardId::TRIP,
+        CardId::ENLIGHTENMENT,
+        CardId::HEAVY_BLADE,
+        CardId::FEED,
+        CardId::FIEND_FIRE,
+        CardId::TWIN_STRIKE,
+        CardId::HEADBUTT,
+        CardId::SEEING_RED,
+        CardId::COMBUST,
+        CardId::CLASH,
+        CardId::DARK_SHACKLES,
+        CardId::SWORD_BOOMERANG,
+        CardId::DRAMATIC_ENTRANCE,
+        CardId::BLUDGEON,
+        CardId::HAND_OF_GREED,
+        CardId::EVOLVE,
+        CardId::VIOLENCE,
+        CardId::BITE,
+        CardId::CARNAGE,
+        CardId::CLOTHESLINE,
+        CardId::BANDAGE_UP,
+        CardId::PANACEA,
+        CardId::RECKLESS_CHARGE,
+        CardId::INFERNAL_BLADE,
+        CardId::STRIKE_RED,
+        CardId::SPOT_WEAKNESS,
+        CardId::SHIV,
+        CardId::HAVOC,
+        CardId::RITUAL_DAGGER,
+        CardId::DROPKICK,
+        CardId::FEEL_NO_PAIN,
+        CardId::SWIFT_STRIKE,
+        CardId::CORRUPTION,
+        CardId::MAGNETISM,
+        CardId::BLOODLETTING,
+        CardId::IRON_WAVE,
+        CardId::ARMAMENTS,
+        CardId::MIND_BLAST,
+        CardId::ASCENDERS_BANE,
+        CardId::DAZED,
+        CardId::VOID,
+        CardId::RAMPAGE,
+        CardId::GHOSTLY_ARMOR,
+        CardId::TRUE_GRIT,
+        CardId::BLIND,
+        CardId::GOOD_INSTINCTS,
+        CardId::PUMMEL,
+        CardId::HEMOKINESIS,
+        CardId::EXHUME,
+        CardId::REAPER,
+        CardId::CLEAVE,
+        CardId::WARCRY,
+        CardId::PURITY,
+        CardId::DUAL_WIELD,
+        CardId::WILD_STRIKE,
+        CardId::BODY_SLAM,
+        CardId::SEVER_SOUL,
+        CardId::BURNING_PACT,
+        CardId::BRUTALITY,
+        CardId::BARRICADE,
+        CardId::INTIMIDATE,
+        CardId::JUGGERNAUT,
+        CardId::SADISTIC_NATURE,
+        CardId::DARK_EMBRACE,
+        CardId::POWER_THROUGH,
+        CardId::TRANSMUTATION,
+        CardId::SENTINEL,
+        CardId::RUPTURE,
+        CardId::SLIMED,
+        CardId::FIRE_BREATHING,
+        CardId::SECOND_WIND,
+        CardId::IMPATIENCE,
+        CardId::THE_BOMB,
+        CardId::JACK_OF_ALL_TRADES,
+        CardId::SEARING_BLOW,
+        CardId::BLOOD_FOR_BLOOD,
+        CardId::BERSERK,
+        CardId::ENTRENCH,
+        CardId::FORETHOUGHT,
+        CardId::CLUMSY,
+        CardId::PARASITE,
+        CardId::SHAME,
+        CardId::INJURY,
+        CardId::WOUND,
+        CardId::WRITHE,
+        CardId::DOUBT,
+        CardId::BURN,
+        CardId::DECAY,
+        CardId::REGRET,
+        CardId::NECRONOMICURSE,
+        CardId::PAIN,
+        CardId::NORMALITY,
+        CardId::PRIDE,
+};
 
-//void sortCardOptions(const GameContext &gc, fixed_list<int,96> &sortedCardIdxs) {
-//    sortedCardIdxs.clear();
-//    for (int i = 0; i < gc.info.toSelectCards.size(); ++i) {
-//        sortedCardIdxs.push_back(i);
-//    }
-//
-//    if (gc.info.selectScreenType == sts::CardSelectScreenType::UPGRADE ||
-//        gc.info.selectScreenType == sts::CardSelectScreenType::DUPLICATE)
-//    {
-//        std::sort(sortedCardIdxs.begin(), sortedCardIdxs.end(), [&](int a, int b) {
-//            auto ca = gc.info.toSelectCards[a].card;
-//            auto cb = gc.info.toSelectCards[b].card;
-//            return cardPriorityMap[static_cast<int>(ca.id)] < cardPriorityMap[static_cast<int>(cb.id)];
-//        });
-//
-//    } else {
-//        std::sort(sortedCardIdxs.begin(), sortedCardIdxs.end(), [&](int a, int b) {
-//            auto ca = gc.info.toSelectCards[a].card;
-//            auto cb = gc.info.toSelectCards[b].card;
-//            auto pa = cardPriorityMap[static_cast<int>(ca.id)];
-//            auto pb = cardPriorityMap[static_cast<int>(cb.id)];
-//            if (gc.info.selectScreenType == sts::CardSelectScreenType::TRANSFORM ||
-//                gc.info.selectScreenType == sts::CardSelectScreenType::TRANSFORM_UPGRADE) {
-//                if (ca.getType() == sts::CardType::CURSE) {
-//                    pa -= 1000;
-//                }
-//                if (cb.getType() == sts::CardType::CURSE) {
-//                    pb -= 1000;
-//                }
-//            }
-//            return  pa > pb;
-//        });
-//    }
-//}
+constexpr std::array<CardId,13> defensiveCards = {
+        CardId::POWER_THROUGH,
+        CardId::TRUE_GRIT,
+        CardId::IMPERVIOUS,
+        CardId::SHRUG_IT_OFF,
+        CardId::FLAME_BARRIER,
+        CardId::ENTRENCH,
+        CardId::DEFEND_RED,
+        CardId::SENTINEL,
+        CardId::SECOND_WIND,
+        CardId::GHOSTLY_ARMOR,
+        CardId::DARK_SHACKLES,
+        CardId::PANIC_BUTTON,
+        CardId::RAGE,
+};
 
-int search::SimpleAgent::getIncomingDamage(const BattleContext &bc) const {
-    int incomingDamage = 0;
-    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
-        const auto &m = bc.monsters.arr[i];
-        if (m.isDeadOrEscaped() || m.isHalfDead()) {
-            continue;
-        }
+constexpr std::array<RelicId,24> bossRelicPriorities = {
+        R::SOZU,
+        R::SNECKO_EYE,
+        R::PHILOSOPHERS_STONE,
+        R::RUNIC_DOME,
+        R::CURSED_KEY,
+        R::FUSION_HAMMER,
+        R::VELVET_CHOKER,
+        R::ECTOPLASM,
+        R::MARK_OF_PAIN,
+        R::BUSTED_CROWN,
+        R::EMPTY_CAGE,
+        R::ASTROLABE,
+        R::RUNIC_PYRAMID,
+        R::LIZARD_TAIL,
+        R::ETERNAL_FEATHER,
+        R::COFFEE_DRIPPER,
+        R::BLACK_BLOOD,
+        R::TINY_HOUSE,
+        R::BLACK_STAR,
+        R::ORRERY,
+        R::RUNIC_CUBE,
+        R::PANDORAS_BOX,
+        R::WHITE_BEAST_STATUE,
+        R::CALLING_BELL,
+};
 
-        DamageInfo dInfo;
-        if (bc.player.hasRelic<R::RUNIC_DOME>()) {
-            dInfo = {5*curGameContext->act, 1};
+constexpr std::array<CardId,4> aoeCards = {
+        CardId::CLEAVE,
+        CardId::IMMOLATE,
+        CardId::THUNDERCLAP,
+        CardId::WHIRLWIND,
+};
 
-        } else {
-            dInfo = m.getMoveBaseDamage(bc);
-            dInfo.damage = m.calculateDamageToPlayer(bc, dInfo.damage);
-        }
+struct CardMaxCopies {
+    CardId id;
+    int copies;
+};
 
-        incomingDamage += dInfo.damage * dInfo.attackCount;
+constexpr std::array<CardMaxCopies,26> maxCopiesList = {{
+        {CardId::OFFERING, 1},
+        {CardId::IMPERVIOUS, 99},
+        {CardId::APOTHEOSIS, 1},
+        {CardId::GHOSTLY_ARMOR, 99},
+        {CardId::PERFECTED_STRIKE, 99},
+        {CardId::WHIRLWIND, 2},
+        {CardId::BATTLE_TRANCE, 2},
+        {CardId::DEMON_FORM, 1},
+        {CardId::IMMOLATE, 1},
+        {CardId::RAGE, 2},
+        {CardId::LIMIT_BREAK, 3},
+        {CardId::FLAME_BARRIER, 2},
+        {CardId::MASTER_OF_STRATEGY, 99},
+        {CardId::INFLAME, 1},
+        {CardId::DISARM, 2},
+        {CardId::SHRUG_IT_OFF, 3},
+        {CardId::DOUBLE_TAP, 1},
+        {CardId::THUNDERCLAP, 1},
+        {CardId::METALLICIZE, 1},
+        {CardId::POMMEL_STRIKE, 1},
+        {CardId::SHOCKWAVE, 1},
+        {CardId::UPPERCUT, 1},
+        {CardId::JAX, 1},
+        {CardId::PANIC_BUTTON, 1},
+        {CardId::FLASH_OF_STEEL, 99},
+        {CardId::FLEX, 1},
+}};
+
+// the lookup tables below are indexed by id and built at compile time, so there is nothing to initialize when
+// several agents start on different threads
+static constexpr std::size_t cardIdCount = std::size(cardNames);
+static constexpr std::size_t relicIdCount = std::size(relicEnumNames);
+
+// priority is the 1 based position in the list, 0 for ids not in it
+template <std::size_t IdCount, typename Id, std::size_t N>
+static constexpr std::array<int,IdCount> makePriorityMap(const std::array<Id,N> &priorities) {
+    std::array<int,IdCount> ret {};
+    for (std::size_t i = 0; i < N; ++i) {
+        ret[static_cast<int>(priorities[i])] = static_cast<int>(i) + 1;
+    }
+    return ret;
+}
+
+template <std::size_t N>
+static constexpr std::array<bool,cardIdCount> makeCardSet(const std::array<CardId,N> &cards) {
+    std::array<bool,cardIdCount> ret {};
+    for (auto c : cards) {
+        ret[static_cast<int>(c)] = true;
+    }
+    return ret;
+}
+
+static constexpr std::array<int,cardIdCount> makeMaxCopiesMap() {
+    std::array<int,cardIdCount> ret {};
+    for (auto &copies : ret) {
+        copies = std::numeric_limits<int>::max();
+    }
+    for (auto entry : maxCopiesList) {
+        ret[static_cast<int>(entry.id)] = entry.copies;
+    }
+    return ret;
+}
+
+static constexpr auto cardPriorityMap = makePriorityMap<cardIdCount>(cardsPriorities);
+static constexpr auto cardPlayMap = makePriorityMap<cardIdCount>(cardPlayPriorities);
+static constexpr auto bossRelicPriorityMap = makePriorityMap<relicIdCount>(bossRelicPriorities);
+static constexpr auto isAoeCard = makeCardSet(aoeCards);
+static constexpr auto isDefensiveCard = makeCardSet(defensiveCards);
+static constexpr auto maxCopies = makeMaxCopiesMap();
+
+bool shouldSkip(CardId id) {
+    return cardPriorityMap[static_cast<int>(id)] > cardPriorityMap[static_cast<int>(CardId::ANGER)];
+}
+
+int getHighHpMonster(const BattleContext &bc) {
+    int highHp = -1;
+    int highIdx = -1;
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        if (bc.monsters.arr[i].isTargetable() && bc.monsters.arr[i].curHp > highHp) {
+            highHp = bc.monsters.arr[i].curHp;
+            highIdx = i;
+        }
+    }
+    return highIdx;
+}
+
+int getLowHpMonster(const BattleContext &bc) {
+    int lowHp = 10000;
+    int lowIdx = -1;
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        if (bc.monsters.arr[i].isTargetable() && bc.monsters.arr[i].curHp < lowHp) {
+            lowHp = bc.monsters.arr[i].curHp;
+            lowIdx = i;
+        }
+    }
+    return lowIdx;
+}
+
+int getBestCardToPlay(const BattleContext &bc, fixed_list<int,10> handIdxs) {
+    int bestPriority = 10000;
+    int bestHandIdx;
+    for (int i = 0; i < handIdxs.size(); ++i) {
+        const auto c = bc.cards.hand[handIdxs[i]];
+        const int priority = 2 * cardPlayMap[static_cast<int>(c.getId())] + (c.isUpgraded() ? -1 : 0);
+        if (priority < bestPriority) {
+            bestPriority = priority;
+            bestHandIdx = handIdxs[i];
+        }
+    }
+    return bestHandIdx;
+}
+
+typedef struct {
+    BattleContext bc;
+    CardInstance card;
+
+} State;
+
+void search::myGetBestCardToPlay() {
+    GameContext gc = GameContext(CharacterClass::IRONCLAD, 0, 0);
+
+    BattleContext bc;
+    bc.init(gc, MonsterEncounter::JAW_WORM);
+
+    int seed_sample_count = 10;
+
+    // enumerate actions
+    std::deque<State> states;
+    for (int i = 0; i < std::size(bc.cards.hand); ++i) {
+        if (bc.cards.hand[i].id == CardId::INVALID) break;
+        auto new_bc = bc;
+        // auto action = search::Action(sts::search::ActionType::CARD, i);
+
+        State state = {new_bc, bc.cards.hand[i]};
+        states.push_front(state);
+    }
+    // sort actions by heuristic
+
+    for (int i = 0; i < seed_sample_count; ++i) {
+
+        // start dfs with first action
+        while (!states.empty()) {
+            auto state = states.front();
+            states.pop_front();
+
+            std::cout << "state: " << (state.card.getName()) << "\n";
+            std::cout << "hand: ";
+            bool first = true;
+            for (const auto& element : state.bc.cards.hand) {
+                if (!first) std::cout << ", ";
+                std::cout << element;
+                first = false;
+            }
+            std::cout << "\n";
+            // execute action
+            if (!state.card.requiresTarget()) {
+                auto *bestCard = std::find(std::begin(state.bc.cards.hand), std::end(state.bc.cards.hand), &state.card);
+                auto bestCardIdx = std::distance(std::begin(state.bc.cards.hand), bestCard);
+
+                auto action = search::Action(sts::search::ActionType::CARD, bestCardIdx);
+                action.execute(state.bc);
+            }
+
+            // push new states
+            for (int i = 0; i < std::size(state.bc.cards.hand); ++i) {
+                if (state.bc.cards.hand[i].id == CardId::INVALID) break;
+                auto new_bc = state.bc;
+                // auto action = search::Action(sts::search::ActionType::CARD, i);
+
+                State state = {new_bc, state.bc.cards.hand[i]};
+                states.push_front(state);
+            }
+
+            // eval action
+        }
+    }
+
+    // __dfs__ (with pruning)
+}
+
+void sortCardOptions(const GameContext &gc, fixed_list<int,96> &sortedCardIdxs) {
+    sortedCardIdxs.clear();
+    for (int i = 0; i < gc.info.toSelectCards.size(); ++i) {
+        sortedCardIdxs.push_back(i);
+    }
+
+    if (gc.info.selectScreenType == sts::CardSelectScreenType::UPGRADE ||
+        gc.info.selectScreenType == sts::CardSelectScreenType::DUPLICATE)
+    {
+        std::sort(sortedCardIdxs.begin(), sortedCardIdxs.end(), [&](int a, int b) {
+            auto ca = gc.info.toSelectCards[a].card;
+            auto cb = gc.info.toSelectCards[b].card;
+            auto pa = 2 * cardPriorityMap[static_cast<int>(ca.id)] + (ca.isUpgraded() ? -1 : 0);
+            auto pb = 2 * cardPriorityMap[static_cast<int>(cb.id)] + (cb.isUpgraded() ? -1 : 0);
+            return pa < pb;
+        });
+
+    } else {
+        std::sort(sortedCardIdxs.begin(), sortedCardIdxs.end(), [&](int a, int b) {
+            auto ca = gc.info.toSelectCards[a].card;
+            auto cb = gc.info.toSelectCards[b].card;
+            auto pa = 2 * cardPriorityMap[static_cast<int>(ca.id)] + (ca.isUpgraded() ? -1 : 0);
+            auto pb = 2 * cardPriorityMap[static_cast<int>(cb.id)] + (cb.isUpgraded() ? -1 : 0);
+            if (gc.info.selectScreenType == sts::CardSelectScreenType::TRANSFORM ||
+                gc.info.selectScreenType == sts::CardSelectScreenType::TRANSFORM_UPGRADE) {
+                if (ca.getType() == sts::CardType::CURSE) {
+                    pa -= 1000;
+                }
+                if (cb.getType() == sts::CardType::CURSE) {
+                    pb -= 1000;
+                }
+            }
+            return  pa > pb;
+        });
+    }
+}
+
+//void sortCardOptions(const GameContext &gc, fixed_list<int,96> &sortedCardIdxs) {
+//    sortedCardIdxs.clear();
+//    for (int i = 0; i < gc.info.toSelectCards.size(); ++i) {
+//        sortedCardIdxs.push_back(i);
+//    }
+//
+//    if (gc.info.selectScreenType == sts::CardSelectScreenType::UPGRADE ||
+//        gc.info.selectScreenType == sts::CardSelectScreenType::DUPLICATE)
+//    {
+//        std::sort(sortedCardIdxs.begin(), sortedCardIdxs.end(), [&](int a, int b) {
+//            auto ca = gc.info.toSelectCards[a].card;
+//            auto cb = gc.info.toSelectCards[b].card;
+//            return cardPriorityMap[static_cast<int>(ca.id)] < cardPriorityMap[static_cast<int>(cb.id)];
+//        });
+//
+//    } else {
+//        std::sort(sortedCardIdxs.begin(), sortedCardIdxs.end(), [&](int a, int b) {
+//            auto ca = gc.info.toSelectCards[a].card;
+//            auto cb = gc.info.toSelectCards[b].card;
+//            auto pa = cardPriorityMap[static_cast<int>(ca.id)];
+//            auto pb = cardPriorityMap[static_cast<int>(cb.id)];
+//            if (gc.info.selectScreenType == sts::CardSelectScreenType::TRANSFORM ||
+//                gc.info.selectScreenType == sts::CardSelectScreenType::TRANSFORM_UPGRADE) {
+//                if (ca.getType() == sts::CardType::CURSE) {
+//                    pa -= 1000;
+//                }
+//                if (cb.getType() == sts::CardType::CURSE) {
+//                    pb -= 1000;
+//                }
+//            }
+//            return  pa > pb;
+//        });
+//    }
+//}
+
+int search::SimpleAgent::getAct(const BattleContext &bc) const {
+    if (curGameContext != nullptr) {
+        return curGameContext->act;
+    }
+    // without a game, e.g. in search playouts, go by the floors of the act bosses
+    return bc.floorNum <= 17 ? 1 : bc.floorNum <= 34 ? 2 : bc.floorNum <= 51 ? 3 : 4;
+}
+
+int search::SimpleAgent::getIncomingDamage(const BattleContext &bc) const {
+    int incomingDamage = 0;
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        const auto &m = bc.monsters.arr[i];
+        if (m.isDeadOrEscaped() || m.isHalfDead()) {
+            continue;
+        }
+
+        DamageInfo dInfo;
+        if (bc.player.hasRelic<R::RUNIC_DOME>()) {
+            dInfo = {5*getAct(bc), 1};
+
+        } else {
+            dInfo = m.getMoveBaseDamage(bc);
+            dInfo.damage = m.calculateDamageToPlayer(bc, dInfo.damage);
+        }
+
+        incomingDamage += dInfo.damage * dInfo.attackCount;
     }
     return incomingDamage;
 }
@@ -322,10 +718,6 @@ static void printHelper(const BattleContext &bc, const search::Action &a) {
             << std::endl;
 }
 
-search::SimpleAgent::SimpleAgent() {
-    initMaps();
-}
-
 void search::SimpleAgent::takeAction(GameContext &gc, search::GameAction a) {
     actionHistory.emplace_back(a.bits);
     if (print) {
@@ -358,7 +750,7 @@ void search::SimpleAgent::playout(GameContext &gc) {
             continue;
         }
 
-        // stepOutOfCombat(gc);
+        stepOutOfCombat(gc);
     }
 }
 
@@ -409,9 +801,12 @@ void search::SimpleAgent::playoutBattle(BattleContext &bc) {
 }
 
 void search::SimpleAgent::stepBattleCardPlay(BattleContext &bc) {
+    takeAction(bc, getBattleCardPlayAction(bc));
+}
+
+search::Action search::SimpleAgent::getBattleCardPlayAction(const BattleContext &bc) const {
     if (!bc.isCardPlayAllowed() || bc.player.cardsPlayedThisTurn > 1000) {
-        takeAction(bc, Action(ActionType::END_TURN));
-        return;
+        return Action(ActionType::END_TURN);
     }
 
     fixed_list<int,10> playableCardsIdxs;
@@ -423,8 +818,7 @@ void search::SimpleAgent::stepBattleCardPlay(BattleContext &bc) {
     }
 
     if (playableCardsIdxs.empty()) {
-        takeAction(bc, Action(ActionType::END_TURN));
-        return;
+        return Action(ActionType::END_TURN);
     }
 
     fixed_list<int,10> zeroCost;
@@ -435,7 +829,7 @@ void search::SimpleAgent::stepBattleCardPlay(BattleContext &bc) {
 
     for (auto handIdx : playableCardsIdxs) {
         const auto &c = bc.cards.hand[handIdx];
-        if (isAoeCard.test(static_cast<int>(c.getId()))) {
+        if (isAoeCard[static_cast<int>(c.getId())]) {
             aoeCards.push_back(handIdx);
         }
         if (c.cost == 0 || c.costForTurn == 0) {
@@ -451,11 +845,11 @@ void search::SimpleAgent::stepBattleCardPlay(BattleContext &bc) {
     }
 
     const int incomingDamage = getIncomingDamage(bc);
-    if (bc.player.block > (incomingDamage - curGameContext->act - 4)) {
+    if (bc.player.block > (incomingDamage - getAct(bc) - 4)) {
         fixed_list<int,10> offensiveCards;
         for (auto handIdx : nonZeroCostCards) {
             const auto &c = bc.cards.hand[handIdx];
-            const bool isDefensive = isDefensiveCard.test(static_cast<int>(c.getId()));
+            const bool isDefensive = isDefensiveCard[static_cast<int>(c.getId())];
             if (!isDefensive) {
                 offensiveCards.push_back(handIdx);
             }
@@ -487,14 +881,12 @@ void search::SimpleAgent::stepBattleCardPlay(BattleContext &bc) {
         bestCardIdx = getBestCardToPlay(bc, zeroCostAttacks);
 
     } else {
-        takeAction(bc, Action(ActionType::END_TURN));
-        return;
+        return Action(ActionType::END_TURN);
     }
 
     const auto &c = bc.cards.hand[bestCardIdx];
     if (!c.requiresTarget()) {
-        takeAction(bc, Action(ActionType::CARD, bestCardIdx));
-        return;
+        return Action(ActionType::CARD, bestCardIdx);
     }
 
     int targetIdx;
@@ -503,7 +895,7 @@ void search::SimpleAgent::stepBattleCardPlay(BattleContext &bc) {
     } else {
         targetIdx = getHighHpMonster(bc);
     }
-    takeAction(bc, Action(ActionType::CARD, bestCardIdx, targetIdx));
+    return Action(ActionType::CARD, bestCardIdx, targetIdx);
 }
 
 template <typename ForwardIt>
@@ -682,563 +1074,192 @@ void search::SimpleAgent::stepOutOfCombat(GameContext &gc) {
 
         case ScreenState::TREASURE_ROOM:
             takeAction(gc, 0);
-            break;
-
-        case ScreenState::REST_ROOM:
-            stepRestScreen(gc);
-            break;
-
-        case ScreenState::SHOP_ROOM:
-            stepShopScreen(gc);
-            break;
-
-        case ScreenState::BATTLE:
-        case ScreenState::INVALID:
-        default:
-#ifdef sts_asserts
-            assert(false);
-#endif
-            break;
-    }
-}
-
-void search::SimpleAgent::stepEventScreen(GameContext &gc) {
-    switch (gc.curEvent) {
-        case Event::THE_SSSSSERPENT:
-        case Event::GHOSTS:
-        case Event::GOLDEN_IDOL:
-        case Event::MASKED_BANDITS:
-        case Event::THE_LIBRARY:
-            takeAction(gc, 1);
-            break;
-
-        case Event::AUGMENTER:
-        case Event::VAMPIRES:
-            takeAction(gc, 2);
-            break;
-
-        case Event::KNOWING_SKULL:
-            takeAction(gc, 3);
-            break;
-
-        case Event::NEOW:
-            takeAction(gc, 0);
-            break;
-
-        default: {
-            auto actions = GameAction::getAllActionsInState(gc);
-            takeAction(gc, actions[0]);
-        }
-    }
-}
-
-void search::SimpleAgent::stepRestScreen(GameContext &gc) {
-    auto vec = GameAction::getAllActionsInState(gc);
-    const bool canRest = !gc.hasRelic(RelicId::COFFEE_DRIPPER);
-    const bool canSmith = !gc.relics.has(RelicId::FUSION_HAMMER) && gc.deck.getUpgradeableCount() > 0;
-    const bool canLift = gc.relics.has(RelicId::GIRYA) && gc.relics.getRelicValue(RelicId::GIRYA) != 3;
-    const bool canDig = gc.relics.has(RelicId::SHOVEL);
-    const bool canRemove = gc.relics.has(RelicId::PEACE_PIPE);
-    const bool canTakeKey = !gc.hasKey(Key::RUBY_KEY);
-
-    if (canRest &&
-        (gc.curHp < gc.maxHp / 2 || (gc.act != 1 && gc.floorNum % 17 == 15 && gc.curHp < gc.maxHp * 0.9))) {
-        takeAction(gc, 0);
-    } else if (canSmith) {
-        takeAction(gc, 1);
-    } else if (canLift) {
-        takeAction(gc, 3);
-    } else if (canDig) {
-        takeAction(gc, 5);
-    } else if (canRemove){
-        takeAction(gc, 4);
-    } else if (canRest) {
-        takeAction(gc, 0);
-    } else if (canTakeKey) {
-        takeAction(gc, 2);
-    } else {
-        takeAction(gc, 6);
-    }
-}
-
-void search::SimpleAgent::stepRewardsScreen(GameContext &gc) {
-    auto &r = gc.info.rewardsContainer;
-
-    if (r.potionCount > 0 && gc.potionCount < gc.potionCapacity) {
-        takeAction(gc, {GameAction::RewardsActionType::POTION, 0});
-    } else if (r.relicCount > 0) {
-        takeAction(gc, {GameAction::RewardsActionType::RELIC, 0});
-    } else if (r.sapphireKey || r.emeraldKey) {
-        takeAction(gc, {GameAction::RewardsActionType::KEY});
-    } if (r.cardRewardCount > 0) {
-        stepCardReward(gc);
-    } else {
-        takeAction(gc, {GameAction::RewardsActionType::SKIP});
-    }
-}
-
-void search::SimpleAgent::stepCardReward(GameContext &gc) {
-    // assume card reward count > 0 here
-    const int lastRewardIdx = gc.info.rewardsContainer.cardRewardCount-1;
-    auto lastCardReward = gc.info.rewardsContainer.cardRewards[lastRewardIdx];
-
-    std::unordered_map<CardId, int> deckCounts;
-    for (auto c : lastCardReward) {
-        if (deckCounts.find(c.id) == deckCounts.end()) {
-            deckCounts.insert({c.id, 1});
-        } else {
-            deckCounts[c.id] += 1;
-        }
-    }
-
-    std::vector<Card> pickableCards;
-    for (auto c : lastCardReward) {
-        if (maxCopies->find(c.id) == maxCopies->end() || deckCounts.at(c.id) < maxCopies->at(c.id)) {
-            pickableCards.emplace_back(c);
-        }
-    }
-
-    if (pickableCards.empty()) {
-        takeAction(gc, GameAction(GameAction::RewardsActionType::CARD, lastRewardIdx, 5) );
-        return;
-    }
-
-    int bestIdx = 10000;
-    Card bestCard;
-    for (auto c : pickableCards) {
-        int pickIdx = 2*cardPriorityMap[static_cast<int>(c.id)] + (c.isUpgraded() ? -1 : 0);
-        if (pickIdx < bestIdx) {
-            bestCard = c;
-            bestIdx = pickIdx;
-        }
-    }
-
-    for (int i = 0; i < lastCardReward.size(); ++i) {
-        if (bestCard == lastCardReward[i]) {
-            takeAction(gc, GameAction(GameAction::RewardsActionType::CARD, lastRewardIdx, i));
-            break;
-        }
-    }
-}
-
-void search::SimpleAgent::stepShopScreen(GameContext &gc) {
-    auto &s = gc.info.shop;
-
-    if (s.removeCost != -1 && gc.gold >= s.removeCost) {
-        takeAction(gc, {GameAction::RewardsActionType::CARD_REMOVE});
-        return;
-    }
-
-    for (int i = 0; i < 7; ++i) {
-        if (s.cardPrice(i) == -1 ||
-            gc.gold < s.cardPrice(i) ||
-            shouldSkip(s.cards[i].getId()))
-        {
-            continue;
-        }
-        takeAction(gc, GameAction(GameAction::RewardsActionType::CARD, i));
-        return;
-    }
-
-    for (int i = 0; i < 3; ++i) {
-        if (s.relicPrice(i) == -1 ||
-            gc.gold < s.relicPrice(i))
-        {
-            continue;
-        }
-        takeAction(gc, GameAction(GameAction::RewardsActionType::RELIC, i));
-        return;
-    }
-
-    takeAction(gc, GameAction(GameAction::RewardsActionType::SKIP));
-}
-
-constexpr std::array<CardId,133> cardsPriorities = {
-        CardId::APOTHEOSIS,
-        CardId::GHOSTLY_ARMOR,
-        CardId::PERFECTED_STRIKE,
-        CardId::WHIRLWIND,
-        CardId::BATTLE_TRANCE,
-        CardId::DEMON_FORM,
-        CardId::RAGE,
-        CardId::OFFERING,
-        CardId::IMPERVIOUS,
-        CardId::IMMOLATE,
-        CardId::LIMIT_BREAK,
-        CardId::FLAME_BARRIER,
-        CardId::MASTER_OF_STRATEGY,
-        CardId::INFLAME,
-        CardId::DISARM,
-        CardId::SHRUG_IT_OFF,
-        CardId::DOUBLE_TAP,
-        CardId::THUNDERCLAP,
-        CardId::METALLICIZE,
-        CardId::POMMEL_STRIKE,
-        CardId::SHOCKWAVE,
-        CardId::UPPERCUT,
-        CardId::JAX,
-        CardId::PANIC_BUTTON,
-        CardId::FLASH_OF_STEEL,
-        CardId::FLEX,
-        CardId::ANGER,
-        CardId::SECRET_WEAPON,
-        CardId::FINESSE,
-        CardId::MAYHEM,
-        CardId::PANACHE,
-        CardId::SECRET_TECHNIQUE,
-        CardId::METAMORPHOSIS,
-        CardId::THINKING_AHEAD,
-        CardId::MADNESS,
-        CardId::DISCOVERY,
-        CardId::CHRYSALIS,
-        CardId::DEEP_BREATH,
-        CardId::TRIP,
-        CardId::ENLIGHTENMENT,
-        CardId::HEAVY_BLADE,
-        CardId::FEED,
-        CardId::FIEND_FIRE,
-        CardId::TWIN_STRIKE,
-        CardId::HEADBUTT,
-        CardId::SEEING_RED,
-        CardId::COMBUST,
-        CardId::CLASH,
-        CardId::DARK_SHACKLES,
-        CardId::SWORD_BOOMERANG,
-        CardId::DRAMATIC_ENTRANCE,
-        CardId::BLUDGEON,
-        CardId::HAND_OF_GREED,
-        CardId::EVOLVE,
-        CardId::VIOLENCE,
-        CardId::BITE,
-        CardId::CARNAGE,
-        CardId::CLOTHESLINE,
-        CardId::BASH,
-        CardId::BANDAGE_UP,
-        CardId::PANACEA,
-        CardId::RECKLESS_CHARGE,
-        CardId::INFERNAL_BLADE,
-        CardId::SPOT_WEAKNESS,
-        CardId::STRIKE_RED,
-        CardId::SHIV,
-        CardId::HAVOC,
-        CardId::RITUAL_DAGGER,
-        CardId::DROPKICK,
-        CardId::FEEL_NO_PAIN,
-        CardId::SWIFT_STRIKE,
-        CardId::CORRUPTION,
-        CardId::MAGNETISM,
-        CardId::BLOODLETTING,
-        CardId::IRON_WAVE,
-        CardId::ARMAMENTS,
-        CardId::MIND_BLAST,
-        CardId::ASCENDERS_BANE,
-        CardId::DAZED,
-        CardId::VOID,
-        CardId::RAMPAGE,
-        CardId::GHOSTLY_ARMOR,
-        CardId::TRUE_GRIT,
-        CardId::BLIND,
-        CardId::GOOD_INSTINCTS,
-        CardId::PUMMEL,
-        CardId::HEMOKINESIS,
-        CardId::EXHUME,
-        CardId::REAPER,
-        CardId::CLEAVE,
-        CardId::WARCRY,
-        CardId::PURITY,
-        CardId::DUAL_WIELD,
-        CardId::WILD_STRIKE,
-        CardId::DEFEND_RED,
-        CardId::BODY_SLAM,
-        CardId::SEVER_SOUL,
-        CardId::BURNING_PACT,
-        CardId::BRUTALITY,
-        CardId::BARRICADE,
-        CardId::INTIMIDATE,
-        CardId::JUGGERNAUT,
-        CardId::SADISTIC_NATURE,
-        CardId::DARK_EMBRACE,
-        CardId::POWER_THROUGH,
-        CardId::TRANSMUTATION,
-        CardId::SENTINEL,
-        CardId::RUPTURE,
-        CardId::SLIMED,
-        CardId::FIRE_BREATHING,
-        CardId::SECOND_WIND,
-        CardId::IMPATIENCE,
-        CardId::THE_BOMB,
-        CardId::JACK_OF_ALL_TRADES,
-        CardId::SEARING_BLOW,
-        CardId::BLOOD_FOR_BLOOD,
-        CardId::BERSERK,
-        CardId::ENTRENCH,
-        CardId::FORETHOUGHT,
-        CardId::CLUMSY,
-        CardId::PARASITE,
-        CardId::SHAME,
-        CardId::INJURY,
-        CardId::WOUND,
-        CardId::WRITHE,
-        CardId::DOUBT,
-        CardId::BURN,
-        CardId::DECAY,
-        CardId::REGRET,
-        CardId::NECRONOMICURSE,
-        CardId::PAIN,
-        CardId::NORMALITY,
-        CardId::PRIDE,
-};
-
-constexpr std::array<CardId,133> cardPlayPriorities = {
-        CardId::APOTHEOSIS,
-        CardId::OFFERING,
-        CardId::DEMON_FORM,
-        CardId::INFLAME,
-        CardId::METALLICIZE,
-        CardId::DISARM,
-        CardId::SHOCKWAVE,
-        CardId::GHOSTLY_ARMOR,
-        CardId::LIMIT_BREAK,
-        CardId::DOUBLE_TAP,
-        CardId::THUNDERCLAP,
-        CardId::IMMOLATE,
-        CardId::UPPERCUT,
-        CardId::FLAME_BARRIER,
-        CardId::SHRUG_IT_OFF,
-        CardId::IMPERVIOUS,
-        CardId::MADNESS,
-        CardId::PERFECTED_STRIKE,
-        CardId::BATTLE_TRANCE,
-        CardId::RAGE,
-        CardId::MASTER_OF_STRATEGY,
-        CardId::POMMEL_STRIKE,
-        CardId::JAX,
-        CardId::FLASH_OF_STEEL,
-        CardId::FLEX,
-        CardId::ANGER,
-        CardId::DEFEND_RED,
-        CardId::BASH,
-        CardId::WHIRLWIND,
-        CardId::PANIC_BUTTON,
-        CardId::SECRET_WEAPON,
-        CardId::FINESSE,
-        CardId::MAYHEM,
-        CardId::PANACHE,
-        CardId::SECRET_TECHNIQUE,
-        CardId::METAMORPHOSIS,
-        CardId::THINKING_AHEAD,
-        CardId::DISCOVERY,
-        CardId::CHRYSALIS,
-        CardId::DEEP_BREATH,
-        CardId::TRIP,
-        CardId::ENLIGHTENMENT,
-        CardId::HEAVY_BLADE,
-        CardId::FEED,
-        CardId::FIEND_FIRE,
-        CardId::TWIN_STRIKE,
-        CardId::HEADBUTT,
-        CardId::SEEING_RED,
-        CardId::COMBUST,
-        CardId::CLASH,
-        CardId::DARK_SHACKLES,
-        CardId::SWORD_BOOMERANG,
-        CardId::DRAMATIC_ENTRANCE,
-        CardId::BLUDGEON,
-        CardId::HAND_OF_GREED,
-        CardId::EVOLVE,
-        CardId::VIOLENCE,
-        CardId::BITE,
-        CardId::CARNAGE,
-        CardId::CLOTHESLINE,
-        CardId::BANDAGE_UP,
-        CardId::PANACEA,
-        CardId::RECKLESS_CHARGE,
-        CardId::INFERNAL_BLADE,
-        CardId::STRIKE_RED,
-        CardId::SPOT_WEAKNESS,
-        CardId::SHIV,
-        CardId::HAVOC,
-        CardId::RITUAL_DAGGER,
-        CardId::DROPKICK,
-        CardId::FEEL_NO_PAIN,
-        CardId::SWIFT_STRIKE,
-        CardId::CORRUPTION,
-        CardId::MAGNETISM,
-        CardId::BLOODLETTING,
-        CardId::IRON_WAVE,
-        CardId::ARMAMENTS,
-        CardId::MIND_BLAST,
-        CardId::ASCENDERS_BANE,
-        CardId::DAZED,
-        CardId::VOID,
-        CardId::RAMPAGE,
-        CardId::GHOSTLY_ARMOR,
-        CardId::TRUE_GRIT,
-        CardId::BLIND,
-        CardId::GOOD_INSTINCTS,
-        CardId::PUMMEL,
-        CardId::HEMOKINESIS,
-        CardId::EXHUME,
-        CardId::REAPER,
-        CardId::CLEAVE,
-        CardId::WARCRY,
-        CardId::PURITY,
-        CardId::DUAL_WIELD,
-        CardId::WILD_STRIKE,
-        CardId::BODY_SLAM,
-        CardId::SEVER_SOUL,
-        CardId::BURNING_PACT,
-        CardId::BRUTALITY,
-        CardId::BARRICADE,
-        CardId::INTIMIDATE,
-        CardId::JUGGERNAUT,
-        CardId::SADISTIC_NATURE,
-        CardId::DARK_EMBRACE,
-        CardId::POWER_THROUGH,
-        CardId::TRANSMUTATION,
-        CardId::SENTINEL,
-        CardId::RUPTURE,
-        CardId::SLIMED,
-        CardId::FIRE_BREATHING,
-        CardId::SECOND_WIND,
-        CardId::IMPATIENCE,
-        CardId::THE_BOMB,
-        CardId::JACK_OF_ALL_TRADES,
-        CardId::SEARING_BLOW,
-        CardId::BLOOD_FOR_BLOOD,
-        CardId::BERSERK,
-        CardId::ENTRENCH,
-        CardId::FORETHOUGHT,
-        CardId::CLUMSY,
-        CardId::PARASITE,
-        CardId::SHAME,
-        CardId::INJURY,
-        CardId::WOUND,
-        CardId::WRITHE,
-        CardId::DOUBT,
-        CardId::BURN,
-        CardId::DECAY,
-        CardId::REGRET,
-        CardId::NECRONOMICURSE,
-        CardId::PAIN,
-        CardId::NORMALITY,
-        CardId::PRIDE,
-};
+            break;
 
-constexpr std::array<CardId,13>  defensiveCards = {
-        CardId::POWER_THROUGH,
-        CardId::TRUE_GRIT,
-        CardId::IMPERVIOUS,
-        CardId::SHRUG_IT_OFF,
-        CardId::FLAME_BARRIER,
-        CardId::ENTRENCH,
-        CardId::DEFEND_RED,
-        CardId::SENTINEL,
-        CardId::SECOND_WIND,
-        CardId::GHOSTLY_ARMOR,
-        CardId::DARK_SHACKLES,
-        CardId::PANIC_BUTTON,
-        CardId::RAGE,
-};
+        case ScreenState::REST_ROOM:
+            stepRestScreen(gc);
+            break;
 
-constexpr std::array<RelicId,24> bossRelicPriorities = {
-        R::SOZU,
-        R::SNECKO_EYE,
-        R::PHILOSOPHERS_STONE,
-        R::RUNIC_DOME,
-        R::CURSED_KEY,
-        R::FUSION_HAMMER,
-        R::VELVET_CHOKER,
-        R::ECTOPLASM,
-        R::MARK_OF_PAIN,
-        R::BUSTED_CROWN,
-        R::EMPTY_CAGE,
-        R::ASTROLABE,
-        R::RUNIC_PYRAMID,
-        R::LIZARD_TAIL,
-        R::ETERNAL_FEATHER,
-        R::COFFEE_DRIPPER,
-        R::BLACK_BLOOD,
-        R::TINY_HOUSE,
-        R::BLACK_STAR,
-        R::ORRERY,
-        R::RUNIC_CUBE,
-        R::PANDORAS_BOX,
-        R::WHITE_BEAST_STATUE,
-        R::CALLING_BELL,
-};
+        case ScreenState::SHOP_ROOM:
+            stepShopScreen(gc);
+            break;
+
+        case ScreenState::BATTLE:
+        case ScreenState::INVALID:
+        default:
+#ifdef sts_asserts
+            assert(false);
+#endif
+            break;
+    }
+}
+
+void search::SimpleAgent::stepEventScreen(GameContext &gc) {
+    int select = -1;
+    switch (gc.curEvent) {
+        case Event::THE_SSSSSERPENT:
+        case Event::GHOSTS:
+        case Event::GOLDEN_IDOL:
+        case Event::MASKED_BANDITS:
+        case Event::THE_LIBRARY:
+            select = 1;
+            break;
+
+        case Event::AUGMENTER:
+        case Event::VAMPIRES:
+            select = 2;
+            break;
+
+        case Event::KNOWING_SKULL:
+            select = 3;
+            break;
+
+        case Event::NEOW:
+            select = 0;
+            break;
+
+        default:
+            break;
+    }
+
+    // the fixed choices are for the first screen of the event, a search may have taken it somewhere else
+    if (select != -1 && GameAction(select).isValidAction(gc)) {
+        takeAction(gc, select);
+    } else {
+        GameActionList actions;
+        GameAction::getAllActionsInState(gc, actions);
+        takeAction(gc, actions[0]);
+    }
+}
+
+void search::SimpleAgent::stepRestScreen(GameContext &gc) {
+    const bool canRest = !gc.hasRelic(RelicId::COFFEE_DRIPPER);
+    const bool canSmith = !gc.relics.has(RelicId::FUSION_HAMMER) && gc.deck.getUpgradeableCount() > 0;
+    const bool canLift = gc.relics.has(RelicId::GIRYA) && gc.relics.getRelicValue(RelicId::GIRYA) != 3;
+    const bool canDig = gc.relics.has(RelicId::SHOVEL);
+    const bool canRemove = gc.relics.has(RelicId::PEACE_PIPE);
+    const bool canTakeKey = !gc.hasKey(Key::RUBY_KEY);
+
+    if (canRest &&
+        (gc.curHp < gc.maxHp / 2 || (gc.act != 1 && gc.floorNum % 17 == 15 && gc.curHp < gc.maxHp * 0.9))) {
+        takeAction(gc, 0);
+    } else if (canSmith) {
+        takeAction(gc, 1);
+    } else if (canLift) {
+        takeAction(gc, 3);
+    } else if (canDig) {
+        takeAction(gc, 5);
+    } else if (canRemove){
+        takeAction(gc, 4);
+    } else if (canRest) {
+        takeAction(gc, 0);
+    } else if (canTakeKey) {
+        takeAction(gc, 2);
+    } else {
+        takeAction(gc, 6);
+    }
+}
+
+void search::SimpleAgent::stepRewardsScreen(GameContext &gc) {
+    auto &r = gc.info.rewardsContainer;
+
+    if (r.potionCount > 0 && gc.potionCount < gc.potionCapacity) {
+        takeAction(gc, {GameAction::RewardsActionType::POTION, 0});
+    } else if (r.relicCount > 0) {
+        takeAction(gc, {GameAction::RewardsActionType::RELIC, 0});
+    } else if (r.sapphireKey || r.emeraldKey) {
+        takeAction(gc, {GameAction::RewardsActionType::KEY});
+    } if (r.cardRewardCount > 0) {
+        stepCardReward(gc);
+    } else {
+        takeAction(gc, {GameAction::RewardsActionType::SKIP});
+    }
+}
 
+void search::SimpleAgent::stepCardReward(GameContext &gc) {
+    // assume card reward count > 0 here
+    const int lastRewardIdx = gc.info.rewardsContainer.cardRewardCount-1;
+    auto lastCardReward = gc.info.rewardsContainer.cardRewards[lastRewardIdx];
+
+    std::unordered_map<CardId, int> deckCounts;
+    for (auto c : lastCardReward) {
+        if (deckCounts.find(c.id) == deckCounts.end()) {
+            deckCounts.insert({c.id, 1});
+        } else {
+            deckCounts[c.id] += 1;
+        }
+    }
+
+    std::vector<Card> pickableCards;
+    for (auto c : lastCardReward) {
+        if (deckCounts.at(c.id) < maxCopies[static_cast<int>(c.id)]) {
+            pickableCards.emplace_back(c);
+        }
+    }
 
-void initMaps() {
-    // there are synchronization issues with this if multiple threads start at once
-    if (haveInitMaps) {
+    if (pickableCards.empty()) {
+        takeAction(gc, GameAction(GameAction::RewardsActionType::CARD, lastRewardIdx, 5) );
         return;
     }
-    haveInitMaps = true;
-    for (int i = 0; i < cardPlayPriorities.size(); ++i) {
-        CardId c = cardPlayPriorities[i];
-        cardPlayMap[static_cast<int>(c)] = i + 1;
+
+    int bestIdx = 10000;
+    Card bestCard;
+    for (auto c : pickableCards) {
+        int pickIdx = 2*cardPriorityMap[static_cast<int>(c.id)] + (c.isUpgraded() ? -1 : 0);
+        if (pickIdx < bestIdx) {
+            bestCard = c;
+            bestIdx = pickIdx;
+        }
     }
 
-    for (int i = 0; i < cardsPriorities.size(); ++i) {
-        CardId c = cardsPriorities[i];
-        cardPriorityMap[static_cast<int>(c)] = i + 1;
+    for (int i = 0; i < lastCardReward.size(); ++i) {
+        if (bestCard == lastCardReward[i]) {
+            takeAction(gc, GameAction(GameAction::RewardsActionType::CARD, lastRewardIdx, i));
+            break;
+        }
     }
+}
 
-    for (int i = 0; i < bossRelicPriorities.size(); ++i) {
-        RelicId r = bossRelicPriorities[i];
-        bossRelicPriorityMap[static_cast<int>(r)] = i + 1;
+void search::SimpleAgent::stepShopScreen(GameContext &gc) {
+    auto &s = gc.info.shop;
+
+    if (s.removeCost != -1 && gc.gold >= s.removeCost) {
+        takeAction(gc, {GameAction::RewardsActionType::CARD_REMOVE});
+        return;
     }
 
-    maxCopies = new std::map<CardId, int>({
-        {CardId::OFFERING, 1},
-        {CardId::IMPERVIOUS, 99},
-        {CardId::APOTHEOSIS, 1},
-        {CardId::GHOSTLY_ARMOR, 99},
-        {CardId::PERFECTED_STRIKE, 99},
-        {CardId::WHIRLWIND, 2},
-        {CardId::BATTLE_TRANCE, 2},
-        {CardId::DEMON_FORM, 1},
-        {CardId::IMMOLATE, 1},
-        {CardId::RAGE, 2},
-        {CardId::LIMIT_BREAK, 3},
-        {CardId::FLAME_BARRIER, 2},
-        {CardId::MASTER_OF_STRATEGY, 99},
-        {CardId::INFLAME, 1},
-        {CardId::DISARM, 2},
-        {CardId::SHRUG_IT_OFF, 3},
-        {CardId::DOUBLE_TAP, 1},
-        {CardId::THUNDERCLAP, 1},
-        {CardId::METALLICIZE, 1},
-        {CardId::POMMEL_STRIKE, 1},
-        {CardId::SHOCKWAVE, 1},
-        {CardId::UPPERCUT, 1},
-        {CardId::JAX, 1},
-        {CardId::PANIC_BUTTON, 1},
-        {CardId::FLASH_OF_STEEL, 99},
-        {CardId::FLEX, 1}
-    });
+    for (int i = 0; i < 7; ++i) {
+        if (s.cardPrice(i) == -1 ||
+            gc.gold < s.cardPrice(i) ||
+            shouldSkip(s.cards[i].getId()))
+        {
+            continue;
+        }
+        takeAction(gc, GameAction(GameAction::RewardsActionType::CARD, i));
+        return;
+    }
 
-    for (auto c : defensiveCards) {
-        isDefensiveCard.set(static_cast<int>(c));
+    for (int i = 0; i < 3; ++i) {
+        if (s.relicPrice(i) == -1 ||
+            gc.gold < s.relicPrice(i))
+        {
+            continue;
+        }
+        takeAction(gc, GameAction(GameAction::RewardsActionType::RELIC, i));
+        return;
     }
 
-    isAoeCard.set(static_cast<int>(CardId::CLEAVE));
-    isAoeCard.set(static_cast<int>(CardId::IMMOLATE));
-    isAoeCard.set(static_cast<int>(CardId::THUNDERCLAP));
-    isAoeCard.set(static_cast<int>(CardId::WHIRLWIND));
+    takeAction(gc, GameAction(GameAction::RewardsActionType::SKIP));
 }
 
+
+
 struct SimpleAgentInfo {
     bool shouldPrint;
     std::uint64_t seedStart;
     std::uint64_t seedEnd;
 
-    std::mutex m;
     std::uint64_t curSeed;
-    std::int64_t winCount = 0;
-    std::int64_t lossCount = 0;
-    std::int64_t floorSum = 0;
 };
 
 void myAgentMtRunner(SimpleAgentInfo *info) {
@@ -1249,43 +1270,6 @@ void myAgentMtRunner(SimpleAgentInfo *info) {
     agent.playout(gc);
 }
 
-void agentMtRunner(SimpleAgentInfo *info) {
-    std::uint64_t seed;
-    {
-        std::scoped_lock lock(info->m);
-        seed = info->curSeed++;
-    }
-
-    while(true) {
-        if (seed >= info->seedEnd) {
-            break;
-        }
-
-        GameContext gc(CharacterClass::IRONCLAD, seed, 0);
-
-//        gc.obtainRelic(sts::RelicId::NEOWS_LAMENT);
-//        gc.playerIncreaseMaxHp(100);
-
-        search::SimpleAgent agent;
-        agent.print = info->shouldPrint;
-        agent.playout(gc);
-
-
-//        printOutcome(std::cout, gc);
-        {
-            std::scoped_lock lock(info->m);
-            info->floorSum += gc.floorNum;
-            if (gc.outcome == sts::GameOutcome::PLAYER_VICTORY) {
-                ++info->winCount;
-
-            } else {
-                ++info->lossCount;
-            }
-            seed = info->curSeed++;
-        }
-    }
-}
-
 // void search::SimpleAgent::myRunAgentMt(int threadCount, std::uint64_t startSeed, int playoutCount, bool print) {    SimpleAgentInfo info;
 //     info.curSeed = startSeed;
 //     info.seedStart = startSeed;
@@ -1295,35 +1279,27 @@ void agentMtRunner(SimpleAgentInfo *info) {
 //     myAgentMtRunner(&info);
 // };
 
-void search::SimpleAgent::runAgentsMt(int threadCount, std::uint64_t startSeed, int playoutCount, bool print) {
-    auto startTime = std::chrono::high_resolution_clock::now();
-
-    std::vector<std::unique_ptr<std::thread>> threads;
-
-    SimpleAgentInfo info;
-    info.curSeed = startSeed;
-    info.seedStart = startSeed;
-    info.seedEnd = startSeed + playoutCount;
-    info.shouldPrint = print;
+void search::SimpleAgent::runAgentsMt(int threadCount, std::uint64_t startSeed, int playoutCount, bool print, bool pinThreads) {
+    BatchRunner runner(threadCount, pinThreads);
+    const auto &info = runner.run(startSeed, playoutCount, [=](std::uint64_t seed, BatchResult &threadResult) {
+        GameContext gc(CharacterClass::IRONCLAD, seed, 0);
 
+//        gc.obtainRelic(sts::RelicId::NEOWS_LAMENT);
+//        gc.playerIncreaseMaxHp(100);
 
-    if (threadCount == 1) { // doing this for more consistency when benchmarking
-        agentMtRunner(&info);
+        search::SimpleAgent agent;
+        agent.print = print;
+        agent.playout(gc);
 
-    } else {
-        for (int tid = 0; tid < threadCount; ++tid) {
-            threads.emplace_back(new std::thread(agentMtRunner, &info));
-        }
-    }
+//        printOutcome(std::cout, gc);
+        threadResult.floorSum += gc.floorNum;
+        if (gc.outcome == sts::GameOutcome::PLAYER_VICTORY) {
+            ++threadResult.winCount;
 
-    for (int tid = 0; tid < threadCount; ++tid) {
-        if (threadCount > 1) {
-            threads[tid]->join();
+        } else {
+            ++threadResult.lossCount;
         }
-    }
-
-    auto endTime = std::chrono::high_resolution_clock::now();
-    double duration = std::chrono::duration<double>(endTime-startTime).count();
+    });
 
     std::cout << "w/l: (" << info.winCount  << ", " << info.lossCount << ")"
               << " percentWin: " << static_cast<double>(info.winCount) / playoutCount * 100 << "%"
@@ -1331,6 +1307,7 @@ void search::SimpleAgent::runAgentsMt(int threadCount, std::uint64_t startSeed,
 
     std::cout << "threads: " << threadCount
               << " playoutCount: " << playoutCount
-              << " elapsed: " << duration
-              << std::endl;
+              << " elapsed: " << runner.elapsed << ' ';
+    runner.printThroughput(std::cout);
+    std::cout << std::endl;
 }
@@ -0,0 +1,257 @@
+#include "sim/search/TranspositionTable.h"
+
+#include "combat/BattleContext.h"
+
+using namespace sts;
+
+// the zobrist key of (feature, value) is computed with a 64 bit mixer instead of stored in a table,
+// most of the features here have too large a range of values for a table
+static std::uint64_t getKey(std::uint64_t feature, std::uint64_t value) {
+    std::uint64_t x = (feature << 40) ^ value ^ 0x9E3779B97F4A7C15ULL;
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static std::uint64_t getCardValue(const CardInstance &c) {
+    // uniqueId is left out, two copies of a card are interchangeable
+    return static_cast<std::uint64_t>(c.id)
+        | static_cast<std::uint64_t>(c.upgraded) << 16
+        | static_cast<std::uint64_t>(c.freeToPlayOnce) << 17
+        | static_cast<std::uint64_t>(c.retain) << 18
+        | static_cast<std::uint64_t>(static_cast<std::uint8_t>(c.cost)) << 24
+        | static_cast<std::uint64_t>(static_cast<std::uint8_t>(c.costForTurn)) << 32
+        | static_cast<std::uint64_t>(static_cast<std::uint16_t>(c.specialData)) << 40;
+}
+
+struct BattleStateHasher {
+    std::uint64_t hash = 0;
+    std::uint64_t feature = 0;
+
+    template <typename T>
+    void add(T value) {
+        hash ^= getKey(feature++, static_cast<std::uint64_t>(value));
+    }
+
+    // keys are summed instead of xored for multisets, so duplicates don't cancel
+    template <typename ForwardIt>
+    void addMultiset(ForwardIt begin, ForwardIt end) {
+        std::uint64_t sum = 0;
+        const auto f = feature++;
+        for (auto it = begin; it != end; ++it) {
+            sum += getKey(f, getCardValue(*it));
+        }
+        hash ^= getKey(feature++, sum);
+    }
+
+    template <typename ForwardIt>
+    void addSequence(ForwardIt begin, ForwardIt end) {
+        add(end-begin);
+        const auto f = feature++;
+        for (auto it = begin; it != end; ++it) {
+            hash ^= getKey(f, getCardValue(*it) ^ static_cast<std::uint64_t>(it-begin) << 56);
+        }
+    }
+
+    void addRandom(const Random &r) {
+        add(r.counter);
+    }
+
+    void addCardQueueItem(const CardQueueItem &item) {
+        add(getCardValue(item.card));
+        add(item.target);
+        add(item.energyOnUse);
+        add(item.regretCardCount);
+        add(item.isEndTurn
+            | item.triggerOnUse << 1
+            | item.ignoreEnergyTotal << 2
+            | item.freeToPlay << 3
+            | item.randomTarget << 4
+            | item.autoplay << 5
+            | item.purgeOnUse << 6
+            | item.exhaustOnUse << 7);
+    }
+
+    void addAction(const Action &a) {
+        add(a.id);
+        add(a.clearOnCombatVictory | a.flag << 1 | a.flag2 << 2);
+        add(a.enumValue);
+        add(a.idx);
+        add(a.amount);
+
+        // only the union member the action was built with is initialized
+        switch (a.id) {
+            case ActionId::ATTACK_ALL_ENEMY_MATRIX:
+            case ActionId::ATTACK_ALL_MONSTER_RECURSIVE:
+                for (auto x : a.damageMatrix) {
+                    add(x);
+                }
+                break;
+
+            case ActionId::SHUFFLE_TEMP_CARD_INTO_DRAW_PILE:
+            case ActionId::MAKE_TEMP_CARD_IN_HAND:
+            case ActionId::MAKE_TEMP_CARD_IN_DRAW_PILE:
+            case ActionId::MAKE_TEMP_CARD_IN_DISCARD:
+                add(getCardValue(a.card));
+                break;
+
+            case ActionId::TIME_EATER_PLAY_CARD_QUEUE_ITEM:
+                addCardQueueItem(a.item);
+                break;
+
+            default:
+                break;
+        }
+    }
+};
+
+std::uint64_t search::getBattleStateHash(const BattleContext &bc) {
+    BattleStateHasher h;
+
+    h.add(bc.outcome);
+    h.add(bc.inputState);
+    h.add(bc.cardSelectInfo.cardSelectTask);
+    h.add(bc.cardSelectInfo.pickCount);
+    h.add(bc.cardSelectInfo.canPickZero);
+    h.add(bc.cardSelectInfo.canPickAnyNumber);
+    h.add(bc.cardSelectInfo.data0);
+    for (auto id : bc.cardSelectInfo.cards) {
+        h.add(id);
+    }
+    h.add(bc.turn);
+    h.add(bc.energyWasted); // used by the evaluation
+    h.add(bc.cardsDrawn);
+    h.add(bc.potionCount);
+    for (int i = 0; i < bc.potionCapacity; ++i) {
+        h.add(bc.potions[i]);
+    }
+
+    h.addRandom(bc.aiRng);
+    h.addRandom(bc.cardRandomRng);
+    h.addRandom(bc.miscRng);
+    h.addRandom(bc.monsterHpRng);
+    h.addRandom(bc.potionRng);
+    h.addRandom(bc.shuffleRng);
+
+    const auto &p = bc.player;
+    h.add(p.curHp);
+    h.add(p.maxHp);
+    h.add(p.energy);
+    h.add(p.block);
+    h.add(p.artifact);
+    h.add(p.dexterity);
+    h.add(p.focus);
+    h.add(p.strength);
+    h.add(p.stance);
+    h.add(p.statusBits0);
+    h.add(p.statusBits1);
+    for (auto bits = p.statusBits0; bits; bits &= bits-1) {
+        h.add(p.statusValues[__builtin_ctzll(bits)]);
+    }
+    for (auto bits = p.statusBits1; bits; bits &= bits-1) {
+        h.add(p.statusValues[64 + __builtin_ctz(bits)]);
+    }
+    h.add(p.cardsPlayedThisTurn);
+    h.add(p.attacksPlayedThisTurn);
+    h.add(p.skillsPlayedThisTurn);
+    h.add(p.cardsDiscardedThisTurn);
+    h.add(p.penNibCounter);
+    h.add(p.nunchakuCounter);
+    h.add(p.inkBottleCounter);
+    h.add(p.happyFlowerCounter);
+    h.add(p.incenseBurnerCounter);
+    h.add(p.sundialCounter);
+    h.add(p.inserterCounter);
+
+    h.add(bc.monsters.monstersAlive);
+    for (int i = 0; i < bc.monsters.monsterCount; ++i) {
+        const auto &m = bc.monsters.arr[i];
+        h.add(m.id);
+        h.add(m.curHp);
+        h.add(m.maxHp);
+        h.add(m.block);
+        h.add(m.halfDead);
+        h.add(m.isEscapingB);
+        h.add(m.escapeNext);
+        h.add(m.moveHistory[0]);
+        h.add(m.moveHistory[1]);
+        h.add(m.statusBits);
+        h.add(m.artifact);
+        h.add(m.blockReturn);
+        h.add(m.choked);
+        h.add(m.corpseExplosion);
+        h.add(m.lockOn);
+        h.add(m.mark);
+        h.add(m.metallicize);
+        h.add(m.platedArmor);
+        h.add(m.poison);
+        h.add(m.regen);
+        h.add(m.shackled);
+        h.add(m.strength);
+        h.add(m.vulnerable);
+        h.add(m.weak);
+        h.add(m.uniquePower0);
+        h.add(m.uniquePower1);
+        h.add(m.miscInfo);
+    }
+
+    const auto &cards = bc.cards;
+    h.addMultiset(cards.hand.begin(), cards.hand.begin() + cards.cardsInHand);
+    h.addSequence(cards.drawPile.begin(), cards.drawPile.end());
+    h.addSequence(cards.discardPile.begin(), cards.discardPile.end()); // order matters once shuffled
+    h.addMultiset(cards.exhaustPile.begin(), cards.exhaustPile.end());
+
+    // card select and other mid-action states still have work queued
+    const auto &aq = bc.actionQueue;
+    h.add(aq.size);
+    for (int i = 0; i < aq.size; ++i) {
+        h.addAction(aq.arr[(aq.front + i) % aq.getCapacity()]);
+    }
+
+    const auto &cq = bc.cardQueue;
+    h.add(cq.size);
+    for (int i = 0; i < cq.size; ++i) {
+        h.addCardQueueItem(cq.arr[(cq.frontIdx + i) % cq.capacity]);
+    }
+
+    return h.hash;
+}
+
+search::TranspositionTable::TranspositionTable(int sizeLog2)
+    : entries(new Entry[std::size_t(1) << sizeLog2]), mask((std::uint64_t(1) << sizeLog2) - 1) {}
+
+std::uint32_t search::TranspositionTable::findOrInsert(std::uint64_t hash) {
+    const auto key = hash == 0 ? 1 : hash;
+    for (int probe = 0; probe < MAX_PROBES; ++probe) {
+        const auto idx = static_cast<std::uint32_t>((key + probe) & mask);
+        auto &entryKey = entries[idx].key;
+
+        auto cur = entryKey.load(std::memory_order_acquire);
+        if (cur == 0 && entryKey.compare_exchange_strong(cur, key, std::memory_order_acq_rel)) {
+            return idx;
+        }
+        if (cur == key) { // compare_exchange_strong loaded the winner's key if it failed
+            return idx;
+        }
+    }
+    return INVALID_IDX;
+}
+
+void search::TranspositionTable::update(std::uint32_t idx, double evaluation) {
+    auto &e = entries[idx];
+    e.simulationCount.fetch_add(1, std::memory_order_relaxed);
+
+    auto sum = e.evaluationSum.load(std::memory_order_relaxed);
+    while (!e.evaluationSum.compare_exchange_weak(sum, sum + evaluation, std::memory_order_relaxed)) {}
+}
+
+std::int64_t search::TranspositionTable::getSimulationCount(std::uint32_t idx) const {
+    return entries[idx].simulationCount.load(std::memory_order_relaxed);
+}
+
+double search::TranspositionTable::getEvaluationSum(std::uint32_t idx) const {
+    return entries[idx].evaluationSum.load(std::memory_order_relaxed);
+}